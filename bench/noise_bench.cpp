@@ -0,0 +1,605 @@
+// CH_NOISE_BENCH: ns/sample of every noise evaluation path, as JSON.
+//
+// Usage: CH_NOISE_BENCH [--min-time-ms N] [--samples N] [--filter TEXT]
+//                       [--simd scalar|sse42|avx2|avx512] [--output FILE]
+//
+// Every case evaluates the same set of points again and again for at least
+// min-time-ms and reports the mean time per sample. Cases are named
+// noise/overload/period/type/layout/path/access and --filter keeps the ones whose
+// name contains TEXT. Numbers are only meaningful for an optimized build,
+// e.g. configured with -DCMAKE_BUILD_TYPE=Release, which the JSON records
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "noise/baked_texture.hpp"
+#include "noise/fixed_noise.hpp"
+#include "noise/perlin_noise.hpp"
+#include "noise/simd/noise_kernels.hpp"
+#include "noise/simplex_noise.hpp"
+#include "noise/value_noise.hpp"
+#include "noise/worley_noise.hpp"
+#include "utils/cpu_features.hpp"
+#include "utils/thread_pool.hpp"
+
+namespace {
+
+#if defined(__OPTIMIZE__) || (defined(_MSC_VER) && defined(NDEBUG))
+constexpr bool kOptimized = true;
+#else
+constexpr bool kOptimized = false;
+#endif
+
+struct Config {
+  double minTimeMs = 50;
+  std::size_t samples = 1 << 16;
+  std::string filter;
+  std::string output;
+};
+
+enum class Access { Random, Scanline };
+
+const char *accessName(const Access access) {
+  return access == Access::Random ? "random" : "scanline";
+}
+
+template <typename T> const char *typeName();
+template <> const char *typeName<float>() { return "float"; }
+template <> const char *typeName<double>() { return "double"; }
+template <> const char *typeName<noise::Q15_Type>() { return "q15"; }
+
+// Structure of arrays, the layout evalBatch takes
+template <typename T> struct Points {
+  std::vector<T> x, y, z, w;
+};
+
+// Random points are spread over 4 periods of the lattice, so the table
+// lookups are as scattered as they get. Scanline points walk rows of a
+// raster, 256 samples wide, a few samples per lattice cell
+template <typename T>
+Points<T> makePoints(const Access access, const unsigned period,
+                     const std::size_t count) {
+  Points<T> points;
+  points.x.resize(count);
+  points.y.resize(count);
+  points.z.resize(count);
+  points.w.resize(count);
+
+  if (access == Access::Random) {
+    std::mt19937 gen(2016);
+    std::uniform_real_distribution<T> distr(0, static_cast<T>(4 * period));
+    for (std::size_t k = 0; k < count; ++k) {
+      points.x[k] = distr(gen);
+      points.y[k] = distr(gen);
+      points.z[k] = distr(gen);
+    }
+    // Drawn last, so x, y and z do not depend on whether w is used
+    for (std::size_t k = 0; k < count; ++k) {
+      points.w[k] = distr(gen);
+    }
+  } else {
+    constexpr std::size_t kRowWidth = 256;
+    const T step = static_cast<T>(0.05);
+    for (std::size_t k = 0; k < count; ++k) {
+      points.x[k] = static_cast<T>(k % kRowWidth) * step;
+      points.y[k] = static_cast<T>(k / kRowWidth) * step;
+      points.z[k] = static_cast<T>(0.5);
+      points.w[k] = static_cast<T>(0.25);
+    }
+  }
+  return points;
+}
+
+// The points of makePoints as the Q16.16 coordinates of the fixed point
+// noises
+Points<noise::Fixed_Type> makeFixedPoints(const Access access,
+                                          const unsigned period,
+                                          const std::size_t count) {
+  const Points<float> points = makePoints<float>(access, period, count);
+  Points<noise::Fixed_Type> fixed;
+  const auto convert = [](const std::vector<float> &from,
+                          std::vector<noise::Fixed_Type> &to) {
+    to.resize(from.size());
+    for (std::size_t k = 0; k < from.size(); ++k) {
+      to[k] = noise::toFixed(from[k]);
+    }
+  };
+  convert(points.x, fixed.x);
+  convert(points.y, fixed.y);
+  convert(points.z, fixed.z);
+  convert(points.w, fixed.w);
+  return fixed;
+}
+
+// Coordinates a noise takes: its Value_Type, but for the fixed point noises
+template <typename Noise> struct Coordinates {
+  using type = typename Noise::Value_Type;
+};
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          noise::simd::KernelRemap Remap>
+struct Coordinates<noise::FixedValueNoise<Dimension, Period, Engine, Remap>> {
+  using type = noise::Fixed_Type;
+};
+
+template <uint_least16_t Period, typename Engine>
+struct Coordinates<noise::FixedPerlinNoise3D<Period, Engine>> {
+  using type = noise::Fixed_Type;
+};
+
+struct Result {
+  std::string name;
+  std::string noise, overload, type, layout, path, access;
+  unsigned period;
+  std::size_t samples;
+  std::size_t footprint;
+  double nsPerSample;
+  double checksum;
+};
+
+class Bench {
+public:
+  explicit Bench(const Config &config) : config(config) {}
+
+  bool selected(const std::string &name) const {
+    return config.filter.empty() ||
+           name.find(config.filter) != std::string::npos;
+  }
+
+  // Mean ns per sample of run(), which evaluates samples samples. run is
+  // repeated until minTimeMs is spent, after one warm up call
+  template <typename Run> double time(Run &&run) const {
+    using Clock = std::chrono::steady_clock;
+    run();
+
+    std::size_t iterations = 0;
+    const auto start = Clock::now();
+    auto now = start;
+    do {
+      run();
+      ++iterations;
+      now = Clock::now();
+    } while (std::chrono::duration<double, std::milli>(now - start).count() <
+             config.minTimeMs);
+
+    const double ns = std::chrono::duration<double, std::nano>(now - start)
+                          .count();
+    return ns / (static_cast<double>(iterations) * config.samples);
+  }
+
+  const Config &config;
+  std::vector<Result> results;
+};
+
+// Shape of a noise evaluation: which eval overload and which evalBatch
+enum class Overload {
+  Eval1D,
+  Eval2D,
+  Eval2DDeriv,
+  Eval3D,
+  Eval3DDeriv,
+  Eval4D
+};
+
+const char *overloadName(const Overload overload) {
+  switch (overload) {
+  case Overload::Eval1D:
+    return "eval(x)";
+  case Overload::Eval2D:
+    return "eval(Vec2)";
+  case Overload::Eval2DDeriv:
+    return "eval(Vec2,deriv)";
+  case Overload::Eval3D:
+    return "eval(Vec3)";
+  case Overload::Eval3DDeriv:
+    return "eval(Vec3,deriv)";
+  case Overload::Eval4D:
+    return "eval(Vec4)";
+  }
+  return "";
+}
+
+template <Overload O, typename Noise, typename T>
+typename Noise::Value_Type evalScalar(const Noise &noise,
+                                      const Points<T> &points,
+                                      const std::size_t k) {
+  using Vec2_Type = vector::Vec2<T>;
+  using Vec3_Type = vector::Vec3<T>;
+  using Vec4_Type = vector::Vec4<T>;
+  if constexpr (O == Overload::Eval1D) {
+    return noise.eval(points.x[k]);
+  } else if constexpr (O == Overload::Eval2D) {
+    return noise.eval(Vec2_Type(points.x[k], points.y[k]));
+  } else if constexpr (O == Overload::Eval2DDeriv) {
+    Vec2_Type deriv;
+    const T v = noise.eval(Vec2_Type(points.x[k], points.y[k]), deriv);
+    return v + deriv.x + deriv.y;
+  } else if constexpr (O == Overload::Eval3D) {
+    return noise.eval(Vec3_Type(points.x[k], points.y[k], points.z[k]));
+  } else if constexpr (O == Overload::Eval4D) {
+    return noise.eval(
+        Vec4_Type(points.x[k], points.y[k], points.z[k], points.w[k]));
+  } else {
+    Vec3_Type deriv;
+    const T v =
+        noise.eval(Vec3_Type(points.x[k], points.y[k], points.z[k]), deriv);
+    return v + deriv.x + deriv.y + deriv.z;
+  }
+}
+
+template <Overload O, typename Noise, typename T>
+void evalBatch(const Noise &noise, const Points<T> &points,
+               typename Noise::Value_Type *out) {
+  const std::size_t count = points.x.size();
+  if constexpr (O == Overload::Eval1D) {
+    noise.evalBatch(points.x.data(), count, out);
+  } else if constexpr (O == Overload::Eval2D) {
+    noise.evalBatch(points.x.data(), points.y.data(), count, out);
+  } else if constexpr (O == Overload::Eval4D) {
+    noise.evalBatch(points.x.data(), points.y.data(), points.z.data(),
+                    points.w.data(), count, out);
+  } else {
+    noise.evalBatch(points.x.data(), points.y.data(), points.z.data(), count,
+                    out);
+  }
+}
+
+// Memory the evaluations read: the noise object, or the samples of a
+// baked texture
+template <typename Noise> std::size_t footprint(const Noise &) {
+  return sizeof(Noise);
+}
+
+template <typename T, uint_least8_t Dimension>
+std::size_t footprint(const noise::BakedTexture<T, Dimension> &texture) {
+  return texture.bytes();
+}
+
+// All the cases of one noise type and overload: scalar and, when HasBatch,
+// batch paths, over both access patterns. make() returns the noise in a
+// std::unique_ptr, it is only called if a case is selected
+template <typename Noise, unsigned Period, Overload O, bool HasBatch,
+          typename Make>
+void benchNoiseWith(Bench &bench, const char *noiseName, const char *layout,
+                    Make make) {
+  using T = typename Noise::Value_Type;
+  using C = typename Coordinates<Noise>::type;
+
+  std::unique_ptr<const Noise> noise;
+
+  for (const Access access : {Access::Random, Access::Scanline}) {
+    for (const bool batch : {false, true}) {
+      if (batch && !HasBatch) {
+        continue;
+      }
+
+      Result result;
+      result.noise = noiseName;
+      result.overload = overloadName(O);
+      result.period = Period;
+      result.type = typeName<T>();
+      result.layout = layout;
+      result.path = batch ? "batch" : "scalar";
+      result.access = accessName(access);
+      result.name = result.noise + "/" + result.overload + "/" +
+                    std::to_string(Period) + "/" + result.type + "/" +
+                    result.layout + "/" + result.path + "/" + result.access;
+      if (!bench.selected(result.name)) {
+        continue;
+      }
+
+      if (!noise) {
+        noise = make();
+      }
+
+      const std::size_t count = bench.config.samples;
+      Points<C> points;
+      if constexpr (std::is_floating_point_v<C>) {
+        points = makePoints<C>(access, Period, count);
+      } else {
+        points = makeFixedPoints(access, Period, count);
+      }
+      std::vector<T> out(count);
+
+      if constexpr (HasBatch) {
+        if (batch) {
+          result.nsPerSample = bench.time(
+              [&] { evalBatch<O>(*noise, points, out.data()); });
+        }
+      }
+      if (!batch) {
+        result.nsPerSample = bench.time([&] {
+          for (std::size_t k = 0; k < count; ++k) {
+            out[k] = evalScalar<O>(*noise, points, k);
+          }
+        });
+      }
+
+      // Keeps the evaluation observable, and tells apart broken kernels
+      double checksum = 0;
+      for (const T v : out) {
+        checksum += v;
+      }
+
+      result.samples = count;
+      result.footprint = footprint(*noise);
+      result.checksum = checksum;
+      bench.results.push_back(result);
+      std::cerr << result.name << ": " << result.nsPerSample << " ns"
+                << std::endl;
+    }
+  }
+}
+
+template <typename Noise, unsigned Period, Overload O, bool HasBatch>
+void benchNoise(Bench &bench, const char *noiseName,
+                const char *layout = "wide") {
+  // The tables of the large periods do not belong on the stack
+  benchNoiseWith<Noise, Period, O, HasBatch>(
+      bench, noiseName, layout, [] { return std::make_unique<Noise>(); });
+}
+
+template <typename T, unsigned Period> void benchPeriod(Bench &bench) {
+  using ValueNoise1D = noise::ValueNoise1D<Period, std::default_random_engine, T>;
+  using ValueNoise2D =
+      noise::ValueNoiseND<2, Period, std::default_random_engine, T>;
+  using ValueNoise3D =
+      noise::ValueNoiseND<3, Period, std::default_random_engine, T>;
+  using ValueNoise4D =
+      noise::ValueNoiseND<4, Period, std::default_random_engine, T>;
+  using PerlinNoise =
+      noise::PerlinNoise3D<Period, std::default_random_engine, T>;
+
+  benchNoise<ValueNoise1D, Period, Overload::Eval1D, true>(bench,
+                                                           "ValueNoise1D");
+  benchNoise<ValueNoise2D, Period, Overload::Eval2D, true>(bench,
+                                                           "ValueNoise2D");
+  benchNoise<ValueNoise2D, Period, Overload::Eval2DDeriv, false>(
+      bench, "ValueNoise2D");
+  benchNoise<ValueNoise3D, Period, Overload::Eval3D, true>(bench,
+                                                           "ValueNoise3D");
+  benchNoise<ValueNoise3D, Period, Overload::Eval3DDeriv, false>(
+      bench, "ValueNoise3D");
+  benchNoise<ValueNoise4D, Period, Overload::Eval4D, false>(bench,
+                                                            "ValueNoise4D");
+  benchNoise<PerlinNoise, Period, Overload::Eval1D, false>(bench,
+                                                           "PerlinNoise3D");
+  benchNoise<PerlinNoise, Period, Overload::Eval2D, false>(bench,
+                                                           "PerlinNoise3D");
+  benchNoise<PerlinNoise, Period, Overload::Eval2DDeriv, false>(
+      bench, "PerlinNoise3D");
+  benchNoise<PerlinNoise, Period, Overload::Eval3D, true>(bench,
+                                                          "PerlinNoise3D");
+  benchNoise<PerlinNoise, Period, Overload::Eval3DDeriv, false>(
+      bench, "PerlinNoise3D");
+
+  // The compact tables, whose batch entry points fall back to eval
+  using CompactValueNoise3D =
+      noise::ValueNoiseND<3, Period, std::default_random_engine, T,
+                          noise::smoothstepRemap<T>,
+                          noise::TableLayout::Compact>;
+  using CompactPerlinNoise =
+      noise::PerlinNoise3D<Period, std::default_random_engine, T,
+                           noise::TableLayout::Compact>;
+
+  benchNoise<CompactValueNoise3D, Period, Overload::Eval3D, false>(
+      bench, "ValueNoise3D", "compact");
+  benchNoise<CompactPerlinNoise, Period, Overload::Eval3D, false>(
+      bench, "PerlinNoise3D", "compact");
+
+  // The improved gradient set, hashed instead of looked up
+  using ImprovedPerlinNoise =
+      noise::PerlinNoise3D<Period, std::default_random_engine, T,
+                           noise::TableLayout::Wide,
+                           noise::PerlinGradients::Improved>;
+
+  benchNoise<ImprovedPerlinNoise, Period, Overload::Eval3D, true>(
+      bench, "ImprovedPerlinNoise3D");
+
+  // No tables, the corners are hashed with integer arithmetic. The period
+  // only sets the spread of the random points
+  using HashedValueNoise3D =
+      noise::ValueNoiseND<3, Period, std::default_random_engine, T,
+                          noise::smoothstepRemap<T>,
+                          noise::TableLayout::Hashed>;
+  using HashedPerlinNoise =
+      noise::PerlinNoise3D<Period, std::default_random_engine, T,
+                           noise::TableLayout::Hashed,
+                           noise::PerlinGradients::Improved>;
+
+  benchNoise<HashedValueNoise3D, Period, Overload::Eval3D, true>(
+      bench, "ValueNoise3D", "hashed");
+  benchNoise<HashedPerlinNoise, Period, Overload::Eval3D, true>(
+      bench, "ImprovedPerlinNoise3D", "hashed");
+
+  using SimplexNoise =
+      noise::SimplexNoise<Period, std::default_random_engine, T>;
+
+  benchNoise<SimplexNoise, Period, Overload::Eval2D, true>(bench,
+                                                           "SimplexNoise");
+  benchNoise<SimplexNoise, Period, Overload::Eval3D, true>(bench,
+                                                           "SimplexNoise");
+  benchNoise<SimplexNoise, Period, Overload::Eval3DDeriv, false>(
+      bench, "SimplexNoise");
+  benchNoise<SimplexNoise, Period, Overload::Eval4D, true>(bench,
+                                                           "SimplexNoise");
+
+  // Worley noise, Euclidean F1 and the F2 - F1 edge distance, which needs
+  // both nearest points and culls fewer neighbor cells
+  using WorleyNoise2D =
+      noise::WorleyNoise2D<noise::EuclideanMetric,
+                           noise::CellularOutput::F1, Period,
+                           std::default_random_engine, T>;
+  using WorleyEdge2D =
+      noise::WorleyNoise2D<noise::EuclideanMetric,
+                           noise::CellularOutput::Edge, Period,
+                           std::default_random_engine, T>;
+  using WorleyNoise3D =
+      noise::WorleyNoise3D<noise::EuclideanMetric,
+                           noise::CellularOutput::F1, Period,
+                           std::default_random_engine, T>;
+
+  benchNoise<WorleyNoise2D, Period, Overload::Eval2D, true>(bench,
+                                                            "WorleyNoise2D");
+  benchNoise<WorleyEdge2D, Period, Overload::Eval2D, true>(
+      bench, "WorleyNoise2D", "edge");
+  benchNoise<WorleyNoise3D, Period, Overload::Eval3D, true>(bench,
+                                                            "WorleyNoise3D");
+
+  // PerlinNoise3D baked into a 128^3 volume, 8 samples per lattice cell.
+  // The points wrap around it
+  using BakedVolume = noise::BakedTexture<T, 3>;
+  benchNoiseWith<BakedVolume, Period, Overload::Eval3D, true>(
+      bench, "BakedTexture3D", "brick", [] {
+        utils::ThreadPool pool;
+        const auto perlin = std::make_unique<PerlinNoise>();
+        return std::make_unique<BakedVolume>(noise::bakeTexture(
+            pool, *perlin, vector::Vec3<T>(0, 0, 0), static_cast<T>(0.125),
+            128));
+      });
+
+  // The fixed point noises, Q16.16 coordinates and Q15 samples. Their
+  // tables are the ones of the float noises, so they run once, with them
+  if constexpr (std::is_same_v<T, float>) {
+    using FixedValueNoise2D = noise::FixedValueNoise<2, Period>;
+    using FixedValueNoise3D = noise::FixedValueNoise<3, Period>;
+    using FixedPerlinNoise = noise::FixedPerlinNoise3D<Period>;
+
+    benchNoise<FixedValueNoise2D, Period, Overload::Eval2D, true>(
+        bench, "FixedValueNoise2D");
+    benchNoise<FixedValueNoise3D, Period, Overload::Eval3D, true>(
+        bench, "FixedValueNoise3D");
+    benchNoise<FixedPerlinNoise, Period, Overload::Eval3D, true>(
+        bench, "FixedPerlinNoise3D");
+  }
+}
+
+template <typename T, unsigned... Periods>
+void benchType(Bench &bench, std::integer_sequence<unsigned, Periods...>) {
+  (benchPeriod<T, Periods>(bench), ...);
+}
+
+std::string jsonString(const std::string &s) {
+  std::string quoted = "\"";
+  for (const char c : s) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+    }
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+void writeJson(std::ostream &os, const Config &config,
+               const std::vector<Result> &results) {
+  os.precision(6);
+  os << "{\n"
+     << "  \"benchmark\": \"CH_NOISE_BENCH\",\n"
+     << "  \"simd\": " << jsonString(noise::simd::activeKernelName()) << ",\n"
+     << "  \"optimized\": " << (kOptimized ? "true" : "false") << ",\n"
+     << "  \"min_time_ms\": " << config.minTimeMs << ",\n"
+     << "  \"results\": [";
+  for (std::size_t r = 0; r < results.size(); ++r) {
+    const Result &result = results[r];
+    os << (r ? ",\n" : "\n") << "    {"
+       << "\"name\": " << jsonString(result.name)
+       << ", \"noise\": " << jsonString(result.noise)
+       << ", \"overload\": " << jsonString(result.overload)
+       << ", \"period\": " << result.period
+       << ", \"type\": " << jsonString(result.type)
+       << ", \"layout\": " << jsonString(result.layout)
+       << ", \"path\": " << jsonString(result.path)
+       << ", \"access\": " << jsonString(result.access)
+       << ", \"samples\": " << result.samples
+       << ", \"ns_per_sample\": " << result.nsPerSample
+       << ", \"samples_per_sec\": " << 1e9 / result.nsPerSample
+       << ", \"footprint_bytes\": " << result.footprint
+       << ", \"checksum\": " << result.checksum << "}";
+  }
+  os << "\n  ]\n}\n";
+}
+
+// The names of utils::simdLevelName, and sse42 for sse4.2
+bool parseLevel(const char *name, utils::SimdLevel &level) {
+  if (std::strcmp(name, "sse42") == 0) {
+    level = utils::SimdLevel::SSE42;
+    return true;
+  }
+  for (const utils::SimdLevel l :
+       {utils::SimdLevel::Scalar, utils::SimdLevel::SSE42,
+        utils::SimdLevel::AVX2, utils::SimdLevel::AVX512}) {
+    if (std::strcmp(name, utils::simdLevelName(l)) == 0) {
+      level = l;
+      return true;
+    }
+  }
+  return false;
+}
+
+int usage(const char *program) {
+  std::cerr << "Usage: " << program
+            << " [--min-time-ms N] [--samples N] [--filter TEXT]"
+               " [--simd scalar|sse42|avx2|avx512] [--output FILE]"
+            << std::endl;
+  return 2;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Config config;
+
+  for (int a = 1; a < argc; ++a) {
+    const std::string arg = argv[a];
+    if (a + 1 >= argc) {
+      return usage(argv[0]);
+    }
+    const char *value = argv[++a];
+    if (arg == "--min-time-ms") {
+      config.minTimeMs = std::atof(value);
+    } else if (arg == "--samples") {
+      config.samples = std::strtoul(value, nullptr, 10);
+    } else if (arg == "--filter") {
+      config.filter = value;
+    } else if (arg == "--output") {
+      config.output = value;
+    } else if (arg == "--simd") {
+      utils::SimdLevel level;
+      if (!parseLevel(value, level)) {
+        return usage(argv[0]);
+      }
+      noise::simd::setActiveLevel(level);
+    } else {
+      return usage(argv[0]);
+    }
+  }
+  if (config.samples == 0) {
+    return usage(argv[0]);
+  }
+
+  Bench bench(config);
+  using Periods = std::integer_sequence<unsigned, 16, 64, 256, 1024, 4096>;
+  benchType<float>(bench, Periods{});
+  benchType<double>(bench, Periods{});
+
+  if (config.output.empty()) {
+    writeJson(std::cout, config, bench.results);
+  } else {
+    std::ofstream ofs(config.output);
+    writeJson(ofs, config, bench.results);
+    if (!ofs) {
+      std::cerr << "Could not write " << config.output << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
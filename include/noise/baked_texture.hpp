@@ -0,0 +1,152 @@
+#ifndef BAKED_TEXTURE_H
+#define BAKED_TEXTURE_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include "utils/int_fit.hpp"
+#include "utils/thread_pool.hpp"
+#include "vec/vec2.hpp"
+#include "vec/vec3.hpp"
+
+namespace noise {
+
+// Difference between a BakedTexture and the noise it was baked from
+template <typename T> struct BakeError {
+  T max; // Largest absolute difference over the samples
+  T rms; // Root mean square of the differences
+};
+
+// Samples of a noise on a grid of size samples per side (a power of 2),
+// step apart from origin, for the consumers that sample one noise millions
+// of times at a bounded frequency. eval interpolates them, bilinearly in 2D
+// and trilinearly in 3D, in place of the noise: a few loads and lerps
+// instead of the hashes and gradients of every corner, for size^Dimension
+// samples of memory. The grid wraps around, so the texture tiles; without
+// seams when size * step is a period of the noise, e.g. Period lattice
+// cells of the noises with a permutation table. The samples are stored in
+// bricks of kBrick^Dimension (256 bytes of floats), brick after brick, so
+// the corners of a cell share one or two cache lines instead of lying rows
+// (or slices) apart
+template <typename T, uint_least8_t Dimension> class BakedTexture {
+public:
+  static_assert(std::is_floating_point<T>(), "T must be a floating point type");
+  static_assert(Dimension == 2 || Dimension == 3, "Dimension must be 2 or 3");
+
+  using Value_Type = T;
+  using Vec2_Type = typename vector::Vec2<T>;
+  using Vec3_Type = typename vector::Vec3<T>;
+  using Vec_Type = std::conditional_t<Dimension == 2, Vec2_Type, Vec3_Type>;
+
+  // Side of the bricks, in samples
+  static constexpr std::size_t kBrick = Dimension == 2 ? 8 : 4;
+
+  // Unset samples, see bakeTexture. size is a power of 2, kBrick or more
+  BakedTexture(const std::size_t size, const Vec_Type &origin, const T step);
+
+  BakedTexture(BakedTexture &&other) = default;
+  BakedTexture &operator=(BakedTexture &&other) = default;
+
+  // Interpolated samples around p, wrapping around the grid
+  T eval(const Vec_Type &p) const;
+
+  // Evaluate the count samples (x[k], y[k]...) into out[k]. Float textures
+  // gather the corners with the widest vector kernel the CPU supports
+  // (noise::simd::dispatch), which matches eval bit for bit
+  template <uint_least8_t D = Dimension>
+  std::enable_if_t<D == 2> evalBatch(const T *x, const T *y,
+                                     const std::size_t count, T *out) const;
+
+  template <uint_least8_t D = Dimension>
+  std::enable_if_t<D == 3> evalBatch(const T *x, const T *y, const T *z,
+                                     const std::size_t count, T *out) const;
+
+  // Position of sample (i, j, k) of the grid in data(), for i, j, k below
+  // size
+  std::size_t index(const std::size_t i, const std::size_t j,
+                    const std::size_t k = 0) const;
+
+  // Brick b (bricks are numbered row by row, then slice by slice) takes
+  // kBrick^Dimension samples from data() + b * kBrick^Dimension, row by row
+  T *data() { return samples.get(); }
+  const T *data() const { return samples.get(); }
+
+  std::size_t size() const { return gridSize; }
+  std::size_t bytes() const { return sampleCount() * sizeof(T); }
+  const Vec_Type &origin() const { return gridOrigin; }
+  T step() const { return gridStep; }
+
+private:
+  using Conv_Type = typename utils::int_least_fit_t<T>;
+
+  static constexpr std::size_t kShift = Dimension == 2 ? 3 : 2;
+  static constexpr std::size_t kBrickMask = kBrick - 1;
+  // Samples are aligned on cache lines, as are the bricks
+  static constexpr std::size_t kAlignment = 64;
+  // The vector kernels index float samples with int32 lanes
+  static constexpr bool kHasKernels =
+      std::is_same_v<T, float> && std::is_same_v<Conv_Type, std::int32_t>;
+
+  bool kernelIndices() const {
+    return sampleCount() <= std::size_t{INT32_MAX};
+  }
+
+  struct AlignedDelete {
+    void operator()(T *p) const {
+      ::operator delete[](p, std::align_val_t{kAlignment});
+    }
+  };
+
+  std::size_t sampleCount() const {
+    std::size_t count = gridSize * gridSize;
+    return Dimension == 3 ? count * gridSize : count;
+  }
+
+  // Part of the index of the samples v along axis: the brick, then the
+  // position in the brick
+  std::size_t offset(const std::size_t v, const std::size_t axis) const {
+    return (v >> kShift) * brickStrides[axis] +
+           ((v & kBrickMask) << (axis * kShift));
+  }
+
+  // Grid coordinate of position x along an axis: the lower corner, wrapped,
+  // and the weight of the upper one
+  inline Conv_Type cell(const T x, const T originX, T &t) const;
+
+  std::size_t gridSize;
+  Conv_Type gridMask;
+  // Distance between neighbouring bricks along each axis
+  std::size_t brickStrides[3];
+  Vec_Type gridOrigin;
+  T gridStep;
+  T inverseStep;
+  std::unique_ptr<T[], AlignedDelete> samples;
+};
+
+// Bake noise (any noise with evalGrid) into a size^Dimension texture of
+// samples at origin + (i, j, k) * step; a Vec3 origin bakes a volume. The
+// bricks are filled on pool, slice by slice of evalGrid
+template <typename Noise, typename Vec_Type, typename T>
+auto bakeTexture(utils::ThreadPool &pool, const Noise &noise,
+                 const Vec_Type &origin, const T step, const std::size_t size)
+    -> BakedTexture<T, std::is_same_v<Vec_Type, vector::Vec3<T>> ? 3 : 2>;
+
+// Difference between texture.eval and noise.eval at count points drawn
+// uniformly over the baked domain from seed. The largest differences are
+// at the frequencies the grid cannot hold: the error tells whether size is
+// enough for the noise
+template <typename Noise, typename T, uint_least8_t Dimension>
+BakeError<T> measureBakeError(const BakedTexture<T, Dimension> &texture,
+                              const Noise &noise,
+                              const std::size_t count = 4096,
+                              const std::uint32_t seed = 2011);
+
+} // namespace noise
+
+#include "noise/baked_texture_impl.hpp"
+
+#endif // !BAKED_TEXTURE_H
@@ -0,0 +1,194 @@
+#ifndef BAKED_TEXTURE_IMPL_H
+#define BAKED_TEXTURE_IMPL_H
+
+#include "noise/baked_texture.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "noise/simd/noise_kernels.hpp"
+#include "utils/fast_convertion.hpp"
+#include "utils/lerp.hpp"
+
+namespace noise {
+
+template <typename T, uint_least8_t Dimension>
+BakedTexture<T, Dimension>::BakedTexture(const std::size_t size,
+                                         const Vec_Type &origin, const T step)
+    : gridSize(size), gridMask(static_cast<Conv_Type>(size - 1)),
+      gridOrigin(origin), gridStep(step), inverseStep(1 / step) {
+  assert(size >= kBrick && !(size & (size - 1)) &&
+         "The size must be a power of 2, kBrick or more");
+  const std::size_t bricks = size >> kShift;
+  brickStrides[0] = std::size_t{1} << (Dimension * kShift);
+  brickStrides[1] = brickStrides[0] * bricks;
+  brickStrides[2] = brickStrides[1] * bricks;
+  samples.reset(static_cast<T *>(::operator new[](
+      bytes(), std::align_val_t{kAlignment})));
+}
+
+template <typename T, uint_least8_t Dimension>
+std::size_t BakedTexture<T, Dimension>::index(const std::size_t i,
+                                              const std::size_t j,
+                                              const std::size_t k) const {
+  return offset(i, 0) + offset(j, 1) + offset(k, 2);
+}
+
+template <typename T, uint_least8_t Dimension>
+inline typename BakedTexture<T, Dimension>::Conv_Type
+BakedTexture<T, Dimension>::cell(const T x, const T originX, T &t) const {
+  constexpr auto fast_int_trunc = utils::fast_int_trunc<T, Conv_Type>;
+  const T u = (x - originX) * inverseStep;
+  const Conv_Type ui = fast_int_trunc(u);
+  t = u - static_cast<T>(ui);
+  return ui & gridMask;
+}
+
+template <typename T, uint_least8_t Dimension>
+T BakedTexture<T, Dimension>::eval(const Vec_Type &p) const {
+  constexpr auto lerp = utils::lerp<T>;
+  const T *s = samples.get();
+  const std::size_t mask = gridSize - 1;
+
+  // Offsets of the lower and upper corners along each axis, which add up
+  // to the index of a corner
+  T tx, ty;
+  const std::size_t x0 = static_cast<std::size_t>(cell(p.x, gridOrigin.x, tx));
+  const std::size_t y0 = static_cast<std::size_t>(cell(p.y, gridOrigin.y, ty));
+  const std::size_t ox0 = offset(x0, 0), ox1 = offset((x0 + 1) & mask, 0);
+  const std::size_t oy0 = offset(y0, 1), oy1 = offset((y0 + 1) & mask, 1);
+
+  const auto face = [&](const T *f) {
+    return lerp(lerp(f[ox0 + oy0], f[ox1 + oy0], tx),
+                lerp(f[ox0 + oy1], f[ox1 + oy1], tx), ty);
+  };
+  if constexpr (Dimension == 2) {
+    return face(s);
+  } else {
+    T tz;
+    const std::size_t z0 =
+        static_cast<std::size_t>(cell(p.z, gridOrigin.z, tz));
+    return lerp(face(s + offset(z0, 2)), face(s + offset((z0 + 1) & mask, 2)),
+                tz);
+  }
+}
+
+template <typename T, uint_least8_t Dimension>
+template <uint_least8_t D>
+std::enable_if_t<D == 2>
+BakedTexture<T, Dimension>::evalBatch(const T *x, const T *y,
+                                      const std::size_t count, T *out) const {
+  if constexpr (kHasKernels) {
+    if (kernelIndices()) {
+      const std::int32_t strides[2] = {
+          static_cast<std::int32_t>(brickStrides[0]),
+          static_cast<std::int32_t>(brickStrides[1])};
+      const float origin[2] = {gridOrigin.x, gridOrigin.y};
+      const bool done = simd::dispatch([&](auto kernels) {
+        kernels.template bakedTexture2D<kShift>(samples.get(), gridMask,
+                                                strides, origin, inverseStep,
+                                                x, y, count, out);
+      });
+      if (done) {
+        return;
+      }
+    }
+  }
+
+  for (std::size_t k = 0; k < count; ++k) {
+    out[k] = eval(Vec2_Type(x[k], y[k]));
+  }
+}
+
+template <typename T, uint_least8_t Dimension>
+template <uint_least8_t D>
+std::enable_if_t<D == 3>
+BakedTexture<T, Dimension>::evalBatch(const T *x, const T *y, const T *z,
+                                      const std::size_t count, T *out) const {
+  if constexpr (kHasKernels) {
+    if (kernelIndices()) {
+      const std::int32_t strides[3] = {
+          static_cast<std::int32_t>(brickStrides[0]),
+          static_cast<std::int32_t>(brickStrides[1]),
+          static_cast<std::int32_t>(brickStrides[2])};
+      const float origin[3] = {gridOrigin.x, gridOrigin.y, gridOrigin.z};
+      const bool done = simd::dispatch([&](auto kernels) {
+        kernels.template bakedTexture3D<kShift>(samples.get(), gridMask,
+                                                strides, origin, inverseStep,
+                                                x, y, z, count, out);
+      });
+      if (done) {
+        return;
+      }
+    }
+  }
+
+  for (std::size_t k = 0; k < count; ++k) {
+    out[k] = eval(Vec3_Type(x[k], y[k], z[k]));
+  }
+}
+
+template <typename Noise, typename Vec_Type, typename T>
+auto bakeTexture(utils::ThreadPool &pool, const Noise &noise,
+                 const Vec_Type &origin, const T step, const std::size_t size)
+    -> BakedTexture<T, std::is_same_v<Vec_Type, vector::Vec3<T>> ? 3 : 2> {
+  using Texture =
+      BakedTexture<T, std::is_same_v<Vec_Type, vector::Vec3<T>> ? 3 : 2>;
+  constexpr bool kVolume = std::is_same_v<Vec_Type, vector::Vec3<T>>;
+  constexpr std::size_t kBrick = Texture::kBrick;
+  constexpr std::size_t kBrickArea = kBrick * kBrick;
+
+  Texture texture(size, origin, step);
+  const std::size_t bricks = size / kBrick;
+  const std::size_t slices = kVolume ? size : 1;
+
+  // One task per row of bricks, each brick as kBrick slices of evalGrid
+  pool.parallelFor(bricks * (kVolume ? bricks : 1), [&](const std::size_t r) {
+    const std::size_t row = (r % bricks) * kBrick;
+    const std::size_t slice = (r / bricks) * kBrick;
+    for (std::size_t b = 0; b < bricks; ++b) {
+      T *brick = texture.data() + texture.index(b * kBrick, row, slice);
+      for (std::size_t k = 0; k < std::min(kBrick, slices); ++k) {
+        Vec_Type sliceOrigin = origin;
+        if constexpr (kVolume) {
+          sliceOrigin.z += static_cast<T>(slice + k) * step;
+        }
+        noise.evalGrid(sliceOrigin, step, kBrick, kBrick,
+                       brick + k * kBrickArea, kBrick, b * kBrick, row);
+      }
+    }
+  });
+  return texture;
+}
+
+template <typename Noise, typename T, uint_least8_t Dimension>
+BakeError<T> measureBakeError(const BakedTexture<T, Dimension> &texture,
+                              const Noise &noise, const std::size_t count,
+                              const std::uint32_t seed) {
+  // Within the last samples: past them the texture wraps to the first
+  // ones, which only continues the noise if it is periodic
+  const T extent = static_cast<T>(texture.size() - 1) * texture.step();
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<T> distribution{0, extent};
+
+  double maxError = 0, squares = 0;
+  for (std::size_t n = 0; n < count; ++n) {
+    auto p = texture.origin();
+    p.x += distribution(generator);
+    p.y += distribution(generator);
+    if constexpr (Dimension == 3) {
+      p.z += distribution(generator);
+    }
+    const double error =
+        std::fabs(static_cast<double>(texture.eval(p)) - noise.eval(p));
+    maxError = std::max(maxError, error);
+    squares += error * error;
+  }
+  return BakeError<T>{static_cast<T>(maxError),
+                      static_cast<T>(std::sqrt(squares / count))};
+}
+
+} // namespace noise
+
+#endif // !BAKED_TEXTURE_IMPL_H
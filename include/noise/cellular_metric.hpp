@@ -0,0 +1,88 @@
+#ifndef CELLULAR_METRIC_H
+#define CELLULAR_METRIC_H
+
+#include <cmath>
+#include <cstddef>
+
+namespace noise {
+
+// Distance metrics the Worley kernels have a vector version of, named by
+// the kKernel of the metric policies below
+enum class KernelMetric { EuclideanSquared, Euclidean, Manhattan, Chebyshev };
+
+// What WorleyNoiseND returns of the distances F1 and F2 from a point to the
+// nearest and the second nearest feature points
+enum class CellularOutput {
+  F1,
+  F2,
+  // F2 - F1, 0 on the borders between the cells of two feature points
+  Edge
+};
+
+// Distance metrics of WorleyNoiseND, as policies. measure(d) is what is
+// compared between the feature points, d holding the differences along
+// each axis: it never decreases as one |d[a]| grows. finish(measure) is the
+// distance returned. kKernel names the vector version of the metric, a
+// policy without it runs on the scalar path only
+
+// Euclidean distance, compared squared
+struct EuclideanMetric {
+  static constexpr KernelMetric kKernel = KernelMetric::Euclidean;
+
+  template <typename T, std::size_t N> static T measure(const T (&d)[N]) {
+    T s = d[0] * d[0];
+    for (std::size_t a = 1; a < N; ++a) {
+      s = s + d[a] * d[a];
+    }
+    return s;
+  }
+
+  template <typename T> static T finish(const T s) { return std::sqrt(s); }
+};
+
+// Squared Euclidean distance, without the square root
+struct EuclideanSquaredMetric {
+  static constexpr KernelMetric kKernel =
+      KernelMetric::EuclideanSquared;
+
+  template <typename T, std::size_t N> static T measure(const T (&d)[N]) {
+    return EuclideanMetric::measure(d);
+  }
+
+  template <typename T> static T finish(const T s) { return s; }
+};
+
+// Sum of the distances along the axes, diamond shaped cells
+struct ManhattanMetric {
+  static constexpr KernelMetric kKernel = KernelMetric::Manhattan;
+
+  template <typename T, std::size_t N> static T measure(const T (&d)[N]) {
+    T s = std::abs(d[0]);
+    for (std::size_t a = 1; a < N; ++a) {
+      s = s + std::abs(d[a]);
+    }
+    return s;
+  }
+
+  template <typename T> static T finish(const T s) { return s; }
+};
+
+// Largest distance along the axes, square cells
+struct ChebyshevMetric {
+  static constexpr KernelMetric kKernel = KernelMetric::Chebyshev;
+
+  template <typename T, std::size_t N> static T measure(const T (&d)[N]) {
+    T s = std::abs(d[0]);
+    for (std::size_t a = 1; a < N; ++a) {
+      const T v = std::abs(d[a]);
+      s = s > v ? s : v;
+    }
+    return s;
+  }
+
+  template <typename T> static T finish(const T s) { return s; }
+};
+
+} // namespace noise
+
+#endif // !CELLULAR_METRIC_H
@@ -0,0 +1,163 @@
+#ifndef CHUNK_CACHE_H
+#define CHUNK_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace noise {
+
+// Identity of a chunk: the source of its samples (the noise, its
+// parameters and seed, see chunkSource), its coordinates on the chunk grid
+// and its level of detail, samples 2^lod apart
+struct ChunkKey {
+  std::uint64_t source;
+  std::int32_t x, y;
+  std::uint32_t lod;
+
+  bool operator==(const ChunkKey &other) const {
+    return source == other.source && x == other.x && y == other.y &&
+           lod == other.lod;
+  }
+};
+
+struct ChunkKeyHash {
+  std::size_t operator()(const ChunkKey &key) const {
+    // boost::hash_combine, over the fields
+    std::size_t h = std::hash<std::uint64_t>()(key.source);
+    const std::uint64_t fields[3] = {static_cast<std::uint32_t>(key.x),
+                                     static_cast<std::uint32_t>(key.y),
+                                     key.lod};
+    for (const std::uint64_t f : fields) {
+      h ^= std::hash<std::uint64_t>()(f) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+    return h;
+  }
+};
+
+// ChunkKey::source for the chunks of a Noise type drawn from seed. config
+// tells apart the other settings the chunks depend on (frequency, octaves
+// of a FractalNoise...), as the caller defines them
+template <typename Noise, typename Seed_Type>
+std::uint64_t chunkSource(const Seed_Type seed, const std::uint64_t config = 0) {
+  std::uint64_t h = typeid(Noise).hash_code();
+  for (const std::uint64_t f : {std::uint64_t{std::hash<Seed_Type>()(seed)},
+                                config}) {
+    h ^= f + 0x9e3779b97f4a7c15u + (h << 6) + (h >> 2);
+  }
+  return h;
+}
+
+struct ChunkCacheStats {
+  std::size_t hits;      // Found generated
+  std::size_t joins;     // Found in generation, waited for it
+  std::size_t misses;    // Generated by the request
+  std::size_t evictions; // Dropped to fit the budget
+  std::size_t chunks;    // Generated chunks held
+  std::size_t bytes;     // Size of their samples
+};
+
+// Cache of chunks of T samples, for rasters that are requested again and
+// again, e.g. terrain around a moving camera. The generated chunks stay
+// until the ones held outgrow budget bytes; the least recently requested
+// ones go first. Thread safe: a chunk that is being generated is not
+// generated again, the requests that come meanwhile wait for it (single
+// flight). Chunks are handed out as shared immutable arrays, so an evicted
+// chunk lives on while someone holds it
+template <typename T> class ChunkCache {
+public:
+  using Chunk = std::vector<T>;
+  using Chunk_Ptr = std::shared_ptr<const Chunk>;
+
+  explicit ChunkCache(const std::size_t budget);
+
+  ChunkCache(const ChunkCache &other) = delete;
+  ChunkCache &operator=(const ChunkCache &other) = delete;
+
+  // The chunk of key. On a miss, generate(out) fills its samples samples
+  // on the calling thread, without any lock held. If generate throws, the
+  // exception reaches this caller and the ones waiting on it, and the next
+  // request tries again
+  template <typename Generate>
+  Chunk_Ptr get(const ChunkKey &key, const std::size_t samples,
+                Generate generate);
+
+  // The chunk of key if it is generated, without updating its recency
+  Chunk_Ptr find(const ChunkKey &key) const;
+
+  // Drop the generated chunks, the ones in generation are kept
+  void clear();
+
+  ChunkCacheStats stats() const;
+
+  std::size_t budget() const { return budgetBytes; }
+
+private:
+  struct Entry {
+    std::shared_future<Chunk_Ptr> chunk;
+    // Position in lru, once generated
+    typename std::list<ChunkKey>::iterator recency;
+    std::size_t bytes = 0;
+    bool ready = false;
+  };
+
+  // Record the generated chunk of key and evict to fit the budget, under
+  // the lock
+  void insert(const ChunkKey &key, const std::size_t bytes);
+  void evict();
+
+  const std::size_t budgetBytes;
+
+  mutable std::mutex mutex;
+  std::unordered_map<ChunkKey, Entry, ChunkKeyHash> entries;
+  // Generated chunks, most recently requested first
+  std::list<ChunkKey> lru;
+  ChunkCacheStats counters{};
+};
+
+// Square chunks of chunkSize x chunkSize samples of noise.evalGrid, served
+// through a ChunkCache. Chunk (x, y) at lod starts at origin + (x, y) *
+// chunkSize * step * 2^lod, with samples step * 2^lod apart, so the chunks
+// of a level tile the plane and each level halves the resolution of the
+// previous one. A Vec3 origin samples the z = origin.z slice of 3D noise
+template <typename Noise, typename Vec_Type> class NoiseChunks {
+public:
+  using Result_Type = typename Noise::Value_Type;
+  using Cache_Type = ChunkCache<Result_Type>;
+  using Chunk_Ptr = typename Cache_Type::Chunk_Ptr;
+
+  // noise and cache are referenced, not copied. source must tell these
+  // chunks apart from the other ones in cache, see chunkSource
+  NoiseChunks(const Noise &noise, const std::uint64_t source,
+              const Vec_Type &origin, const Result_Type step,
+              const std::size_t chunkSize, Cache_Type &cache)
+      : noise(noise), source(source), origin(origin), step(step),
+        chunkSize(chunkSize), cache(cache) {}
+
+  // Rows of chunkSize samples, row after row
+  Chunk_Ptr chunk(const std::int32_t x, const std::int32_t y,
+                  const std::uint32_t lod = 0) const;
+
+  std::size_t size() const { return chunkSize; }
+
+private:
+  const Noise &noise;
+  std::uint64_t source;
+  Vec_Type origin;
+  Result_Type step;
+  std::size_t chunkSize;
+  Cache_Type &cache;
+};
+
+} // namespace noise
+
+#include "noise/chunk_cache_impl.hpp"
+
+#endif // !CHUNK_CACHE_H
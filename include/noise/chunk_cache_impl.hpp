@@ -0,0 +1,134 @@
+#ifndef CHUNK_CACHE_IMPL_H
+#define CHUNK_CACHE_IMPL_H
+
+#include "noise/chunk_cache.hpp"
+
+#include <cmath>
+#include <exception>
+#include <utility>
+
+namespace noise {
+
+template <typename T>
+ChunkCache<T>::ChunkCache(const std::size_t budget) : budgetBytes(budget) {}
+
+template <typename T>
+template <typename Generate>
+typename ChunkCache<T>::Chunk_Ptr
+ChunkCache<T>::get(const ChunkKey &key, const std::size_t samples,
+                   Generate generate) {
+  std::promise<Chunk_Ptr> promise;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    const auto it = entries.find(key);
+    if (it != entries.end()) {
+      Entry &entry = it->second;
+      if (entry.ready) {
+        ++counters.hits;
+        lru.splice(lru.begin(), lru, entry.recency);
+      } else {
+        ++counters.joins;
+      }
+      // Waits outside of the lock for a chunk in generation
+      const std::shared_future<Chunk_Ptr> chunk = entry.chunk;
+      lock.unlock();
+      return chunk.get();
+    }
+
+    ++counters.misses;
+    entries[key].chunk = promise.get_future().share();
+  }
+
+  Chunk_Ptr chunk;
+  try {
+    auto samplesOut = std::make_shared<Chunk>(samples);
+    generate(samplesOut->data());
+    chunk = std::move(samplesOut);
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      entries.erase(key);
+    }
+    promise.set_exception(std::current_exception());
+    throw;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    insert(key, samples * sizeof(T));
+  }
+  promise.set_value(chunk);
+  return chunk;
+}
+
+template <typename T>
+void ChunkCache<T>::insert(const ChunkKey &key, const std::size_t bytes) {
+  Entry &entry = entries[key];
+  lru.push_front(key);
+  entry.recency = lru.begin();
+  entry.bytes = bytes;
+  entry.ready = true;
+
+  ++counters.chunks;
+  counters.bytes += bytes;
+  evict();
+}
+
+template <typename T> void ChunkCache<T>::evict() {
+  while (counters.bytes > budgetBytes && !lru.empty()) {
+    const auto it = entries.find(lru.back());
+    counters.bytes -= it->second.bytes;
+    --counters.chunks;
+    ++counters.evictions;
+    entries.erase(it);
+    lru.pop_back();
+  }
+}
+
+template <typename T>
+typename ChunkCache<T>::Chunk_Ptr
+ChunkCache<T>::find(const ChunkKey &key) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto it = entries.find(key);
+  if (it == entries.end() || !it->second.ready) {
+    return nullptr;
+  }
+  // A ready future, get does not block
+  return it->second.chunk.get();
+}
+
+template <typename T> void ChunkCache<T>::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  for (const ChunkKey &key : lru) {
+    entries.erase(key);
+  }
+  lru.clear();
+  counters.chunks = 0;
+  counters.bytes = 0;
+}
+
+template <typename T> ChunkCacheStats ChunkCache<T>::stats() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return counters;
+}
+
+template <typename Noise, typename Vec_Type>
+typename NoiseChunks<Noise, Vec_Type>::Chunk_Ptr
+NoiseChunks<Noise, Vec_Type>::chunk(const std::int32_t x, const std::int32_t y,
+                                    const std::uint32_t lod) const {
+  const ChunkKey key{source, x, y, lod};
+  return cache.get(key, chunkSize * chunkSize, [&](Result_Type *out) {
+    const Result_Type lodStep = std::ldexp(step, static_cast<int>(lod));
+    const Result_Type span = lodStep * static_cast<Result_Type>(chunkSize);
+
+    Vec_Type chunkOrigin = origin;
+    chunkOrigin.x += static_cast<Result_Type>(x) * span;
+    chunkOrigin.y += static_cast<Result_Type>(y) * span;
+    noise.evalGrid(chunkOrigin, lodStep, chunkSize, chunkSize, out,
+                   chunkSize);
+  });
+}
+
+} // namespace noise
+
+#endif // !CHUNK_CACHE_IMPL_H
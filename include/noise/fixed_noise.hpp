@@ -0,0 +1,176 @@
+#ifndef FIXED_NOISE_H
+#define FIXED_NOISE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+
+#include "noise/fixed_point.hpp"
+#include "noise/lattice_tables.hpp"
+#include "noise/simd/kernel_remap.hpp"
+#include "vec/vec2.hpp"
+#include "vec/vec3.hpp"
+
+namespace noise {
+
+// ValueNoiseND in integer arithmetic, for consumers that only need 8 to 16
+// bits: Q16.16 coordinates in, Q15 samples out (see noise/fixed_point.hpp),
+// random values in [0, 1) as Q15 and the remap and lerps in Q15. The
+// tables are the ones of ValueNoiseND<Dimension, Period, Engine, float>
+// with the same seed, so the samples are the ones of the float noise within
+// a few units of Q15. evalBatch runs the remap and lerps in int16 lanes,
+// twice as many as float lanes.
+//
+// Given the tables, sampling is integer arithmetic only. The tables of the
+// Seed_Type constructor come from Engine and the standard distributions,
+// which differ between standard libraries; only the StaticSeed constructor
+// draws the same tables, and so the same samples, on any CPU, compiler and
+// standard library
+template <uint_least8_t Dimension = 2, uint_least16_t Period = 256,
+          typename Engine = std::default_random_engine,
+          simd::KernelRemap Remap = simd::KernelRemap::Smoothstep>
+class FixedValueNoise {
+public:
+  static_assert(Dimension == 2 || Dimension == 3, "Dimension must be 2 or 3");
+  static_assert(Remap != simd::KernelRemap::None,
+                "The remap must be smoothstep or Perlin's quintic");
+
+  using Dist = typename std::uniform_real_distribution<float>;
+  using Seed_Type = typename Dist::result_type;
+  using Value_Type = Q15_Type;
+
+  // Samples in [0, 1) as Q15, i.e. in [0, 32767]
+  static constexpr bool kSignedOutput = false;
+
+  using Vec2_Type = typename vector::Vec2<Fixed_Type>;
+  using Vec3_Type = typename vector::Vec3<Fixed_Type>;
+
+  FixedValueNoise(Seed_Type seed = 2011);
+
+  // Tables of ValueNoiseND<Dimension, Period, Engine, float>(seed), drawn
+  // at compile time for a constexpr instance, see StaticSeed
+  explicit constexpr FixedValueNoise(const StaticSeed seed);
+
+  Value_Type eval(const Vec2_Type &p) const;
+
+  template <uint_least8_t T = Dimension>
+  std::enable_if_t<3 <= T, Value_Type> eval(const Vec3_Type &p) const;
+
+  // Evaluate the count samples (x[k], y[k]...) into out[k], with the widest
+  // vector kernel the CPU supports (noise::simd::dispatch). The results are
+  // the ones of eval, exactly
+  void evalBatch(const Fixed_Type *x, const Fixed_Type *y,
+                 const std::size_t count, Value_Type *out) const;
+
+  template <uint_least8_t T = Dimension>
+  std::enable_if_t<3 <= T> evalBatch(const Fixed_Type *x, const Fixed_Type *y,
+                                     const Fixed_Type *z,
+                                     const std::size_t count,
+                                     Value_Type *out) const;
+
+private:
+  static_assert(Period > 1 && !(Period & (Period - 1)),
+                "Period must be power of 2 different from 0");
+  static constexpr auto kMaxVertices{Period};
+  static constexpr std::int32_t kMaxVerticesMask{Period - 1};
+
+  static inline Q15_Type remap(const Q15_Type t) {
+    if constexpr (Remap == simd::KernelRemap::Smoothstep) {
+      return smoothstepRemapQ15(t);
+    } else {
+      return perlinRemapQ15(t);
+    }
+  }
+
+  // cornerValues from the Q15 values r of the lattice, once the permutation
+  // is drawn
+  constexpr void setCornerValues(
+      const std::array<std::int32_t, kMaxVertices> &r);
+
+  // Q15 random values of the corners by hash prefix plus the last
+  // coordinate, i.e. already through the last permutation, as int32 for the
+  // gathers of the kernels
+  std::array<std::int32_t, 2 * kMaxVertices> cornerValues{};
+  PermutationTable<kMaxVertices, std::int32_t, TableLayout::Wide>
+      permutationTable{};
+};
+
+// PerlinNoise3D in integer arithmetic, as FixedValueNoise: Q16.16
+// coordinates, Q15 samples of the same scale as the float noise (i.e.
+// within +-sqrt(3) / 2 * 32768). The gradients and the dot products are
+// Q13, which holds the +-sqrt(3) of a dot product with room for the lerps.
+// The tables of the Seed_Type constructor are the ones of
+// PerlinNoise3D<Period, Engine, float> with the same seed, drawn through
+// float trigonometry on top of Engine. The StaticSeed constructor draws its
+// Q13 gradients with integers only, so its samples are the same on any CPU,
+// compiler and standard library
+template <uint_least16_t Period = 256,
+          typename Engine = std::default_random_engine>
+class FixedPerlinNoise3D {
+public:
+  using Dist = typename std::uniform_real_distribution<float>;
+  using Seed_Type = typename Dist::result_type;
+  using Value_Type = Q15_Type;
+
+  static constexpr bool kSignedOutput = true;
+
+  using Vec3_Type = typename vector::Vec3<Fixed_Type>;
+
+  FixedPerlinNoise3D(Seed_Type seed = 2011);
+
+  // Tables drawn at compile time for a constexpr instance, see StaticSeed.
+  // They differ from the ones of PerlinNoise3D(seed)
+  explicit constexpr FixedPerlinNoise3D(const StaticSeed seed);
+
+  Value_Type eval(const Vec3_Type &p) const;
+
+  // Same contract as the evalBatch of FixedValueNoise
+  void evalBatch(const Fixed_Type *x, const Fixed_Type *y,
+                 const Fixed_Type *z, const std::size_t count,
+                 Value_Type *out) const;
+
+private:
+  static_assert(Period > 1 && !(Period & (Period - 1)),
+                "Period must be power of 2 different from 0");
+  static constexpr auto kTableSize{Period};
+  static constexpr std::int32_t kTableSizeMask{Period - 1};
+
+  // Dot product between the gradient of the corner of hash prefix plus z
+  // i and (x, y, z), in Q13
+  inline Q15_Type cornerDot(const std::int32_t i, const Q15_Type x,
+                            const Q15_Type y, const Q15_Type z) const {
+    const std::int32_t xy = gradientsXY[i];
+    const auto gx = static_cast<Q15_Type>(xy >> 16);
+    const auto gy = static_cast<Q15_Type>((xy & 0xFFFF) - 0x8000);
+    const auto gz = static_cast<Q15_Type>(gradientsZ[i]);
+    return static_cast<Q15_Type>(mulQ15(gx, x) + mulQ15(gy, y) +
+                                 mulQ15(gz, z));
+  }
+
+  // gradientsXY and gradientsZ from the {x, y, z} Q13 gradients of the
+  // lattice, once the permutation is drawn
+  constexpr void
+  setGradients(const std::array<std::int32_t, 3 * kTableSize> &gradients);
+
+  // Hash prefix of the corners (x, y, *)
+  inline std::int32_t hash(const std::int32_t x, const std::int32_t y) const {
+    return permutationTable[permutationTable[x] + y];
+  }
+
+  // Q13 gradients of the corners, by hash prefix plus z, i.e. already
+  // through the last permutation: x in the high 16 bits and y + 2^15 in the
+  // low ones of gradientsXY, z in gradientsZ. Kernels gather them in int32
+  // lanes, two gathers per corner instead of four
+  std::array<std::int32_t, 2 * kTableSize> gradientsXY{};
+  std::array<std::int32_t, 2 * kTableSize> gradientsZ{};
+  PermutationTable<kTableSize, std::int32_t, TableLayout::Wide>
+      permutationTable{};
+};
+
+} // namespace noise
+
+#include "noise/fixed_noise_impl.hpp"
+
+#endif // !FIXED_NOISE_H
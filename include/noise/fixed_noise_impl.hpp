@@ -0,0 +1,338 @@
+#ifndef FIXED_NOISE_IMPL_H
+#define FIXED_NOISE_IMPL_H
+
+#include "noise/fixed_noise.hpp"
+
+#include <cmath>
+#include <functional>
+#include <utility>
+
+#include "noise/simd/noise_kernels.hpp"
+#include "utils/constants.hpp"
+
+namespace noise {
+
+// FixedValueNoise
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          simd::KernelRemap Remap>
+FixedValueNoise<Dimension, Period, Engine, Remap>::FixedValueNoise(
+    Seed_Type seed) {
+  Dist distribution{0.0f, 1.0f};
+  Engine generator;
+  std::array<std::int32_t, kMaxVertices> r;
+
+  // Drawn as by ValueNoiseND, the values rounded down to Q15
+  generator.seed(seed);
+  for (auto i = 0; i < kMaxVertices; ++i) {
+    r[i] = static_cast<std::int32_t>(distribution(generator) * 32768);
+    permutationTable.at(i) = i;
+  }
+
+  // shuffle values of the permutation table
+  std::uniform_int_distribution distrUInt{0, kMaxVerticesMask};
+  auto randUInt = std::bind(distrUInt, generator);
+  for (auto k = 0; k < kMaxVertices; ++k) {
+    auto i = randUInt();
+    std::swap(permutationTable.at(k), permutationTable.at(i));
+    permutationTable.mirror(k);
+  }
+
+  setCornerValues(r);
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          simd::KernelRemap Remap>
+constexpr FixedValueNoise<Dimension, Period, Engine, Remap>::FixedValueNoise(
+    const StaticSeed seed) {
+  // Drawn as by ValueNoiseND, the values rounded down to Q15. The values
+  // are multiples of 2^-24, so the rounding is exact on any CPU
+  utils::SplitMix64 generator{seed.value};
+  std::array<float, kMaxVertices> values{};
+  drawValues(values, generator);
+  drawPermutation(permutationTable, generator);
+
+  std::array<std::int32_t, kMaxVertices> r{};
+  for (std::size_t i = 0; i < kMaxVertices; ++i) {
+    r[i] = static_cast<std::int32_t>(values[i] * 32768);
+  }
+  setCornerValues(r);
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          simd::KernelRemap Remap>
+constexpr void
+FixedValueNoise<Dimension, Period, Engine, Remap>::setCornerValues(
+    const std::array<std::int32_t, kMaxVertices> &r) {
+  for (std::int32_t i = 0; i < 2 * kMaxVertices; ++i) {
+    cornerValues[i] = r[permutationTable[i]];
+  }
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          simd::KernelRemap Remap>
+typename FixedValueNoise<Dimension, Period, Engine, Remap>::Value_Type
+FixedValueNoise<Dimension, Period, Engine, Remap>::eval(
+    const Vec2_Type &p) const {
+  const std::int32_t rx0 = fixedCell(p.x) & kMaxVerticesMask;
+  const std::int32_t rx1 = (rx0 + 1) & kMaxVerticesMask;
+  const std::int32_t ry0 = fixedCell(p.y) & kMaxVerticesMask;
+  const std::int32_t ry1 = (ry0 + 1) & kMaxVerticesMask;
+
+  // random values at the corners of the cell
+  const std::int32_t hx0 = permutationTable[rx0];
+  const std::int32_t hx1 = permutationTable[rx1];
+  const auto c00 = static_cast<Q15_Type>(cornerValues[hx0 + ry0]);
+  const auto c10 = static_cast<Q15_Type>(cornerValues[hx1 + ry0]);
+  const auto c01 = static_cast<Q15_Type>(cornerValues[hx0 + ry1]);
+  const auto c11 = static_cast<Q15_Type>(cornerValues[hx1 + ry1]);
+
+  const Q15_Type sx = remap(fixedFraction(p.x));
+  const Q15_Type sy = remap(fixedFraction(p.y));
+
+  return lerpQ15(lerpQ15(c00, c10, sx), lerpQ15(c01, c11, sx), sy);
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          simd::KernelRemap Remap>
+template <uint_least8_t T>
+std::enable_if_t<
+    3 <= T,
+    typename FixedValueNoise<Dimension, Period, Engine, Remap>::Value_Type>
+FixedValueNoise<Dimension, Period, Engine, Remap>::eval(
+    const Vec3_Type &p) const {
+  const std::int32_t rx0 = fixedCell(p.x) & kMaxVerticesMask;
+  const std::int32_t rx1 = (rx0 + 1) & kMaxVerticesMask;
+  const std::int32_t ry0 = fixedCell(p.y) & kMaxVerticesMask;
+  const std::int32_t ry1 = (ry0 + 1) & kMaxVerticesMask;
+  const std::int32_t rz0 = fixedCell(p.z) & kMaxVerticesMask;
+  const std::int32_t rz1 = (rz0 + 1) & kMaxVerticesMask;
+
+  // random values at the corners of the cell
+  const std::int32_t hx0 = permutationTable[rx0];
+  const std::int32_t hx1 = permutationTable[rx1];
+  const std::int32_t h00 = permutationTable[hx0 + ry0];
+  const std::int32_t h10 = permutationTable[hx1 + ry0];
+  const std::int32_t h01 = permutationTable[hx0 + ry1];
+  const std::int32_t h11 = permutationTable[hx1 + ry1];
+
+  const auto corner = [&](const std::int32_t h, const std::int32_t rz) {
+    return static_cast<Q15_Type>(cornerValues[h + rz]);
+  };
+
+  const Q15_Type sx = remap(fixedFraction(p.x));
+  const Q15_Type sy = remap(fixedFraction(p.y));
+  const Q15_Type sz = remap(fixedFraction(p.z));
+
+  const Q15_Type nx00 = lerpQ15(corner(h00, rz0), corner(h10, rz0), sx);
+  const Q15_Type nx10 = lerpQ15(corner(h01, rz0), corner(h11, rz0), sx);
+  const Q15_Type nx01 = lerpQ15(corner(h00, rz1), corner(h10, rz1), sx);
+  const Q15_Type nx11 = lerpQ15(corner(h01, rz1), corner(h11, rz1), sx);
+
+  return lerpQ15(lerpQ15(nx00, nx10, sy), lerpQ15(nx01, nx11, sy), sz);
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          simd::KernelRemap Remap>
+void FixedValueNoise<Dimension, Period, Engine, Remap>::evalBatch(
+    const Fixed_Type *x, const Fixed_Type *y, const std::size_t count,
+    Value_Type *out) const {
+  const bool done = simd::dispatch([&](auto kernels) {
+    kernels.template fixedValueNoise2D<Remap>(permutationTable.data(),
+                                              cornerValues.data(),
+                                              kMaxVerticesMask, x, y, count,
+                                              out);
+  });
+  if (done) {
+    return;
+  }
+
+  for (std::size_t k = 0; k < count; ++k) {
+    out[k] = eval(Vec2_Type(x[k], y[k]));
+  }
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          simd::KernelRemap Remap>
+template <uint_least8_t T>
+std::enable_if_t<3 <= T>
+FixedValueNoise<Dimension, Period, Engine, Remap>::evalBatch(
+    const Fixed_Type *x, const Fixed_Type *y, const Fixed_Type *z,
+    const std::size_t count, Value_Type *out) const {
+  const bool done = simd::dispatch([&](auto kernels) {
+    kernels.template fixedValueNoise3D<Remap>(permutationTable.data(),
+                                              cornerValues.data(),
+                                              kMaxVerticesMask, x, y, z,
+                                              count, out);
+  });
+  if (done) {
+    return;
+  }
+
+  for (std::size_t k = 0; k < count; ++k) {
+    out[k] = eval(Vec3_Type(x[k], y[k], z[k]));
+  }
+}
+
+// FixedPerlinNoise3D
+
+template <uint_least16_t Period, typename Engine>
+FixedPerlinNoise3D<Period, Engine>::FixedPerlinNoise3D(Seed_Type seed) {
+  // Drawn as by PerlinNoise3D, the gradients rounded to Q13
+  Dist distribution{0.0f, 1.0f};
+  Engine generator;
+
+  auto dice = std::bind(distribution, generator);
+
+  float theta, phi;
+  std::array<std::int32_t, 3 * kTableSize> gradients;
+
+  generator.seed(seed);
+  for (auto i = 0; i < kTableSize; ++i) {
+    theta = std::acos(2.0 * dice() - 1.0);
+    phi = 2.0 * dice() * utils::pi<float>;
+
+    const float g[3] = {std::cos(phi) * std::sin(theta),
+                        std::sin(phi) * std::sin(theta), std::cos(theta)};
+    for (std::size_t c = 0; c < 3; ++c) {
+      gradients[3 * i + c] =
+          static_cast<std::int32_t>(std::lround(g[c] * 8192));
+    }
+
+    permutationTable.at(i) = i;
+  }
+
+  // shuffle values of the permutation table
+  std::uniform_int_distribution distrUInt{0, kTableSizeMask};
+  auto randUInt = std::bind(distrUInt, generator);
+  for (auto k = 0; k < kTableSize; ++k) {
+    auto i = randUInt();
+    std::swap(permutationTable.at(k), permutationTable.at(i));
+    permutationTable.mirror(k);
+  }
+
+  setGradients(gradients);
+}
+
+// c / sqrt(length2) in Q13, rounded to nearest (half away from 0), for
+// |c| <= sqrt(length2): the largest q with q - 1/2 <= |c| 2^13 /
+// sqrt(length2), found by bisection on the squares
+constexpr std::int32_t unitQ13(const std::int64_t c,
+                               const std::uint64_t length2) {
+  const std::uint64_t n = 8192 * static_cast<std::uint64_t>(c < 0 ? -c : c);
+  std::int32_t low = 0, high = 8192;
+  while (low < high) {
+    const std::int32_t q = (low + high + 1) / 2;
+    const std::uint64_t d = 2 * static_cast<std::uint64_t>(q) - 1;
+    if (d * d * length2 <= 4 * n * n) {
+      low = q;
+    } else {
+      high = q - 1;
+    }
+  }
+  return c < 0 ? -low : low;
+}
+
+template <uint_least16_t Period, typename Engine>
+constexpr FixedPerlinNoise3D<Period, Engine>::FixedPerlinNoise3D(
+    const StaticSeed seed) {
+  // Unit vectors uniform on the sphere, as drawGradients, in integers: a
+  // point uniform in the ball of radius 2^15, drawn by rejection from the
+  // cube, then scaled to 2^13
+  utils::SplitMix64 generator{seed.value};
+  std::array<std::int32_t, 3 * kTableSize> gradients{};
+  for (std::size_t i = 0; i < kTableSize; ++i) {
+    std::int64_t p[3] = {0, 0, 0};
+    std::uint64_t length2 = 0;
+    do {
+      for (std::int64_t &c : p) {
+        c = static_cast<std::int64_t>(generator.below(65537)) - 32768;
+      }
+      length2 = static_cast<std::uint64_t>(p[0] * p[0] + p[1] * p[1] +
+                                           p[2] * p[2]);
+    } while (length2 > (std::uint64_t{1} << 30) ||
+             length2 < (std::uint64_t{1} << 20));
+
+    for (std::size_t c = 0; c < 3; ++c) {
+      gradients[3 * i + c] = unitQ13(p[c], length2);
+    }
+  }
+  drawPermutation(permutationTable, generator);
+
+  setGradients(gradients);
+}
+
+template <uint_least16_t Period, typename Engine>
+constexpr void FixedPerlinNoise3D<Period, Engine>::setGradients(
+    const std::array<std::int32_t, 3 * kTableSize> &gradients) {
+  for (std::int32_t i = 0; i < 2 * kTableSize; ++i) {
+    const std::int32_t *g = gradients.data() + 3 * permutationTable[i];
+    gradientsXY[i] = g[0] * 65536 + (g[1] + 0x8000);
+    gradientsZ[i] = g[2];
+  }
+}
+
+template <uint_least16_t Period, typename Engine>
+typename FixedPerlinNoise3D<Period, Engine>::Value_Type
+FixedPerlinNoise3D<Period, Engine>::eval(const Vec3_Type &p) const {
+  const std::int32_t xi0 = fixedCell(p.x) & kTableSizeMask;
+  const std::int32_t yi0 = fixedCell(p.y) & kTableSizeMask;
+  const std::int32_t zi0 = fixedCell(p.z) & kTableSizeMask;
+
+  const std::int32_t xi1 = (xi0 + 1) & kTableSizeMask;
+  const std::int32_t yi1 = (yi0 + 1) & kTableSizeMask;
+  const std::int32_t zi1 = (zi0 + 1) & kTableSizeMask;
+
+  const Q15_Type tx = fixedFraction(p.x);
+  const Q15_Type ty = fixedFraction(p.y);
+  const Q15_Type tz = fixedFraction(p.z);
+
+  const Q15_Type u = perlinRemapQ15(tx);
+  const Q15_Type v = perlinRemapQ15(ty);
+  const Q15_Type w = perlinRemapQ15(tz);
+
+  // vectors going from the grid points to p, t - 1 being t - 32768 in Q15
+  const Q15_Type x0 = tx, x1 = static_cast<Q15_Type>(tx + INT16_MIN);
+  const Q15_Type y0 = ty, y1 = static_cast<Q15_Type>(ty + INT16_MIN);
+  const Q15_Type z0 = tz, z1 = static_cast<Q15_Type>(tz + INT16_MIN);
+
+  const std::int32_t h00 = hash(xi0, yi0), h10 = hash(xi1, yi0);
+  const std::int32_t h01 = hash(xi0, yi1), h11 = hash(xi1, yi1);
+
+  // linear interpolation of the dot products, in Q13
+  const Q15_Type a = lerpQ15(cornerDot(h00 + zi0, x0, y0, z0),
+                             cornerDot(h10 + zi0, x1, y0, z0), u);
+  const Q15_Type b = lerpQ15(cornerDot(h01 + zi0, x0, y1, z0),
+                             cornerDot(h11 + zi0, x1, y1, z0), u);
+  const Q15_Type c = lerpQ15(cornerDot(h00 + zi1, x0, y0, z1),
+                             cornerDot(h10 + zi1, x1, y0, z1), u);
+  const Q15_Type d = lerpQ15(cornerDot(h01 + zi1, x0, y1, z1),
+                             cornerDot(h11 + zi1, x1, y1, z1), u);
+
+  const Q15_Type e = lerpQ15(a, b, v);
+  const Q15_Type f = lerpQ15(c, d, v);
+
+  return saturateQ13(lerpQ15(e, f, w));
+}
+
+template <uint_least16_t Period, typename Engine>
+void FixedPerlinNoise3D<Period, Engine>::evalBatch(
+    const Fixed_Type *x, const Fixed_Type *y, const Fixed_Type *z,
+    const std::size_t count, Value_Type *out) const {
+  const bool done = simd::dispatch([&](auto kernels) {
+    kernels.fixedPerlin3D(permutationTable.data(), gradientsXY.data(),
+                          gradientsZ.data(), kTableSizeMask, x, y, z, count,
+                          out);
+  });
+  if (done) {
+    return;
+  }
+
+  for (std::size_t k = 0; k < count; ++k) {
+    out[k] = eval(Vec3_Type(x[k], y[k], z[k]));
+  }
+}
+
+} // namespace noise
+
+#endif // !FIXED_NOISE_IMPL_H
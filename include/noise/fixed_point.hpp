@@ -0,0 +1,87 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace noise {
+
+// Coordinates of the fixed point noises: Q16.16, i.e. x as round(x * 65536)
+// in an int32, the lattice cell in the high 16 bits and the position in the
+// cell in the low ones
+using Fixed_Type = std::int32_t;
+constexpr int kFixedFractionBits = 16;
+
+// Samples: Q15, i.e. v as round(v * 32768) in an int16, for v in [-1, 1)
+using Q15_Type = std::int16_t;
+
+inline Fixed_Type toFixed(const double x) {
+  return static_cast<Fixed_Type>(std::lround(x * (1 << kFixedFractionBits)));
+}
+
+inline float fromQ15(const Q15_Type v) {
+  return static_cast<float>(v) * (1.0f / 32768);
+}
+
+// a * b rounded to Q15, as pmulhrsw: (a * b + 2^14) >> 15
+constexpr Q15_Type mulQ15(const Q15_Type a, const Q15_Type b) {
+  return static_cast<Q15_Type>((std::int32_t{a} * b + 0x4000) >> 15);
+}
+
+// lo + (hi - lo) * t, hi - lo must fit Q15
+constexpr Q15_Type lerpQ15(const Q15_Type lo, const Q15_Type hi,
+                           const Q15_Type t) {
+  return static_cast<Q15_Type>(
+      lo + mulQ15(static_cast<Q15_Type>(hi - lo), t));
+}
+
+// a + b saturated to Q15, as paddsw
+constexpr Q15_Type addSaturateQ15(const Q15_Type a, const Q15_Type b) {
+  return static_cast<Q15_Type>(std::clamp(std::int32_t{a} + b,
+                                          std::int32_t{INT16_MIN},
+                                          std::int32_t{INT16_MAX}));
+}
+
+// Position in the cell of a Q16.16 coordinate, in Q15
+constexpr Q15_Type fixedFraction(const Fixed_Type x) {
+  return static_cast<Q15_Type>((x & 0xFFFF) >> 1);
+}
+
+// Lattice cell of a Q16.16 coordinate, the floor of x
+constexpr std::int32_t fixedCell(const Fixed_Type x) {
+  return x >> kFixedFractionBits;
+}
+
+// smoothstepRemap of t in [0, 1), in Q15. The cubic is expanded around
+// the middle of the cell, u = t - 1/2, as 1/2 + 3/2 u - 2 u^3: all its
+// terms fit Q15, while 3 t^2 does not. The last addition saturates, as
+// the remap of t just below 1 rounds to 1. Vector kernels evaluate the
+// same expression in int16 lanes, so the results are the same everywhere
+constexpr Q15_Type smoothstepRemapQ15(const Q15_Type t) {
+  const auto u = static_cast<Q15_Type>(t - 16384);
+  const Q15_Type u3 = mulQ15(mulQ15(u, u), u);
+  const auto inner = static_cast<Q15_Type>(u + mulQ15(u, 16384) - 2 * u3);
+  return addSaturateQ15(inner, 16384);
+}
+
+// perlinRemap in Q15, expanded the same way: 1/2 + 15/8 u - 5 u^3 + 6 u^5
+constexpr Q15_Type perlinRemapQ15(const Q15_Type t) {
+  const auto u = static_cast<Q15_Type>(t - 16384);
+  const Q15_Type u2 = mulQ15(u, u);
+  const Q15_Type u3 = mulQ15(u2, u);
+  const Q15_Type u5 = mulQ15(u3, u2);
+  const auto inner = static_cast<Q15_Type>(u + mulQ15(u, 28672) - 5 * u3 +
+                                           6 * u5);
+  return addSaturateQ15(inner, 16384);
+}
+
+// 4 v saturated to Q15, from the Q13 of the Perlin kernels
+constexpr Q15_Type saturateQ13(const Q15_Type v) {
+  const Q15_Type v2 = addSaturateQ15(v, v);
+  return addSaturateQ15(v2, v2);
+}
+
+} // namespace noise
+
+#endif // !FIXED_POINT_H
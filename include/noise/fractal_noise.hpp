@@ -0,0 +1,166 @@
+#ifndef FRACTAL_NOISE_H
+#define FRACTAL_NOISE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "noise/noise_range.hpp"
+#include "vec/vec2.hpp"
+#include "vec/vec3.hpp"
+
+namespace noise {
+
+// How every layer of a fractal sum is shaped before it is added
+enum class FractalMode {
+  FBm,        // amplitude * noise
+  Turbulence, // amplitude * |signed noise|
+  Ridged      // amplitude * (1 - |signed noise|)^2
+};
+
+// Fractal sum of Octaves layers of BaseNoise (ValueNoise1D, ValueNoiseND or
+// PerlinNoise3D). Layer o samples the noise at p * lacunarity^o + offset(o)
+// with an amplitude of gain^o. The layer loop is unrolled at compile time.
+// The offsets decorrelate the lattices of the layers, which would otherwise
+// all have a lattice point at the origin
+template <typename BaseNoise, uint_least8_t Octaves,
+          FractalMode Mode = FractalMode::FBm>
+class FractalNoise {
+public:
+  static_assert(Octaves >= 1, "A fractal sum needs at least one octave");
+
+  using Result_Type = typename BaseNoise::Value_Type;
+  using Value_Type = Result_Type;
+  using Vec2_Type = typename vector::Vec2<Result_Type>;
+  using Vec3_Type = typename vector::Vec3<Result_Type>;
+
+  static constexpr bool kSignedOutput =
+      Mode == FractalMode::FBm && BaseNoise::kSignedOutput;
+
+  static constexpr FractalMode kMode = Mode;
+  static constexpr std::size_t kOctaves = Octaves;
+
+  FractalNoise(const BaseNoise &noise = BaseNoise(),
+               const Result_Type lacunarity = 2, const Result_Type gain = 0.5);
+
+  Result_Type eval(const Result_Type x) const;
+
+  Result_Type eval(const Vec2_Type &p) const;
+
+  Result_Type eval(const Vec3_Type &p) const;
+
+  // Evaluation with the analytic gradient of the sum, returned through
+  // deriv, from the derivative evaluations of the base noise: the layer
+  // gradients are scaled by amplitude * frequency and the slope of the
+  // layer shaping. The value is the one of the overload without deriv.
+  // Turbulence and ridges have a crease where the layer crosses its center,
+  // the derivative is the one of the side the sample is on
+  Result_Type eval(const Vec2_Type &p, Vec2_Type &deriv) const;
+
+  Result_Type eval(const Vec3_Type &p, Vec3_Type &deriv) const;
+
+  // Same contract as the evalGrid of the base noise. Each layer is produced
+  // by chunks of rows through the evalGrid of the base noise, sampling the
+  // layer grid origin * f + offset, step * f. This matches eval up to the
+  // rounding of the sample coordinates
+  void evalGrid(const Vec2_Type &origin, const Result_Type step,
+                const std::size_t width, const std::size_t height,
+                Result_Type *out, const std::size_t stride,
+                const std::size_t column = 0, const std::size_t row = 0) const;
+
+  void evalGrid(const Vec3_Type &origin, const Result_Type step,
+                const std::size_t width, const std::size_t height,
+                Result_Type *out, const std::size_t stride,
+                const std::size_t column = 0, const std::size_t row = 0) const;
+
+  // Same contract as the evalBatch of the base noise. The coordinates of a
+  // layer are scaled in vectorizable loops and fed to the batch kernels of
+  // the base noise, chunk by chunk. Matches eval bit for bit
+  void evalBatch(const Result_Type *x, const std::size_t count,
+                 Result_Type *out) const;
+
+  void evalBatch(const Result_Type *x, const Result_Type *y,
+                 const std::size_t count, Result_Type *out) const;
+
+  void evalBatch(const Result_Type *x, const Result_Type *y,
+                 const Result_Type *z, const std::size_t count,
+                 Result_Type *out) const;
+
+  // Bounds of the sum for samples with dimension coordinates, from the
+  // bounds of the base noise, the layer shaping and the amplitudes. Loose
+  // for deep sums, whose layers rarely all peak at the same point
+  Range<Result_Type> outputRange(const unsigned dimension) const;
+
+  const BaseNoise &base() const { return noise; }
+
+  Result_Type frequency(const std::size_t octave) const {
+    return frequencies[octave];
+  }
+
+  Result_Type amplitude(const std::size_t octave) const {
+    return amplitudes[octave];
+  }
+
+  const Vec3_Type &offset(const std::size_t octave) const {
+    return offsets[octave];
+  }
+
+  // Only the components matching the dimension of the samples are used
+  void setOffset(const std::size_t octave, const Vec3_Type &offset) {
+    offsets[octave] = offset;
+  }
+
+private:
+  // Samples per chunk of evalBatch, the scratch arrays live on the stack
+  static constexpr std::size_t kBatchChunk = 256;
+
+  // Samples per chunk of a row of evalGrid, also on the stack
+  static constexpr std::size_t kGridChunk = 256;
+
+  // Layer shaping, see FractalMode
+  static Result_Type shape(const Result_Type v);
+
+  // Slope of shape at v
+  static Result_Type shapeDeriv(const Result_Type v);
+
+  // Bounds of shape(v) for v in range
+  static Range<Result_Type> shapeRange(const Range<Result_Type> &range);
+
+  template <std::size_t... O, typename P>
+  Result_Type evalOctaves(const P &p, std::index_sequence<O...>) const;
+
+  // Same fold, with the layers adding their gradients to deriv
+  template <std::size_t... O, typename P>
+  Result_Type evalOctaves(const P &p, P &deriv,
+                          std::index_sequence<O...>) const;
+
+  template <std::size_t O> Result_Type octave(const Result_Type x) const;
+  template <std::size_t O> Result_Type octave(const Vec2_Type &p) const;
+  template <std::size_t O> Result_Type octave(const Vec3_Type &p) const;
+  template <std::size_t O>
+  Result_Type octave(const Vec2_Type &p, Vec2_Type &deriv) const;
+  template <std::size_t O>
+  Result_Type octave(const Vec3_Type &p, Vec3_Type &deriv) const;
+
+  template <typename Vec_Type>
+  void evalGridRows(const Vec_Type &origin, const Result_Type step,
+                    const std::size_t width, const std::size_t height,
+                    Result_Type *out, const std::size_t stride,
+                    const std::size_t column, const std::size_t row) const;
+
+  template <std::size_t Dimension>
+  void evalBatchChunks(const Result_Type *const (&p)[Dimension],
+                       const std::size_t count, Result_Type *out) const;
+
+  BaseNoise noise;
+  std::array<Result_Type, Octaves> frequencies{};
+  std::array<Result_Type, Octaves> amplitudes{};
+  std::array<Vec3_Type, Octaves> offsets{};
+};
+
+} // namespace noise
+
+#include "noise/fractal_noise_impl.hpp"
+
+#endif // !FRACTAL_NOISE_H
@@ -0,0 +1,358 @@
+#ifndef FRACTAL_NOISE_IMPL_H
+#define FRACTAL_NOISE_IMPL_H
+
+#include <cmath>
+#include <type_traits>
+
+#include "noise/fractal_noise.hpp"
+
+namespace noise {
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+FractalNoise<BaseNoise, Octaves, Mode>::FractalNoise(
+    const BaseNoise &noise, const Result_Type lacunarity,
+    const Result_Type gain)
+    : noise(noise) {
+  Result_Type frequency = 1;
+  Result_Type amplitude = 1;
+  for (std::size_t o = 0; o < Octaves; ++o) {
+    frequencies[o] = frequency;
+    amplitudes[o] = amplitude;
+    frequency *= lacunarity;
+    amplitude *= gain;
+
+    // Fractional multiples of irrational steps, so no two layers share a
+    // lattice point near the origin. The first layer is left in place
+    const Result_Type k = static_cast<Result_Type>(o);
+    offsets[o] = Vec3_Type(k * static_cast<Result_Type>(61.803398875),
+                           k * static_cast<Result_Type>(75.487766625),
+                           k * static_cast<Result_Type>(56.984029099));
+  }
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+typename FractalNoise<BaseNoise, Octaves, Mode>::Result_Type
+FractalNoise<BaseNoise, Octaves, Mode>::shape(const Result_Type v) {
+  if constexpr (Mode == FractalMode::FBm) {
+    return v;
+  } else {
+    // Turbulence and ridges fold the noise around its center
+    const Result_Type s = BaseNoise::kSignedOutput ? v : 2 * v - 1;
+    const Result_Type a = std::fabs(s);
+    if constexpr (Mode == FractalMode::Turbulence) {
+      return a;
+    } else {
+      const Result_Type ridge = 1 - a;
+      return ridge * ridge;
+    }
+  }
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+typename FractalNoise<BaseNoise, Octaves, Mode>::Result_Type
+FractalNoise<BaseNoise, Octaves, Mode>::shapeDeriv(const Result_Type v) {
+  if constexpr (Mode == FractalMode::FBm) {
+    return 1;
+  } else {
+    const Result_Type ds = BaseNoise::kSignedOutput ? 1 : 2;
+    const Result_Type s = BaseNoise::kSignedOutput ? v : 2 * v - 1;
+    const Result_Type sign = static_cast<Result_Type>((s > 0) - (s < 0));
+    if constexpr (Mode == FractalMode::Turbulence) {
+      return sign * ds;
+    } else {
+      return -2 * (1 - std::fabs(s)) * sign * ds;
+    }
+  }
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+Range<typename FractalNoise<BaseNoise, Octaves, Mode>::Result_Type>
+FractalNoise<BaseNoise, Octaves, Mode>::shapeRange(
+    const Range<Result_Type> &range) {
+  if constexpr (Mode == FractalMode::FBm) {
+    return range;
+  } else {
+    const Range<Result_Type> s =
+        BaseNoise::kSignedOutput
+            ? range
+            : Range<Result_Type>{2 * range.min - 1, 2 * range.max - 1};
+    const Result_Type maxAbs = std::fmax(std::fabs(s.min), std::fabs(s.max));
+    const Result_Type minAbs =
+        s.min <= 0 && s.max >= 0 ? 0
+                                 : std::fmin(std::fabs(s.min), std::fabs(s.max));
+    if constexpr (Mode == FractalMode::Turbulence) {
+      return Range<Result_Type>{minAbs, maxAbs};
+    } else {
+      // (1 - a)^2 is convex in a and vanishes at a = 1
+      const Result_Type low = (1 - minAbs) * (1 - minAbs);
+      const Result_Type high = (1 - maxAbs) * (1 - maxAbs);
+      const Result_Type least =
+          minAbs <= 1 && maxAbs >= 1 ? 0 : std::fmin(low, high);
+      return Range<Result_Type>{least, std::fmax(low, high)};
+    }
+  }
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+Range<typename FractalNoise<BaseNoise, Octaves, Mode>::Result_Type>
+FractalNoise<BaseNoise, Octaves, Mode>::outputRange(
+    const unsigned dimension) const {
+  const Range<Result_Type> layer = shapeRange(noise.outputRange(dimension));
+
+  Range<Result_Type> sum{0, 0};
+  for (std::size_t o = 0; o < Octaves; ++o) {
+    const Result_Type a = amplitudes[o] * layer.min;
+    const Result_Type b = amplitudes[o] * layer.max;
+    sum.min += std::fmin(a, b);
+    sum.max += std::fmax(a, b);
+  }
+  return sum;
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+template <std::size_t... O, typename P>
+typename FractalNoise<BaseNoise, Octaves, Mode>::Result_Type
+FractalNoise<BaseNoise, Octaves, Mode>::evalOctaves(
+    const P &p, std::index_sequence<O...>) const {
+  // Left to right fold, the same summation order as a plain loop
+  Result_Type sum = 0;
+  ((sum += octave<O>(p)), ...);
+  return sum;
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+template <std::size_t... O, typename P>
+typename FractalNoise<BaseNoise, Octaves, Mode>::Result_Type
+FractalNoise<BaseNoise, Octaves, Mode>::evalOctaves(
+    const P &p, P &deriv, std::index_sequence<O...>) const {
+  deriv = P();
+  Result_Type sum = 0;
+  ((sum += octave<O>(p, deriv)), ...);
+  return sum;
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+template <std::size_t O>
+typename FractalNoise<BaseNoise, Octaves, Mode>::Result_Type
+FractalNoise<BaseNoise, Octaves, Mode>::octave(const Result_Type x) const {
+  const Result_Type px = x * frequencies[O] + offsets[O].x;
+  return shape(noise.eval(px)) * amplitudes[O];
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+template <std::size_t O>
+typename FractalNoise<BaseNoise, Octaves, Mode>::Result_Type
+FractalNoise<BaseNoise, Octaves, Mode>::octave(const Vec2_Type &p) const {
+  const Vec2_Type po(p.x * frequencies[O] + offsets[O].x,
+                     p.y * frequencies[O] + offsets[O].y);
+  return shape(noise.eval(po)) * amplitudes[O];
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+template <std::size_t O>
+typename FractalNoise<BaseNoise, Octaves, Mode>::Result_Type
+FractalNoise<BaseNoise, Octaves, Mode>::octave(const Vec3_Type &p) const {
+  const Vec3_Type po(p.x * frequencies[O] + offsets[O].x,
+                     p.y * frequencies[O] + offsets[O].y,
+                     p.z * frequencies[O] + offsets[O].z);
+  return shape(noise.eval(po)) * amplitudes[O];
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+template <std::size_t O>
+typename FractalNoise<BaseNoise, Octaves, Mode>::Result_Type
+FractalNoise<BaseNoise, Octaves, Mode>::octave(const Vec2_Type &p,
+                                               Vec2_Type &deriv) const {
+  const Vec2_Type po(p.x * frequencies[O] + offsets[O].x,
+                     p.y * frequencies[O] + offsets[O].y);
+  Vec2_Type d;
+  const Result_Type v = noise.eval(po, d);
+  // Chain rule through the layer frequency and shaping
+  const Result_Type slope = shapeDeriv(v) * amplitudes[O] * frequencies[O];
+  deriv.x += d.x * slope;
+  deriv.y += d.y * slope;
+  return shape(v) * amplitudes[O];
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+template <std::size_t O>
+typename FractalNoise<BaseNoise, Octaves, Mode>::Result_Type
+FractalNoise<BaseNoise, Octaves, Mode>::octave(const Vec3_Type &p,
+                                               Vec3_Type &deriv) const {
+  const Vec3_Type po(p.x * frequencies[O] + offsets[O].x,
+                     p.y * frequencies[O] + offsets[O].y,
+                     p.z * frequencies[O] + offsets[O].z);
+  Vec3_Type d;
+  const Result_Type v = noise.eval(po, d);
+  const Result_Type slope = shapeDeriv(v) * amplitudes[O] * frequencies[O];
+  deriv.x += d.x * slope;
+  deriv.y += d.y * slope;
+  deriv.z += d.z * slope;
+  return shape(v) * amplitudes[O];
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+typename FractalNoise<BaseNoise, Octaves, Mode>::Result_Type
+FractalNoise<BaseNoise, Octaves, Mode>::eval(const Result_Type x) const {
+  return evalOctaves(x, std::make_index_sequence<Octaves>{});
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+typename FractalNoise<BaseNoise, Octaves, Mode>::Result_Type
+FractalNoise<BaseNoise, Octaves, Mode>::eval(const Vec2_Type &p) const {
+  return evalOctaves(p, std::make_index_sequence<Octaves>{});
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+typename FractalNoise<BaseNoise, Octaves, Mode>::Result_Type
+FractalNoise<BaseNoise, Octaves, Mode>::eval(const Vec3_Type &p) const {
+  return evalOctaves(p, std::make_index_sequence<Octaves>{});
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+typename FractalNoise<BaseNoise, Octaves, Mode>::Result_Type
+FractalNoise<BaseNoise, Octaves, Mode>::eval(const Vec2_Type &p,
+                                             Vec2_Type &deriv) const {
+  return evalOctaves(p, deriv, std::make_index_sequence<Octaves>{});
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+typename FractalNoise<BaseNoise, Octaves, Mode>::Result_Type
+FractalNoise<BaseNoise, Octaves, Mode>::eval(const Vec3_Type &p,
+                                             Vec3_Type &deriv) const {
+  return evalOctaves(p, deriv, std::make_index_sequence<Octaves>{});
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+template <typename Vec_Type>
+void FractalNoise<BaseNoise, Octaves, Mode>::evalGridRows(
+    const Vec_Type &origin, const Result_Type step, const std::size_t width,
+    const std::size_t height, Result_Type *out, const std::size_t stride,
+    const std::size_t column, const std::size_t row) const {
+  // Grid of each layer
+  Vec_Type layerOrigins[Octaves];
+  for (std::size_t o = 0; o < Octaves; ++o) {
+    layerOrigins[o] = origin * frequencies[o];
+    layerOrigins[o].x += offsets[o].x;
+    layerOrigins[o].y += offsets[o].y;
+    if constexpr (std::is_same_v<Vec_Type, Vec3_Type>) {
+      layerOrigins[o].z += offsets[o].z;
+    }
+  }
+
+  // One chunk of a row of one layer at a time, in a scratch array on the
+  // stack that stays in L1
+  Result_Type layer[kGridChunk];
+
+  for (std::size_t j = 0; j < height; ++j) {
+    for (std::size_t first = 0; first < width; first += kGridChunk) {
+      const std::size_t n =
+          width - first < kGridChunk ? width - first : kGridChunk;
+      Result_Type *dst = out + j * stride + first;
+
+      for (std::size_t o = 0; o < Octaves; ++o) {
+        noise.evalGrid(layerOrigins[o], step * frequencies[o], n, 1, layer,
+                       n, column + first, row + j);
+
+        const Result_Type amplitude = amplitudes[o];
+        if (o == 0) {
+          for (std::size_t i = 0; i < n; ++i) {
+            dst[i] = shape(layer[i]) * amplitude;
+          }
+        } else {
+          for (std::size_t i = 0; i < n; ++i) {
+            dst[i] += shape(layer[i]) * amplitude;
+          }
+        }
+      }
+    }
+  }
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+void FractalNoise<BaseNoise, Octaves, Mode>::evalGrid(
+    const Vec2_Type &origin, const Result_Type step, const std::size_t width,
+    const std::size_t height, Result_Type *out, const std::size_t stride,
+    const std::size_t column, const std::size_t row) const {
+  evalGridRows(origin, step, width, height, out, stride, column, row);
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+void FractalNoise<BaseNoise, Octaves, Mode>::evalGrid(
+    const Vec3_Type &origin, const Result_Type step, const std::size_t width,
+    const std::size_t height, Result_Type *out, const std::size_t stride,
+    const std::size_t column, const std::size_t row) const {
+  evalGridRows(origin, step, width, height, out, stride, column, row);
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+template <std::size_t Dimension>
+void FractalNoise<BaseNoise, Octaves, Mode>::evalBatchChunks(
+    const Result_Type *const (&p)[Dimension], const std::size_t count,
+    Result_Type *out) const {
+  Result_Type scaled[Dimension][kBatchChunk];
+  Result_Type layer[kBatchChunk];
+
+  for (std::size_t first = 0; first < count; first += kBatchChunk) {
+    const std::size_t n =
+        count - first < kBatchChunk ? count - first : kBatchChunk;
+    Result_Type *dst = out + first;
+
+    for (std::size_t o = 0; o < Octaves; ++o) {
+      const Result_Type frequency = frequencies[o];
+      const Result_Type offset[3] = {offsets[o].x, offsets[o].y, offsets[o].z};
+      for (std::size_t d = 0; d < Dimension; ++d) {
+        const Result_Type *src = p[d] + first;
+        for (std::size_t k = 0; k < n; ++k) {
+          scaled[d][k] = src[k] * frequency + offset[d];
+        }
+      }
+
+      if constexpr (Dimension == 1) {
+        noise.evalBatch(scaled[0], n, layer);
+      } else if constexpr (Dimension == 2) {
+        noise.evalBatch(scaled[0], scaled[1], n, layer);
+      } else {
+        noise.evalBatch(scaled[0], scaled[1], scaled[2], n, layer);
+      }
+
+      const Result_Type amplitude = amplitudes[o];
+      if (o == 0) {
+        for (std::size_t k = 0; k < n; ++k) {
+          dst[k] = shape(layer[k]) * amplitude;
+        }
+      } else {
+        for (std::size_t k = 0; k < n; ++k) {
+          dst[k] += shape(layer[k]) * amplitude;
+        }
+      }
+    }
+  }
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+void FractalNoise<BaseNoise, Octaves, Mode>::evalBatch(
+    const Result_Type *x, const std::size_t count, Result_Type *out) const {
+  const Result_Type *const p[1] = {x};
+  evalBatchChunks(p, count, out);
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+void FractalNoise<BaseNoise, Octaves, Mode>::evalBatch(
+    const Result_Type *x, const Result_Type *y, const std::size_t count,
+    Result_Type *out) const {
+  const Result_Type *const p[2] = {x, y};
+  evalBatchChunks(p, count, out);
+}
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode>
+void FractalNoise<BaseNoise, Octaves, Mode>::evalBatch(
+    const Result_Type *x, const Result_Type *y, const Result_Type *z,
+    const std::size_t count, Result_Type *out) const {
+  const Result_Type *const p[3] = {x, y, z};
+  evalBatchChunks(p, count, out);
+}
+
+} // namespace noise
+
+#endif // !FRACTAL_NOISE_IMPL_H
@@ -0,0 +1,152 @@
+#ifndef LARGE_WORLD_H
+#define LARGE_WORLD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "noise/fractal_noise.hpp"
+#include "vec/vec2.hpp"
+#include "vec/vec3.hpp"
+
+namespace noise {
+
+// Lattice cells of a world too large for float coordinates, e.g. the
+// integer origin of a chunk. Positions are such a cell plus a float offset
+using WorldCell2 = vector::Vec2<std::int64_t>;
+using WorldCell3 = vector::Vec3<std::int64_t>;
+
+// Period of the lattice of Noise along every axis (its kPeriod), 0 for the
+// noises whose lattice does not wrap
+template <typename Noise, typename = void>
+struct LatticePeriod : std::integral_constant<std::size_t, 0> {};
+
+template <typename Noise>
+struct LatticePeriod<Noise, std::void_t<decltype(Noise::kPeriod)>>
+    : std::integral_constant<std::size_t, Noise::kPeriod> {};
+
+// Whether the lattice of Noise can be moved to a world cell, i.e. Noise has
+// shiftLatticeOrigin (the hashed layout of ValueNoiseND and PerlinNoise3D)
+template <typename Noise, typename = void>
+struct ShiftableLattice : std::false_type {};
+
+template <typename Noise>
+struct ShiftableLattice<
+    Noise, std::void_t<decltype(std::declval<Noise &>().shiftLatticeOrigin(
+               std::size_t{0}, std::int64_t{0}))>> : std::true_type {};
+
+// cell * scale modulo period (a power of 2), in [0, period). The product is
+// computed exactly in integer arithmetic, from the mantissa and exponent of
+// scale (positive), for any cell: the only error is the final rounding to
+// T. A lattice of this period sees the same point at the result as at cell
+// * scale
+template <typename T>
+T wrapWorldCoordinate(const std::int64_t cell, const T scale,
+                      const std::size_t period);
+
+// Noise (ValueNoiseND, PerlinNoise3D...) seen from the world cell origin:
+// eval(p) is noise at origin + p, for float offsets p. Since the lattice of
+// the noise wraps, origin is replaced by its remainder modulo the period,
+// and the offsets stay within a few periods of 0 however far origin is:
+// samples keep the precision they have near 0, with all the float paths of
+// the noise (evalGrid and the vector kernels of evalBatch). Holds a
+// reference to noise.
+//
+// A hashed lattice does not wrap, its hash is moved instead: RebasedNoise
+// holds a copy of noise whose lattice starts at origin (shiftLatticeOrigin),
+// and the offsets are not shifted at all. The hash takes the cells modulo
+// 2^32, so that lattice repeats every 2^32 cells
+template <typename Noise> class RebasedNoise {
+public:
+  using Value_Type = typename Noise::Value_Type;
+  using Result_Type = Value_Type;
+  using Vec2_Type = typename vector::Vec2<Result_Type>;
+  using Vec3_Type = typename vector::Vec3<Result_Type>;
+
+  static constexpr bool kSignedOutput = Noise::kSignedOutput;
+  static constexpr std::size_t kPeriod = LatticePeriod<Noise>::value;
+
+  static_assert(kPeriod != 0 || ShiftableLattice<Noise>::value,
+                "The lattice of the noise must wrap or be hashed");
+
+  RebasedNoise(const Noise &noise, const WorldCell2 &origin);
+  RebasedNoise(const Noise &noise, const WorldCell3 &origin);
+
+  Result_Type eval(const Vec2_Type &p) const;
+  Result_Type eval(const Vec3_Type &p) const;
+
+  // Same contracts as the evalGrid and evalBatch of Noise, origin and the
+  // samples being offsets from the world origin. evalBatch shifts the
+  // coordinates chunk by chunk on the stack
+  void evalGrid(const Vec2_Type &origin, const Result_Type step,
+                const std::size_t width, const std::size_t height,
+                Result_Type *out, const std::size_t stride,
+                const std::size_t column = 0, const std::size_t row = 0) const;
+
+  void evalGrid(const Vec3_Type &origin, const Result_Type step,
+                const std::size_t width, const std::size_t height,
+                Result_Type *out, const std::size_t stride,
+                const std::size_t column = 0, const std::size_t row = 0) const;
+
+  void evalBatch(const Result_Type *x, const Result_Type *y,
+                 const std::size_t count, Result_Type *out) const;
+
+  void evalBatch(const Result_Type *x, const Result_Type *y,
+                 const Result_Type *z, const std::size_t count,
+                 Result_Type *out) const;
+
+  // The world origin, wrapped: what is added to the offsets. 0 for a hashed
+  // lattice
+  const Vec3_Type &shift() const { return originShift; }
+
+private:
+  static constexpr bool kHashed = kPeriod == 0;
+
+  // noise, or its copy moved to origin for a hashed lattice
+  static std::conditional_t<kHashed, Noise, const Noise *>
+  hold(const Noise &noise, const WorldCell3 &origin);
+  static Vec3_Type wrapOrigin(const WorldCell3 &origin);
+
+  const Noise &base() const {
+    if constexpr (kHashed) {
+      return noise;
+    } else {
+      return *noise;
+    }
+  }
+
+  // Samples per chunk of evalBatch, the scratch arrays live on the stack
+  static constexpr std::size_t kBatchChunk = 256;
+
+  template <std::size_t Dimension>
+  void evalBatchChunks(const Result_Type *const (&p)[Dimension],
+                       const std::size_t count, Result_Type *out) const;
+
+  std::conditional_t<kHashed, Noise, const Noise *> noise;
+  Vec3_Type originShift;
+};
+
+// noise seen from the world cell origin, see RebasedNoise
+template <typename Noise, typename Cell>
+RebasedNoise<Noise> rebase(const Noise &noise, const Cell &origin) {
+  return RebasedNoise<Noise>(noise, origin);
+}
+
+// A fractal sum seen from the world cell origin: a copy of noise whose
+// layer offsets hold origin * frequency, wrapped layer by layer, so that it
+// evaluates origin + p at p. Non integer lacunarities are fine, the layer
+// lattices are wrapped exactly. The copy holds the base noise, rebase it
+// once per chunk rather than per sample. The base noise must wrap: the
+// layers share its lattice at different frequencies
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode,
+          typename Cell>
+FractalNoise<BaseNoise, Octaves, Mode>
+rebase(const FractalNoise<BaseNoise, Octaves, Mode> &noise,
+       const Cell &origin);
+
+} // namespace noise
+
+#include "noise/large_world_impl.hpp"
+
+#endif // !LARGE_WORLD_H
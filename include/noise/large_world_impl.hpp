@@ -0,0 +1,263 @@
+#ifndef LARGE_WORLD_IMPL_H
+#define LARGE_WORLD_IMPL_H
+
+#include "noise/large_world.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace noise {
+
+namespace detail {
+
+// 128 bits two's complement integer
+struct WideProduct {
+  std::uint64_t hi, lo;
+};
+
+// cell * m in 128 bits, from 32 bits halves
+inline WideProduct wideProduct(const std::int64_t cell,
+                               const std::uint64_t m) {
+  constexpr std::uint64_t kLow = 0xFFFFFFFF;
+  const std::uint64_t c = static_cast<std::uint64_t>(cell);
+  const std::uint64_t ll = (c & kLow) * (m & kLow);
+  const std::uint64_t lh = (c & kLow) * (m >> 32);
+  const std::uint64_t hl = (c >> 32) * (m & kLow);
+  const std::uint64_t hh = (c >> 32) * (m >> 32);
+  const std::uint64_t mid = (ll >> 32) + (lh & kLow) + (hl & kLow);
+
+  WideProduct product;
+  product.lo = (mid << 32) | (ll & kLow);
+  product.hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+  // c is cell + 2^64 for a negative cell
+  if (cell < 0) {
+    product.hi -= m;
+  }
+  return product;
+}
+
+// Bits shift to shift + 63 of v, for shift below 128
+inline std::uint64_t wideBits(const WideProduct &v, const int shift) {
+  if (shift == 0) {
+    return v.lo;
+  }
+  if (shift < 64) {
+    return (v.lo >> shift) | (v.hi << (64 - shift));
+  }
+  return v.hi >> (shift - 64);
+}
+
+} // namespace detail
+
+template <typename T>
+T wrapWorldCoordinate(const std::int64_t cell, const T scale,
+                      const std::size_t period) {
+  assert(scale > 0 && period != 0 && !(period & (period - 1)) &&
+         "The scale must be positive, the period a power of 2");
+  const std::uint64_t mask = period - 1;
+  const T wrap = static_cast<T>(period);
+
+  // scale = m / 2^shift, m an integer of the digits of T
+  constexpr int kDigits = std::numeric_limits<T>::digits;
+  int exponent;
+  const T mantissa = std::frexp(scale, &exponent);
+  const auto m = static_cast<std::uint64_t>(std::ldexp(mantissa, kDigits));
+  const int shift = kDigits - exponent;
+
+  if (shift <= 0) {
+    // An integer scale, the product wraps modulo 2^64 as well as period
+    if (shift <= -64) {
+      return 0;
+    }
+    const std::uint64_t product = static_cast<std::uint64_t>(cell) * m;
+    return static_cast<T>((product << -shift) & mask);
+  }
+  if (shift >= 64 + kDigits) {
+    // |cell * scale| is below 2^(63 + kDigits - shift), i.e. below 1/2
+    const T v = static_cast<T>(cell) * scale;
+    return v < 0 ? std::fmod(v + wrap, wrap) : v;
+  }
+
+  const detail::WideProduct product = detail::wideProduct(cell, m);
+  const std::uint64_t integer = detail::wideBits(product, shift) & mask;
+  // The bits below the point, in the 64 high bits of fraction
+  const std::uint64_t fraction = shift >= 64
+                                     ? detail::wideBits(product, shift - 64)
+                                     : product.lo << (64 - shift);
+
+  const T v = static_cast<T>(integer) +
+              static_cast<T>(std::ldexp(static_cast<double>(fraction), -64));
+  // The fraction may round up to 1, past the last cell
+  return v >= wrap ? v - wrap : v;
+}
+
+// RebasedNoise
+
+template <typename Noise>
+std::conditional_t<RebasedNoise<Noise>::kHashed, Noise, const Noise *>
+RebasedNoise<Noise>::hold(const Noise &noise, const WorldCell3 &origin) {
+  if constexpr (kHashed) {
+    Noise moved = noise;
+    moved.shiftLatticeOrigin(0, origin.x);
+    moved.shiftLatticeOrigin(1, origin.y);
+    moved.shiftLatticeOrigin(2, origin.z);
+    return moved;
+  } else {
+    return &noise;
+  }
+}
+
+template <typename Noise>
+typename RebasedNoise<Noise>::Vec3_Type
+RebasedNoise<Noise>::wrapOrigin(const WorldCell3 &origin) {
+  if constexpr (kHashed) {
+    return Vec3_Type();
+  } else {
+    return Vec3_Type(wrapWorldCoordinate(origin.x, Result_Type(1), kPeriod),
+                     wrapWorldCoordinate(origin.y, Result_Type(1), kPeriod),
+                     wrapWorldCoordinate(origin.z, Result_Type(1), kPeriod));
+  }
+}
+
+template <typename Noise>
+RebasedNoise<Noise>::RebasedNoise(const Noise &noise, const WorldCell2 &origin)
+    : RebasedNoise(noise, WorldCell3(origin.x, origin.y, 0)) {}
+
+template <typename Noise>
+RebasedNoise<Noise>::RebasedNoise(const Noise &noise, const WorldCell3 &origin)
+    : noise(hold(noise, origin)), originShift(wrapOrigin(origin)) {}
+
+template <typename Noise>
+typename RebasedNoise<Noise>::Result_Type
+RebasedNoise<Noise>::eval(const Vec2_Type &p) const {
+  return base().eval(Vec2_Type(p.x + originShift.x, p.y + originShift.y));
+}
+
+template <typename Noise>
+typename RebasedNoise<Noise>::Result_Type
+RebasedNoise<Noise>::eval(const Vec3_Type &p) const {
+  return base().eval(Vec3_Type(p.x + originShift.x, p.y + originShift.y,
+                               p.z + originShift.z));
+}
+
+template <typename Noise>
+void RebasedNoise<Noise>::evalGrid(const Vec2_Type &origin,
+                                   const Result_Type step,
+                                   const std::size_t width,
+                                   const std::size_t height, Result_Type *out,
+                                   const std::size_t stride,
+                                   const std::size_t column,
+                                   const std::size_t row) const {
+  base().evalGrid(
+      Vec2_Type(origin.x + originShift.x, origin.y + originShift.y), step,
+      width, height, out, stride, column, row);
+}
+
+template <typename Noise>
+void RebasedNoise<Noise>::evalGrid(const Vec3_Type &origin,
+                                   const Result_Type step,
+                                   const std::size_t width,
+                                   const std::size_t height, Result_Type *out,
+                                   const std::size_t stride,
+                                   const std::size_t column,
+                                   const std::size_t row) const {
+  base().evalGrid(Vec3_Type(origin.x + originShift.x,
+                            origin.y + originShift.y,
+                            origin.z + originShift.z),
+                  step, width, height, out, stride, column, row);
+}
+
+template <typename Noise>
+template <std::size_t Dimension>
+void RebasedNoise<Noise>::evalBatchChunks(
+    const Result_Type *const (&p)[Dimension], const std::size_t count,
+    Result_Type *out) const {
+  if constexpr (kHashed) {
+    // Nothing to shift
+    if constexpr (Dimension == 2) {
+      base().evalBatch(p[0], p[1], count, out);
+    } else {
+      base().evalBatch(p[0], p[1], p[2], count, out);
+    }
+    return;
+  }
+
+  const Result_Type shifts[3] = {originShift.x, originShift.y, originShift.z};
+  Result_Type shifted[Dimension][kBatchChunk];
+
+  for (std::size_t first = 0; first < count; first += kBatchChunk) {
+    const std::size_t n = std::min(kBatchChunk, count - first);
+    for (std::size_t d = 0; d < Dimension; ++d) {
+      for (std::size_t k = 0; k < n; ++k) {
+        shifted[d][k] = p[d][first + k] + shifts[d];
+      }
+    }
+    if constexpr (Dimension == 2) {
+      base().evalBatch(shifted[0], shifted[1], n, out + first);
+    } else {
+      base().evalBatch(shifted[0], shifted[1], shifted[2], n, out + first);
+    }
+  }
+}
+
+template <typename Noise>
+void RebasedNoise<Noise>::evalBatch(const Result_Type *x,
+                                    const Result_Type *y,
+                                    const std::size_t count,
+                                    Result_Type *out) const {
+  const Result_Type *const p[2] = {x, y};
+  evalBatchChunks(p, count, out);
+}
+
+template <typename Noise>
+void RebasedNoise<Noise>::evalBatch(const Result_Type *x,
+                                    const Result_Type *y,
+                                    const Result_Type *z,
+                                    const std::size_t count,
+                                    Result_Type *out) const {
+  const Result_Type *const p[3] = {x, y, z};
+  evalBatchChunks(p, count, out);
+}
+
+// FractalNoise
+
+template <typename BaseNoise, uint_least8_t Octaves, FractalMode Mode,
+          typename Cell>
+FractalNoise<BaseNoise, Octaves, Mode>
+rebase(const FractalNoise<BaseNoise, Octaves, Mode> &noise,
+       const Cell &origin) {
+  using Fractal = FractalNoise<BaseNoise, Octaves, Mode>;
+  using Result_Type = typename Fractal::Result_Type;
+  constexpr std::size_t kPeriod = LatticePeriod<BaseNoise>::value;
+  static_assert(kPeriod != 0,
+                "The lattice of the base noise must wrap (not a hashed "
+                "layout)");
+  constexpr auto wrap = static_cast<Result_Type>(kPeriod);
+
+  // Layer o samples p * f + offset: origin * f goes in the offset, both
+  // wrapped
+  Fractal rebased = noise;
+  for (std::size_t o = 0; o < Octaves; ++o) {
+    const Result_Type f = noise.frequency(o);
+    const auto layer = [&](const std::int64_t cell, const Result_Type offset) {
+      Result_Type v = std::fmod(offset, wrap);
+      v += wrapWorldCoordinate(cell, f, kPeriod) + (v < 0 ? wrap : 0);
+      return v >= wrap ? v - wrap : v;
+    };
+
+    typename Fractal::Vec3_Type offset = noise.offset(o);
+    offset.x = layer(origin.x, offset.x);
+    offset.y = layer(origin.y, offset.y);
+    if constexpr (std::is_same_v<Cell, WorldCell3>) {
+      offset.z = layer(origin.z, offset.z);
+    }
+    rebased.setOffset(o, offset);
+  }
+  return rebased;
+}
+
+} // namespace noise
+
+#endif // !LARGE_WORLD_IMPL_H
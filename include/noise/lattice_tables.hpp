@@ -0,0 +1,309 @@
+#ifndef LATTICE_TABLES_H
+#define LATTICE_TABLES_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+
+#include "utils/constexpr_random.hpp"
+#include "vec/vec3.hpp"
+
+namespace noise {
+
+// Memory layout of the lattice tables of ValueNoiseND and PerlinNoise3D
+enum class TableLayout {
+  // Conv_Type indices, a permutation table of 2 * Period entries so that
+  // perm[perm[x] + y] needs no wrapping, float gradients. These are the
+  // layouts the batch kernels read, and the ones the outputs were always
+  // produced with
+  Wide,
+  // The narrowest index type that holds Period - 1, a permutation table of
+  // Period entries wrapped with a mask, gradients quantized to 8 bits per
+  // component. A Period 256 PerlinNoise3D drops from 5 KB to 1.25 KB, so
+  // several instances share L1. The batch entry points fall back to eval
+  Compact,
+  // No permutation or value table: the corners are hashed from the seed and
+  // their unwrapped lattice coordinates (see LatticeHash). Period is ignored
+  // and the lattice does not repeat over the whole int32 range, the only
+  // state is the seed (and the origin of noise::RebasedNoise), and the batch
+  // kernels compute the corners with integer multiplies instead of gathers.
+  // The random gradients of PerlinNoise3D are still a table, indexed by the
+  // hash
+  Hashed
+};
+
+// Placeholder of the members a layout does without, e.g. the tables of
+// TableLayout::Hashed or the hash of the other layouts
+struct Unused {};
+
+// Corner hashes of TableLayout::Hashed. Each lattice coordinate is
+// multiplied by a large odd constant of its axis and xored into the seed,
+// then the sum is avalanched (Wellons' lowbias32) so that every bit of the
+// hash depends on every bit of the coordinates. start and extend build the
+// sums one axis at a time, so the corners of a cell can share their prefixes
+// as they do with the permutation table.
+//
+// The coordinates are taken modulo 2^32, and (o + c) * prime is o * prime +
+// c * prime modulo 2^32: shiftOrigin moves the lattice to an int64 world
+// cell o by adding o * prime to the products of its axis, which is how
+// noise::RebasedNoise handles the hashed layout
+class LatticeHash {
+public:
+  static constexpr std::uint32_t kPrimes[5] = {501125321u, 1136930381u,
+                                               1720413743u, 2654435761u,
+                                               2246822519u};
+  static constexpr std::uint32_t kAvalanche[2] = {0x7feb352du, 0x846ca68bu};
+
+  explicit constexpr LatticeHash(const std::uint32_t seed = 0) : seed(seed) {}
+
+  // Seed drawn from an Engine seeded with seed, the way the tables are drawn
+  template <typename Engine, typename Seed_Type>
+  static LatticeHash draw(const Seed_Type seed) {
+    Engine generator;
+    generator.seed(seed);
+    std::uniform_int_distribution<std::uint32_t> distribution;
+    return LatticeHash(distribution(generator));
+  }
+
+  // Seed drawn from a utils::SplitMix64, see StaticSeed
+  static constexpr LatticeHash draw(utils::SplitMix64 &generator) {
+    return LatticeHash(static_cast<std::uint32_t>(generator() >> 32));
+  }
+
+  std::uint32_t data() const { return seed; }
+
+  // What extend adds to the products of axis, o * prime for the origin o
+  constexpr std::uint32_t shift(const std::size_t axis) const {
+    return shifts[axis];
+  }
+
+  // Coordinate c of axis now hashes as origin + c did
+  constexpr void shiftOrigin(const std::size_t axis,
+                             const std::int64_t origin) {
+    shifts[axis] += static_cast<std::uint32_t>(origin) * kPrimes[axis];
+  }
+
+  // Prefix of the corners of first coordinate x
+  constexpr std::uint32_t start(const std::int32_t x) const {
+    return extend(seed, 0, x);
+  }
+
+  // Prefix h extended with the coordinate c of axis
+  constexpr std::uint32_t extend(const std::uint32_t h, const std::size_t axis,
+                                 const std::int32_t c) const {
+    return h ^ (static_cast<std::uint32_t>(c) * kPrimes[axis] + shifts[axis]);
+  }
+
+  // Hash of a prefix covering every axis
+  static constexpr std::uint32_t finish(std::uint32_t h) {
+    h ^= h >> 16;
+    h *= kAvalanche[0];
+    h ^= h >> 15;
+    h *= kAvalanche[1];
+    h ^= h >> 16;
+    return h;
+  }
+
+  // Value in [0, 1) of the upper 24 bits of a hash, exact in float
+  template <typename Result_Type>
+  static constexpr Result_Type toUnit(const std::uint32_t h) {
+    return static_cast<Result_Type>(h >> 8) *
+           static_cast<Result_Type>(1.0 / 16777216.0);
+  }
+
+  std::uint32_t operator()(const std::int32_t x) const {
+    return finish(start(x));
+  }
+
+  std::uint32_t operator()(const std::int32_t x, const std::int32_t y) const {
+    return finish(extend(start(x), 1, y));
+  }
+
+  std::uint32_t operator()(const std::int32_t x, const std::int32_t y,
+                           const std::int32_t z) const {
+    return finish(extend(extend(start(x), 1, y), 2, z));
+  }
+
+private:
+  std::uint32_t seed;
+  std::uint32_t shifts[5] = {0, 0, 0, 0, 0};
+};
+
+// Permutation of [0, Period) looked up with indices in [0, 2 * Period - 1),
+// the range of perm[x] + y for x, y in [0, Period)
+template <uint_least16_t Period, typename Conv_Type, TableLayout Layout>
+class PermutationTable {
+public:
+  using Index_Type = std::conditional_t<
+      Layout == TableLayout::Wide, Conv_Type,
+      std::conditional_t<(Period <= 256), std::uint8_t, std::uint16_t>>;
+
+  static constexpr std::size_t kSize =
+      Layout == TableLayout::Wide ? 2 * std::size_t{Period} : Period;
+
+  // Entry i of the permutation, i in [0, Period)
+  constexpr Index_Type &at(const std::size_t i) { return table[i]; }
+
+  // Copy entry i of the permutation into the upper half of the wide table,
+  // if any
+  constexpr void mirror(const std::size_t i) {
+    if constexpr (Layout == TableLayout::Wide) {
+      table[i + Period] = table[i];
+    }
+  }
+
+  constexpr Conv_Type operator[](const Conv_Type i) const {
+    if constexpr (Layout == TableLayout::Wide) {
+      return table[i];
+    } else {
+      return table[i & (Period - 1)];
+    }
+  }
+
+  const Index_Type *data() const { return table.data(); }
+
+private:
+  std::array<Index_Type, kSize> table{};
+};
+
+// Unit gradients of PerlinNoise3D
+template <std::size_t Size, typename Result_Type, TableLayout Layout>
+class GradientTable;
+
+template <std::size_t Size, typename Result_Type>
+class GradientTable<Size, Result_Type, TableLayout::Wide> {
+public:
+  using Vec3_Type = typename vector::Vec3<Result_Type>;
+
+  constexpr void set(const std::size_t i, const Vec3_Type &g) {
+    table[i] = g;
+  }
+
+  const Vec3_Type &operator[](const std::size_t i) const { return table[i]; }
+
+  // Packed {x, y, z} triples, as the batch kernels read them
+  const Result_Type *data() const { return &table[0].x; }
+
+private:
+  std::array<Vec3_Type, Size> table{};
+};
+
+template <std::size_t Size, typename Result_Type>
+class GradientTable<Size, Result_Type, TableLayout::Compact> {
+public:
+  using Vec3_Type = typename vector::Vec3<Result_Type>;
+
+  // Components are truncated toward 0, so the quantized gradients are never
+  // longer than the unit gradients and the output bounds still hold
+  constexpr void set(const std::size_t i, const Vec3_Type &g) {
+    table[i] = {static_cast<std::int8_t>(g.x * kScale),
+                static_cast<std::int8_t>(g.y * kScale),
+                static_cast<std::int8_t>(g.z * kScale), 0};
+  }
+
+  Vec3_Type operator[](const std::size_t i) const {
+    const auto &q = table[i];
+    return Vec3_Type(q[0] * kInvScale, q[1] * kInvScale, q[2] * kInvScale);
+  }
+
+private:
+  static constexpr Result_Type kScale = 127;
+  static constexpr Result_Type kInvScale = 1 / kScale;
+
+  // Padded to 4 bytes, so a gradient is a single aligned load
+  std::array<std::array<std::int8_t, 4>, Size> table{};
+};
+
+// Seed of the constexpr constructors of the noises. Their tables are drawn
+// by utils::SplitMix64 and the builders below instead of Engine and the
+// standard distributions, so a constexpr noise is materialized at compile
+// time, with no construction at run time, and its tables are the same with
+// every standard library. They differ from the tables of the Seed_Type
+// constructors
+struct StaticSeed {
+  std::uint64_t value;
+};
+
+// Table builders of the StaticSeed constructors, all usable in constant
+// expressions
+
+// Values uniform in [0, 1)
+template <typename Result_Type, std::size_t Size>
+constexpr void drawValues(std::array<Result_Type, Size> &values,
+                          utils::SplitMix64 &generator) {
+  for (std::size_t i = 0; i < Size; ++i) {
+    values[i] = generator.uniform<Result_Type>();
+  }
+}
+
+// Uniform permutation of [0, Period), by Fisher-Yates
+template <uint_least16_t Period, typename Conv_Type, TableLayout Layout>
+constexpr void
+drawPermutation(PermutationTable<Period, Conv_Type, Layout> &table,
+                utils::SplitMix64 &generator) {
+  using Index_Type =
+      typename PermutationTable<Period, Conv_Type, Layout>::Index_Type;
+  for (std::size_t i = 0; i < Period; ++i) {
+    table.at(i) = static_cast<Index_Type>(i);
+  }
+  for (std::size_t i = Period - 1; i > 0; --i) {
+    const auto j = static_cast<std::size_t>(generator.below(i + 1));
+    const auto t = table.at(i);
+    table.at(i) = table.at(j);
+    table.at(j) = t;
+  }
+  for (std::size_t i = 0; i < Period; ++i) {
+    table.mirror(i);
+  }
+}
+
+// Unit vectors uniform on the sphere: points uniform in the unit ball,
+// drawn by rejection from the cube, then normalized. Unlike the spherical
+// coordinates of the Seed_Type constructors this needs no trigonometry,
+// which is not constexpr
+template <std::size_t Size, typename Result_Type, TableLayout Layout>
+constexpr void drawGradients(GradientTable<Size, Result_Type, Layout> &table,
+                             utils::SplitMix64 &generator) {
+  using Vec3_Type = typename vector::Vec3<Result_Type>;
+  for (std::size_t i = 0; i < Size; ++i) {
+    double x = 0, y = 0, z = 0, length2 = 0;
+    do {
+      x = 2 * generator.uniform<double>() - 1;
+      y = 2 * generator.uniform<double>() - 1;
+      z = 2 * generator.uniform<double>() - 1;
+      length2 = x * x + y * y + z * z;
+    } while (length2 > 1 || length2 < 1e-6);
+
+    const double invLength = 1 / utils::constexprSqrt(length2);
+    table.set(i, Vec3_Type(static_cast<Result_Type>(x * invLength),
+                           static_cast<Result_Type>(y * invLength),
+                           static_cast<Result_Type>(z * invLength)));
+  }
+}
+
+// Sign of a gradient component from one hash bit
+template <typename Result_Type>
+inline constexpr Result_Type kHashSign[2] = {1, -1};
+
+// Dot product between (x, y, z) and the gradient of Perlin's improved set
+// (the 12 edges of a cube, 4 of them twice) that the low 4 bits of h select.
+// The component selects go through a small table and the sign flips through
+// multiplications, as the hash bits of scattered samples are unpredictable
+template <typename Result_Type, typename Conv_Type>
+inline Result_Type improvedGradientDot(const Conv_Type h, const Result_Type x,
+                                       const Result_Type y,
+                                       const Result_Type z) {
+  // u = b < 8 ? x : y, v = b < 4 ? y : (b == 12 || b == 14 ? x : z)
+  static constexpr unsigned char kV[16] = {1, 1, 1, 1, 2, 2, 2, 2,
+                                           2, 2, 2, 2, 0, 2, 0, 2};
+  const unsigned b = static_cast<unsigned>(h) & 15;
+  const Result_Type p[3] = {x, y, z};
+  return p[b >> 3] * kHashSign<Result_Type>[b & 1] +
+         p[kV[b]] * kHashSign<Result_Type>[(b >> 1) & 1];
+}
+
+} // namespace noise
+
+#endif // !LATTICE_TABLES_H
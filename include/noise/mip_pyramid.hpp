@@ -0,0 +1,232 @@
+#ifndef MIP_PYRAMID_H
+#define MIP_PYRAMID_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "noise/fractal_noise.hpp"
+#include "noise/tiled_generator.hpp"
+#include "utils/thread_pool.hpp"
+
+namespace noise {
+
+template <typename T> struct MipPyramidOptions {
+  // Bound of |d2n/dx2| and |d2n/dy2| for the base noise n at frequency 1.
+  // 8 covers ValueNoiseND with smoothstepRemap (6) and PerlinNoise3D (about
+  // 7.3 measured); SimplexNoise needs about 48
+  T curvature = 8;
+  // Largest difference allowed between a level and the direct evaluation
+  // of the sum on its grid. Half a step of an 8 bit image by default
+  T maxError = static_cast<T>(1.0 / 512);
+};
+
+template <typename T> struct MipLevel {
+  std::size_t width, height;
+  T step;                 // Distance between the samples
+  std::vector<T> samples; // Rows of width samples
+  // Octaves evaluated on the grid of this level, the lower ones are
+  // upsampled from the next coarser level
+  std::size_t evaluatedOctaves;
+  // Bound of the difference to the direct evaluation, from the curvature
+  T errorBound;
+};
+
+// Mip pyramid of the FBm sum noise: level L samples origin + (i, j) * step
+// * 2^L, (width >> L) x (height >> L) of them, levels in all (0 for down to
+// 1 x 1). Levels are produced coarse to fine. The low octaves, smooth at
+// the spacing of a coarser level, are not evaluated again on a finer one
+// but upsampled bilinearly from it. Bilinear interpolation on a grid of
+// spacing h is within h^2 / 8 (|fxx| + |fyy|) of a function f, i.e.
+// amplitude * curvature * (frequency * h)^2 / 4 for a layer. The octaves
+// upsampled to each level trade the evaluations saved against these
+// errors, which accumulate down to the finest level, within maxError. The
+// deep zoom of a sum of many octaves then costs a few octave evaluations
+// per sample of the finest level instead of all of them at every level.
+// Samples of a level match its evalGrid within errorBound. A Vec3 origin
+// samples the z = origin.z slice
+template <typename Fractal, typename Vec_Type, typename T>
+std::vector<MipLevel<T>>
+generateMipPyramid(utils::ThreadPool &pool, const Fractal &noise,
+                   const Vec_Type &origin, const T step,
+                   const std::size_t width, const std::size_t height,
+                   std::size_t levels = 0,
+                   const MipPyramidOptions<T> &options = {}) {
+  static_assert(Fractal::kMode == FractalMode::FBm,
+                "Turbulence and ridges fold the layers into creases, which "
+                "do not upsample within a curvature bound");
+  constexpr std::size_t kOctaves = Fractal::kOctaves;
+
+  std::size_t maxLevels = 1;
+  while ((std::max(width, height) >> maxLevels) > 0) {
+    ++maxLevels;
+  }
+  levels = levels == 0 ? maxLevels : std::min(levels, maxLevels);
+
+  // Output sizes, and the grids the levels are computed on: a finer grid
+  // of g samples reads g / 2 + 1 from the coarser one, its odd samples
+  // being in between two coarse ones
+  std::vector<std::size_t> widths(levels), heights(levels);
+  std::vector<std::size_t> gridWidths(levels), gridHeights(levels);
+  for (std::size_t l = 0; l < levels; ++l) {
+    widths[l] = std::max<std::size_t>(width >> l, 1);
+    heights[l] = std::max<std::size_t>(height >> l, 1);
+    gridWidths[l] =
+        l == 0 ? width : std::max(widths[l], gridWidths[l - 1] / 2 + 1);
+    gridHeights[l] =
+        l == 0 ? height : std::max(heights[l], gridHeights[l - 1] / 2 + 1);
+  }
+
+  // Octave o upsampled to the levels [0, u) costs its direct evaluation on
+  // the levels [u, levels), and the errors of interpolating it from the
+  // spacings h = step * 2^(L + 1), L in [0, u), which add up down to the
+  // finest level. Each octave takes the u minimizing work + lambda * error,
+  // lambda being the smallest one whose total error fits maxError. The
+  // lower octaves, smoother, are the ones upsampled from coarser levels
+  std::vector<double> work(levels + 1, 0);
+  for (std::size_t l = levels; l-- > 0;) {
+    work[l] = work[l + 1] +
+              static_cast<double>(gridWidths[l]) * gridHeights[l];
+  }
+  const auto error = [&](const std::size_t o, const std::size_t l) {
+    const double fh =
+        static_cast<double>(noise.frequency(o)) *
+        std::ldexp(static_cast<double>(step), static_cast<int>(l + 1));
+    return std::fabs(static_cast<double>(noise.amplitude(o))) *
+           options.curvature * fh * fh / 4;
+  };
+  std::vector<std::size_t> upsampledLevels(kOctaves);
+  const auto choose = [&](const double lambda) {
+    double total = 0;
+    for (std::size_t o = 0; o < kOctaves; ++o) {
+      std::size_t best = 0;
+      double bestCost = work[0], err = 0, bestErr = 0;
+      const std::size_t limit = o > 0 ? upsampledLevels[o - 1] : levels - 1;
+      for (std::size_t u = 1; u <= limit; ++u) {
+        err += error(o, u - 1);
+        const double cost = work[u] + lambda * err;
+        if (cost < bestCost) {
+          best = u;
+          bestCost = cost;
+          bestErr = err;
+        }
+      }
+      upsampledLevels[o] = best;
+      total += bestErr;
+    }
+    return total;
+  };
+  // Bisection of log2(lambda). Large enough, nothing is upsampled
+  double low = -64, high = 192;
+  for (int i = 0; i < 64; ++i) {
+    const double mid = (low + high) / 2;
+    (choose(std::exp2(mid)) > options.maxError ? low : high) = mid;
+  }
+  choose(std::exp2(high));
+
+  // Octaves upsampled to each level, and the bounds of their errors
+  std::vector<std::size_t> upsampled(levels, 0);
+  std::vector<T> bounds(levels, 0);
+  for (std::size_t o = 0; o < kOctaves; ++o) {
+    for (std::size_t l = 0; l < upsampledLevels[o]; ++l) {
+      ++upsampled[l];
+      for (std::size_t m = 0; m <= l; ++m) {
+        bounds[m] += static_cast<T>(error(o, l));
+      }
+    }
+  }
+
+  std::vector<MipLevel<T>> pyramid(levels);
+  // Sum of the octaves the next finer level upsamples, on the grid of the
+  // level just produced
+  std::vector<T> prefix;
+  for (std::size_t l = levels; l-- > 0;) {
+    const std::size_t gw = gridWidths[l], gh = gridHeights[l];
+    const std::size_t coarseWidth = l + 1 < levels ? gridWidths[l + 1] : 0;
+    const T levelStep = std::ldexp(step, static_cast<int>(l));
+    const std::size_t first = upsampled[l];
+    // Octave count at which the sum is the prefix of the next finer level
+    const bool keepPrefix = l > 0 && upsampled[l - 1] > 0;
+    const std::size_t prefixOctaves = keepPrefix ? upsampled[l - 1] : 0;
+
+    std::vector<T> sum(gw * gh);
+    std::vector<T> nextPrefix(keepPrefix ? gw * gh : 0);
+
+    generateTiles(pool, gw, gh, sum.data(), gw, [&](const Tile &tile,
+                                                    T *tileOut) {
+      const auto save = [&] {
+        for (std::size_t j = 0; j < tile.height; ++j) {
+          std::copy_n(tileOut + j * gw, tile.width,
+                      nextPrefix.data() + (tile.y + j) * gw + tile.x);
+        }
+      };
+
+      for (std::size_t j = 0; j < tile.height; ++j) {
+        T *row = tileOut + j * gw;
+        if (first == 0) {
+          std::fill_n(row, tile.width, T(0));
+          continue;
+        }
+        // Bilinear between the coarse samples i / 2 and (i + 1) / 2
+        const std::size_t y = tile.y + j;
+        const T *c0 = prefix.data() + (y / 2) * coarseWidth;
+        const T *c1 = prefix.data() + ((y + 1) / 2) * coarseWidth;
+        for (std::size_t i = 0; i < tile.width; ++i) {
+          const std::size_t x = tile.x + i;
+          const std::size_t x0 = x / 2, x1 = (x + 1) / 2;
+          row[i] = ((c0[x0] + c0[x1]) + (c1[x0] + c1[x1])) *
+                   static_cast<T>(0.25);
+        }
+      }
+      if (keepPrefix && prefixOctaves == first) {
+        save();
+      }
+
+      std::vector<T> layer(tile.width * tile.height);
+      for (std::size_t o = first; o < kOctaves; ++o) {
+        Vec_Type layerOrigin = origin * noise.frequency(o);
+        layerOrigin.x += noise.offset(o).x;
+        layerOrigin.y += noise.offset(o).y;
+        if constexpr (std::is_same_v<Vec_Type, vector::Vec3<T>>) {
+          layerOrigin.z += noise.offset(o).z;
+        }
+        noise.base().evalGrid(layerOrigin, levelStep * noise.frequency(o),
+                              tile.width, tile.height, layer.data(),
+                              tile.width, tile.x, tile.y);
+
+        const T amplitude = noise.amplitude(o);
+        for (std::size_t j = 0; j < tile.height; ++j) {
+          T *row = tileOut + j * gw;
+          const T *src = layer.data() + j * tile.width;
+          for (std::size_t i = 0; i < tile.width; ++i) {
+            row[i] += src[i] * amplitude;
+          }
+        }
+        if (keepPrefix && prefixOctaves == o + 1) {
+          save();
+        }
+      }
+    });
+
+    MipLevel<T> &level = pyramid[l];
+    level.width = widths[l];
+    level.height = heights[l];
+    level.step = levelStep;
+    level.evaluatedOctaves = kOctaves - first;
+    level.errorBound = bounds[l];
+    level.samples.resize(level.width * level.height);
+    for (std::size_t j = 0; j < level.height; ++j) {
+      std::copy_n(sum.data() + j * gw, level.width,
+                  level.samples.data() + j * level.width);
+    }
+
+    prefix = std::move(nextPrefix);
+  }
+  return pyramid;
+}
+
+} // namespace noise
+
+#endif // !MIP_PYRAMID_H
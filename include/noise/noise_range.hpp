@@ -0,0 +1,43 @@
+#ifndef NOISE_RANGE_H
+#define NOISE_RANGE_H
+
+namespace noise {
+
+// Closed interval a noise function is guaranteed to stay in
+template <typename T = float> struct Range {
+  T min, max;
+
+  constexpr T span() const { return max - min; }
+
+  // Map [min, max] onto [0, 1]
+  constexpr T normalize(const T v) const { return (v - min) / span(); }
+};
+
+// Perlin noise with unit gradients stays within +-sqrt(N) / 2 in N
+// dimensions, the value reached at a cell center when every gradient points
+// away from its corner
+template <typename T> constexpr Range<T> perlinRange(const unsigned dimension) {
+  const T bound = dimension <= 1   ? static_cast<T>(0.5)
+                  : dimension == 2 ? static_cast<T>(0.70710678118654752440L)
+                                   : static_cast<T>(0.86602540378443864676L);
+  return Range<T>{-bound, bound};
+}
+
+// Perlin noise with the improved gradient set (the edges of a cube, of
+// length sqrt(2)). A corner at offset d adds at most its weight times the
+// sum of the two largest |d[a]|, each corner picking its own gradient. In 2
+// dimensions (the z = 0 slice) that weighted sum peaks at 1 at a cell
+// center, x in 1 dimension peaks at 0.5. In 3 dimensions the center also
+// gives 1 but is not the maximum: the sum reaches 1.03635 around (0.355,
+// 0.482, 0.5) of a cell and its mirror images, which the bound rounds up
+template <typename T>
+constexpr Range<T> improvedPerlinRange(const unsigned dimension) {
+  const T bound = dimension <= 1   ? static_cast<T>(0.5)
+                  : dimension == 2 ? static_cast<T>(1)
+                                   : static_cast<T>(1.0364L);
+  return Range<T>{-bound, bound};
+}
+
+} // namespace noise
+
+#endif // !NOISE_RANGE_H
@@ -23,11 +23,32 @@ template <typename T> constexpr T perlinRemap(const T t) {
   return t * t * t * (10 - 15 * t + 6 * t * t);
 }
 
+template <typename T> constexpr T cosineRemapDeriv(const T t) {
+  return std::sin(t * utils::pi<T>) * utils::pi<T> * 0.5;
+}
+
+template <typename T> constexpr T smoothstepRemapDeriv(const T t) {
+  return 6 * t * (1 - t);
+}
+
 template <typename T> constexpr T perlinRemapDeriv(const T t) {
   const T a = t - 1;
   return 30 * t * t * a * a;
 }
 
+// Derivative of one of the remaps above, nullptr for any other function
+template <typename T, RemapFunction<T> Remap_Func>
+constexpr RemapFunction<T> remapDeriv() {
+  if constexpr (Remap_Func == cosineRemap<T>) {
+    return cosineRemapDeriv<T>;
+  } else if constexpr (Remap_Func == smoothstepRemap<T>) {
+    return smoothstepRemapDeriv<T>;
+  } else if constexpr (Remap_Func == perlinRemap<T>) {
+    return perlinRemapDeriv<T>;
+  } else {
+    return nullptr;
+  }
+}
 
 } // namespace noise
 
@@ -0,0 +1,69 @@
+#ifndef NORMAL_MAP_H
+#define NORMAL_MAP_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "noise/tiled_generator.hpp"
+#include "utils/thread_pool.hpp"
+
+namespace noise {
+
+// Unit vector (x, y, z) packed the usual way of normal maps: each component
+// c as the 8 bits round((c + 1) * 127.5), x in the lowest byte, then y, z
+// and an opaque alpha of 255. In memory (little endian) that is RGBA8
+inline std::uint32_t packNormal(const float x, const float y, const float z) {
+  const auto quantize = [](const float c) {
+    return std::min(static_cast<std::uint32_t>(c * 127.5f + 128.0f),
+                    std::uint32_t{255});
+  };
+  return quantize(x) | quantize(y) << 8 | quantize(z) << 16 |
+         std::uint32_t{255} << 24;
+}
+
+// Tiled normal map of the height field heightScale * noise(origin + (i, j) *
+// step), packed by packNormal into out (rows stride elements apart). Each
+// normal comes from one derivative evaluation of noise (eval(p, deriv), see
+// PerlinNoise3D, ValueNoiseND, SimplexNoise or FractalNoise) instead of the
+// 3 to 5 samples of finite differences. Slopes are per raster sample, i.e.
+// the normal of (i, j) is (-dh/di, -dh/dj, 1) normalized, with dh/di =
+// heightScale * step * dnoise/dx. A Vec3 origin samples the z = origin.z
+// slice of 3D noise
+template <typename Noise, typename Vec_Type, typename T>
+void generateNormalMap(utils::ThreadPool &pool, const Noise &noise,
+                       const Vec_Type &origin, const T step,
+                       const T heightScale, const std::size_t width,
+                       const std::size_t height, std::uint32_t *out,
+                       const std::size_t stride,
+                       const std::size_t tileSize = kDefaultTileSize) {
+  const T slopeScale = -heightScale * step;
+
+  generateTiles(
+      pool, width, height, out, stride,
+      [&](const Tile &tile, std::uint32_t *tileOut) {
+        Vec_Type p = origin;
+        Vec_Type deriv;
+        for (std::size_t j = 0; j < tile.height; ++j) {
+          std::uint32_t *row = tileOut + j * stride;
+          p.y = origin.y + static_cast<T>(tile.y + j) * step;
+          for (std::size_t i = 0; i < tile.width; ++i) {
+            p.x = origin.x + static_cast<T>(tile.x + i) * step;
+            noise.eval(p, deriv);
+
+            const T nx = deriv.x * slopeScale;
+            const T ny = deriv.y * slopeScale;
+            const T norm = 1 / std::sqrt(nx * nx + ny * ny + 1);
+            row[i] = packNormal(static_cast<float>(nx * norm),
+                                static_cast<float>(ny * norm),
+                                static_cast<float>(norm));
+          }
+        }
+      },
+      tileSize);
+}
+
+} // namespace noise
+
+#endif // !NORMAL_MAP_H
@@ -0,0 +1,90 @@
+#ifndef NORMALIZED_NOISE_H
+#define NORMALIZED_NOISE_H
+
+#include <cstddef>
+
+#include "noise/noise_range.hpp"
+#include "vec/vec2.hpp"
+#include "vec/vec3.hpp"
+
+namespace noise {
+
+// Noise (ValueNoise1D, ValueNoiseND, PerlinNoise3D, SimplexNoise or
+// FractalNoise) mapped onto [0, 1] through its analytic outputRange.
+// evalGrid and evalBatch map the region the base noise just produced in one
+// pass: under the tiled generator that is a tile, still in cache, so a
+// raster needs no second pass over the whole buffer
+template <typename Noise> class NormalizedNoise {
+public:
+  using Result_Type = typename Noise::Value_Type;
+  using Value_Type = Result_Type;
+  using Vec2_Type = typename vector::Vec2<Result_Type>;
+  using Vec3_Type = typename vector::Vec3<Result_Type>;
+
+  static constexpr bool kSignedOutput = false;
+
+  NormalizedNoise(const Noise &noise = Noise());
+
+  Result_Type eval(const Result_Type x) const;
+
+  Result_Type eval(const Vec2_Type &p) const;
+
+  Result_Type eval(const Vec3_Type &p) const;
+
+  // Derivative evaluations of Noise, the gradient scaled as the value
+  Result_Type eval(const Vec2_Type &p, Vec2_Type &deriv) const;
+
+  Result_Type eval(const Vec3_Type &p, Vec3_Type &deriv) const;
+
+  // Same contract as the evalGrid of Noise
+  void evalGrid(const Vec2_Type &origin, const Result_Type step,
+                const std::size_t width, const std::size_t height,
+                Result_Type *out, const std::size_t stride,
+                const std::size_t column = 0, const std::size_t row = 0) const;
+
+  void evalGrid(const Vec3_Type &origin, const Result_Type step,
+                const std::size_t width, const std::size_t height,
+                Result_Type *out, const std::size_t stride,
+                const std::size_t column = 0, const std::size_t row = 0) const;
+
+  // Same contract as the evalBatch of Noise
+  void evalBatch(const Result_Type *x, const std::size_t count,
+                 Result_Type *out) const;
+
+  void evalBatch(const Result_Type *x, const Result_Type *y,
+                 const std::size_t count, Result_Type *out) const;
+
+  void evalBatch(const Result_Type *x, const Result_Type *y,
+                 const Result_Type *z, const std::size_t count,
+                 Result_Type *out) const;
+
+  static constexpr Range<Result_Type> outputRange(const unsigned = 1) {
+    return Range<Result_Type>{0, 1};
+  }
+
+  const Noise &base() const { return noise; }
+
+  // Bounds of the samples of Noise with dimension coordinates
+  const Range<Result_Type> &sourceRange(const unsigned dimension) const {
+    return ranges[dimension - 1];
+  }
+
+private:
+  // v * scale + offset for the samples with Dimension coordinates
+  template <unsigned Dimension> Result_Type map(const Result_Type v) const;
+
+  template <unsigned Dimension>
+  void mapRows(const std::size_t width, const std::size_t height,
+               Result_Type *out, const std::size_t stride) const;
+
+  Noise noise;
+  Range<Result_Type> ranges[3];
+  Result_Type scales[3];
+  Result_Type offsets[3];
+};
+
+} // namespace noise
+
+#include "noise/normalized_noise_impl.hpp"
+
+#endif // !NORMALIZED_NOISE_H
@@ -0,0 +1,119 @@
+#ifndef NORMALIZED_NOISE_IMPL_H
+#define NORMALIZED_NOISE_IMPL_H
+
+#include "noise/normalized_noise.hpp"
+
+namespace noise {
+
+template <typename Noise>
+NormalizedNoise<Noise>::NormalizedNoise(const Noise &noise) : noise(noise) {
+  for (unsigned d = 0; d < 3; ++d) {
+    ranges[d] = noise.outputRange(d + 1);
+    scales[d] = 1 / ranges[d].span();
+    offsets[d] = -ranges[d].min * scales[d];
+  }
+}
+
+template <typename Noise>
+template <unsigned Dimension>
+typename NormalizedNoise<Noise>::Result_Type
+NormalizedNoise<Noise>::map(const Result_Type v) const {
+  return v * scales[Dimension - 1] + offsets[Dimension - 1];
+}
+
+template <typename Noise>
+template <unsigned Dimension>
+void NormalizedNoise<Noise>::mapRows(const std::size_t width,
+                                     const std::size_t height,
+                                     Result_Type *out,
+                                     const std::size_t stride) const {
+  for (std::size_t j = 0; j < height; ++j) {
+    Result_Type *dst = out + j * stride;
+    for (std::size_t i = 0; i < width; ++i) {
+      dst[i] = map<Dimension>(dst[i]);
+    }
+  }
+}
+
+template <typename Noise>
+typename NormalizedNoise<Noise>::Result_Type
+NormalizedNoise<Noise>::eval(const Result_Type x) const {
+  return map<1>(noise.eval(x));
+}
+
+template <typename Noise>
+typename NormalizedNoise<Noise>::Result_Type
+NormalizedNoise<Noise>::eval(const Vec2_Type &p) const {
+  return map<2>(noise.eval(p));
+}
+
+template <typename Noise>
+typename NormalizedNoise<Noise>::Result_Type
+NormalizedNoise<Noise>::eval(const Vec3_Type &p) const {
+  return map<3>(noise.eval(p));
+}
+
+template <typename Noise>
+typename NormalizedNoise<Noise>::Result_Type
+NormalizedNoise<Noise>::eval(const Vec2_Type &p, Vec2_Type &deriv) const {
+  const Result_Type v = noise.eval(p, deriv);
+  deriv *= scales[1];
+  return map<2>(v);
+}
+
+template <typename Noise>
+typename NormalizedNoise<Noise>::Result_Type
+NormalizedNoise<Noise>::eval(const Vec3_Type &p, Vec3_Type &deriv) const {
+  const Result_Type v = noise.eval(p, deriv);
+  deriv *= scales[2];
+  return map<3>(v);
+}
+
+template <typename Noise>
+void NormalizedNoise<Noise>::evalGrid(
+    const Vec2_Type &origin, const Result_Type step, const std::size_t width,
+    const std::size_t height, Result_Type *out, const std::size_t stride,
+    const std::size_t column, const std::size_t row) const {
+  noise.evalGrid(origin, step, width, height, out, stride, column, row);
+  mapRows<2>(width, height, out, stride);
+}
+
+template <typename Noise>
+void NormalizedNoise<Noise>::evalGrid(
+    const Vec3_Type &origin, const Result_Type step, const std::size_t width,
+    const std::size_t height, Result_Type *out, const std::size_t stride,
+    const std::size_t column, const std::size_t row) const {
+  noise.evalGrid(origin, step, width, height, out, stride, column, row);
+  mapRows<3>(width, height, out, stride);
+}
+
+template <typename Noise>
+void NormalizedNoise<Noise>::evalBatch(const Result_Type *x,
+                                       const std::size_t count,
+                                       Result_Type *out) const {
+  noise.evalBatch(x, count, out);
+  mapRows<1>(count, 1, out, count);
+}
+
+template <typename Noise>
+void NormalizedNoise<Noise>::evalBatch(const Result_Type *x,
+                                       const Result_Type *y,
+                                       const std::size_t count,
+                                       Result_Type *out) const {
+  noise.evalBatch(x, y, count, out);
+  mapRows<2>(count, 1, out, count);
+}
+
+template <typename Noise>
+void NormalizedNoise<Noise>::evalBatch(const Result_Type *x,
+                                       const Result_Type *y,
+                                       const Result_Type *z,
+                                       const std::size_t count,
+                                       Result_Type *out) const {
+  noise.evalBatch(x, y, z, count, out);
+  mapRows<3>(count, 1, out, count);
+}
+
+} // namespace noise
+
+#endif // !NORMALIZED_NOISE_IMPL_H
@@ -4,20 +4,38 @@
 
 #include <array>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <random>
+#include <type_traits>
 
+#include "noise/lattice_tables.hpp"
+#include "noise/noise_range.hpp"
 #include "noise/noise_remap.hpp"
 #include "utils/int_fit.hpp"
+#include "utils/lerp.hpp"
 #include "vec/vec2.hpp"
 #include "vec/vec3.hpp"
 
 
 namespace noise {
 
+// Gradients at the lattice corners of PerlinNoise3D
+enum class PerlinGradients {
+  // Period random unit vectors, drawn by the constructor and looked up with
+  // the hash of the corner
+  Random,
+  // Perlin's 2002 set, the 12 edge directions of a cube (4 of them twice),
+  // selected by the low 4 bits of the hash with a few compares and sign
+  // flips. There is no gradients table and no load per corner
+  Improved
+};
+
 template <uint_least16_t Period = 256,
           typename Engine = std::default_random_engine,
-          typename Result_Type = float>
+          typename Result_Type = float,
+          TableLayout Layout = TableLayout::Wide,
+          PerlinGradients Gradients = PerlinGradients::Random>
 class PerlinNoise3D {
 public:
   static_assert(std::is_floating_point<Result_Type>(),
@@ -25,12 +43,36 @@ public:
 
   using Dist = typename std::uniform_real_distribution<Result_Type>;
   using Seed_Type = typename Dist::result_type;
+  using Value_Type = Result_Type;
+
+  // Gradient noise is centered on 0
+  static constexpr bool kSignedOutput = true;
+
+  // Period of the lattice along every axis, 0 for the hashed layout whose
+  // lattice does not wrap. See noise/large_world.hpp
+  static constexpr std::size_t kPeriod =
+      Layout == TableLayout::Hashed ? 0 : Period;
+
+  // Bounds of the eval overload taking dimension coordinates. The random
+  // gradients are unit vectors, so these are the +-sqrt(dimension) / 2 of
+  // perlinRange. See improvedPerlinRange for the improved set
+  static constexpr Range<Result_Type> outputRange(const unsigned dimension) {
+    if constexpr (Gradients == PerlinGradients::Improved) {
+      return improvedPerlinRange<Result_Type>(dimension);
+    } else {
+      return perlinRange<Result_Type>(dimension);
+    }
+  }
 
   using Vec2_Type = typename vector::Vec2<Result_Type>;
   using Vec3_Type = typename vector::Vec3<Result_Type>;
 
   PerlinNoise3D(Seed_Type seed = 2011);
-  ~PerlinNoise3D();
+
+  // Tables drawn at compile time for a constexpr instance, see StaticSeed
+  explicit constexpr PerlinNoise3D(const StaticSeed seed);
+
+  ~PerlinNoise3D() = default;
 
   Result_Type eval(Result_Type p) const;
 
@@ -38,9 +80,44 @@ public:
 
   Result_Type eval(const Vec3_Type &p) const;
 
-  // Evaluation with Derivatives (they are returned through deriv)
+  // Evaluation with the analytic gradient, returned through deriv. The
+  // value is the one of the overload without deriv
+  Result_Type eval(const Vec2_Type &p, Vec2_Type &deriv) const;
+
   Result_Type eval(const Vec3_Type &p, Vec3_Type &deriv) const;
 
+  // Fill a width x height raster with the samples at origin + (i, j) * step.
+  // Rows are stride elements apart in out, whose first sample is (column,
+  // row) of the raster, so it can be filled tile by tile. Corner gradients
+  // are fetched once per lattice cell and the y remap once per row, instead
+  // of once per sample
+  void evalGrid(const Vec2_Type &origin, const Result_Type step,
+                const std::size_t width, const std::size_t height,
+                Result_Type *out, const std::size_t stride,
+                const std::size_t column = 0, const std::size_t row = 0) const;
+
+  // Same as above for the z = origin.z slice of the 3D noise
+  void evalGrid(const Vec3_Type &origin, const Result_Type step,
+                const std::size_t width, const std::size_t height,
+                Result_Type *out, const std::size_t stride,
+                const std::size_t column = 0, const std::size_t row = 0) const;
+
+  // Evaluate the count samples (x[k], y[k], z[k]) into out[k]. Float noise
+  // runs the widest vector kernel the CPU supports (noise::simd::dispatch),
+  // which matches eval(const Vec3_Type &) bit for bit
+  // (see noise/simd/noise_kernels.inl)
+  void evalBatch(const Result_Type *x, const Result_Type *y,
+                 const Result_Type *z, const std::size_t count,
+                 Result_Type *out) const;
+
+  // The hashed layout only: lattice cell c along axis (0 for x) becomes the
+  // cell origin + c, see RebasedNoise in noise/large_world.hpp
+  template <TableLayout L = Layout>
+  std::enable_if_t<L == TableLayout::Hashed>
+  shiftLatticeOrigin(const std::size_t axis, const std::int64_t origin) {
+    lattice.shiftOrigin(axis, origin);
+  }
+
 private:
   using Conv_Type = typename utils::int_least_fit_t<Seed_Type>;
 
@@ -50,19 +127,97 @@ private:
   static constexpr auto kTableSizeMask{Period - 1};
   static constexpr Result_Type low{0.0};
   static constexpr Result_Type high{1.0};
-  std::array<Vec3_Type, kTableSize> gradients{};
-  std::array<Conv_Type, kTableSize * 2> permutationTable{0};
+  static constexpr bool kHashed = Layout == TableLayout::Hashed;
+  // Wrapping of the lattice coordinates, none without a permutation table
+  static constexpr Conv_Type kLatticeMask =
+      kHashed ? ~Conv_Type{0} : Conv_Type{kTableSizeMask};
+  // The vector kernels read float gradients as packed {x, y, z} triples and
+  // the permutation table as int32 indices, i.e. the wide layout, or hash
+  static constexpr bool kHasKernels =
+      std::is_same_v<Result_Type, float> &&
+      std::is_same_v<Conv_Type, std::int32_t> &&
+      (Layout == TableLayout::Wide || kHashed);
+  // The hashed layout keeps the random gradients as floats
+  static constexpr TableLayout kGradientsLayout =
+      kHashed ? TableLayout::Wide : Layout;
+
+  struct NoGradients {};
+
+  // What is kept of a lattice corner: its gradient, or the hash that selects
+  // one of the improved gradients
+  using Corner_Type =
+      std::conditional_t<Gradients == PerlinGradients::Improved, Conv_Type,
+                         Vec3_Type>;
+
+  inline Corner_Type corner(const Conv_Type h) const {
+    if constexpr (Gradients == PerlinGradients::Improved) {
+      return h;
+    } else if constexpr (kHashed) {
+      return gradients[h & kTableSizeMask];
+    } else {
+      return gradients[h];
+    }
+  }
+
+  // Dot product between the gradient of corner c and p
+  inline Result_Type cornerDot(const Corner_Type &c, const Vec3_Type &p) const {
+    if constexpr (Gradients == PerlinGradients::Improved) {
+      return improvedGradientDot(c, p.x, p.y, p.z);
+    } else {
+      return vector::dot(c, p);
+    }
+  }
+
+  // Gradient of corner c, for the derivatives
+  inline Vec3_Type cornerGradient(const Corner_Type &c) const {
+    if constexpr (Gradients == PerlinGradients::Improved) {
+      return Vec3_Type(improvedGradientDot<Result_Type>(c, 1, 0, 0),
+                       improvedGradientDot<Result_Type>(c, 0, 1, 0),
+                       improvedGradientDot<Result_Type>(c, 0, 0, 1));
+    } else {
+      return c;
+    }
+  }
+
+  static inline Vec3_Type lerpGradients(const Vec3_Type &a, const Vec3_Type &b,
+                                        const Result_Type t) {
+    constexpr auto lerp = utils::lerp<Result_Type>;
+    return Vec3_Type(lerp(a.x, b.x, t), lerp(a.y, b.y, t), lerp(a.z, b.z, t));
+  }
+
+  [[no_unique_address]] std::conditional_t<
+      Gradients == PerlinGradients::Improved, NoGradients,
+      GradientTable<kTableSize, Result_Type, kGradientsLayout>> gradients{};
+  [[no_unique_address]] std::conditional_t<
+      kHashed, Unused, PermutationTable<kTableSize, Conv_Type, Layout>>
+      permutationTable{};
+  [[no_unique_address]] std::conditional_t<kHashed, LatticeHash, Unused>
+      lattice{};
 
   inline Conv_Type hash(const Conv_Type x, const Conv_Type y,
                         const Conv_Type z) const {
-    return permutationTable[permutationTable[permutationTable[x] + y] + z];
+    if constexpr (kHashed) {
+      return static_cast<Conv_Type>(lattice(x, y, z));
+    } else {
+      return permutationTable[permutationTable[permutationTable[x] + y] + z];
+    }
   }
 
   inline Conv_Type hash(const Conv_Type x, const Conv_Type y) const {
-    return permutationTable[permutationTable[x] + y];
+    if constexpr (kHashed) {
+      return static_cast<Conv_Type>(lattice(x, y));
+    } else {
+      return permutationTable[permutationTable[x] + y];
+    }
   }
 
-  inline Conv_Type hash(const Conv_Type x) const { return permutationTable[x]; }
+  inline Conv_Type hash(const Conv_Type x) const {
+    if constexpr (kHashed) {
+      return static_cast<Conv_Type>(lattice(x));
+    } else {
+      return permutationTable[x];
+    }
+  }
 };
 
 using PerlinNoise = PerlinNoise3D<>;
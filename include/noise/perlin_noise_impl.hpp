@@ -8,6 +8,7 @@
 #include "noise/perlin_noise.hpp"
 
 #include "noise/noise_remap.hpp"
+#include "noise/simd/noise_kernels.hpp"
 #include "utils/constants.hpp"
 #include "utils/fast_convertion.hpp"
 #include "utils/lerp.hpp"
@@ -16,8 +17,10 @@
 
 namespace noise {
 
-template <uint_least16_t Period, typename Engine, typename Result_Type>
-PerlinNoise3D<Period, Engine, Result_Type>::PerlinNoise3D(Seed_Type seed) {
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout, PerlinGradients Gradients>
+PerlinNoise3D<Period, Engine, Result_Type, Layout,
+              Gradients>::PerlinNoise3D(Seed_Type seed) {
   Dist distribution{low, high};
   Engine generator;
 
@@ -28,48 +31,73 @@ PerlinNoise3D<Period, Engine, Result_Type>::PerlinNoise3D(Seed_Type seed) {
   generator.seed(seed);
   for (auto i = 0; i < kTableSize; ++i) {
 
-    theta = std::acos(2.0 * dice() - 1.0);
-    phi = 2.0 * dice() * utils::pi<Result_Type>;
+    // The improved gradient set is fixed, only the permutation is drawn
+    if constexpr (Gradients == PerlinGradients::Random) {
+      theta = std::acos(2.0 * dice() - 1.0);
+      phi = 2.0 * dice() * utils::pi<Result_Type>;
 
-    gradients[i].x = std::cos(phi) * std::sin(theta);
-    gradients[i].y = std::sin(phi) * std::sin(theta);
-    gradients[i].z = std::cos(theta);
+      gradients.set(i, Vec3_Type(std::cos(phi) * std::sin(theta),
+                                 std::sin(phi) * std::sin(theta),
+                                 std::cos(theta)));
+    }
 
-    permutationTable[i] = i;
+    if constexpr (!kHashed) {
+      permutationTable.at(i) = i;
+    }
   }
 
-  // shuffle values of the permutation table
-  std::uniform_int_distribution distrUInt{0, kTableSizeMask};
-  auto randUInt = std::bind(distrUInt, generator);
-  for (auto k = 0; k < kTableSize; ++k) {
-    auto i = randUInt();
-    std::swap(permutationTable[k], permutationTable[i]);
-    permutationTable[k + kTableSize] = permutationTable[k];
+  if constexpr (kHashed) {
+    lattice = LatticeHash::draw<Engine>(seed);
+  } else {
+    // shuffle values of the permutation table
+    std::uniform_int_distribution distrUInt{0, kTableSizeMask};
+    auto randUInt = std::bind(distrUInt, generator);
+    for (auto k = 0; k < kTableSize; ++k) {
+      auto i = randUInt();
+      std::swap(permutationTable.at(k), permutationTable.at(i));
+      permutationTable.mirror(k);
+    }
   }
 }
 
-template <uint_least16_t Period, typename Engine, typename Result_Type>
-PerlinNoise3D<Period, Engine, Result_Type>::~PerlinNoise3D() = default;
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout, PerlinGradients Gradients>
+constexpr PerlinNoise3D<Period, Engine, Result_Type, Layout,
+                        Gradients>::PerlinNoise3D(const StaticSeed seed) {
+  utils::SplitMix64 generator{seed.value};
 
-template <uint_least16_t Period, typename Engine, typename Result_Type>
+  if constexpr (Gradients == PerlinGradients::Random) {
+    drawGradients(gradients, generator);
+  }
+
+  if constexpr (kHashed) {
+    lattice = LatticeHash::draw(generator);
+  } else {
+    drawPermutation(permutationTable, generator);
+  }
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout, PerlinGradients Gradients>
 Result_Type
-PerlinNoise3D<Period, Engine, Result_Type>::eval(const Result_Type x) const {
+PerlinNoise3D<Period, Engine, Result_Type, Layout,
+              Gradients>::eval(const Result_Type x) const {
 
   constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
 
   const Conv_Type posX = fast_int_trunc(x);
 
-  const Conv_Type xi0 = posX & kTableSizeMask;
+  const Conv_Type xi0 = posX & kLatticeMask;
 
-  const Conv_Type xi1 = (xi0 + 1) & kTableSizeMask;
+  const Conv_Type xi1 = (xi0 + 1) & kLatticeMask;
 
   const Result_Type tx = x - static_cast<Result_Type>(posX);
 
   const Result_Type u = perlinRemap<Result_Type>(tx);
 
   // gradients at the corner of the cell
-  const Vec3_Type &c0 = gradients[hash(xi0)];
-  const Vec3_Type &c1 = gradients[hash(xi1)];
+  const Corner_Type c0 = corner(hash(xi0));
+  const Corner_Type c1 = corner(hash(xi1));
 
   // generate vectors going from the grid points to p
   const Result_Type x0 = tx, x1 = tx - 1;
@@ -80,23 +108,25 @@ PerlinNoise3D<Period, Engine, Result_Type>::eval(const Result_Type x) const {
   // linear interpolation
   constexpr auto lerp = utils::lerp<Result_Type>;
 
-  return lerp(vector::dot(c0, p0), dot(c1, p1), u); // g
+  return lerp(cornerDot(c0, p0), cornerDot(c1, p1), u); // g
 }
 
-template <uint_least16_t Period, typename Engine, typename Result_Type>
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout, PerlinGradients Gradients>
 Result_Type
-PerlinNoise3D<Period, Engine, Result_Type>::eval(const Vec2_Type &p) const {
+PerlinNoise3D<Period, Engine, Result_Type, Layout,
+              Gradients>::eval(const Vec2_Type &p) const {
 
   constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
 
   const Conv_Type posX = fast_int_trunc(p.x);
   const Conv_Type posY = fast_int_trunc(p.y);
 
-  const Conv_Type xi0 = posX & kTableSizeMask;
-  const Conv_Type yi0 = posY & kTableSizeMask;
+  const Conv_Type xi0 = posX & kLatticeMask;
+  const Conv_Type yi0 = posY & kLatticeMask;
 
-  const Conv_Type xi1 = (xi0 + 1) & kTableSizeMask;
-  const Conv_Type yi1 = (yi0 + 1) & kTableSizeMask;
+  const Conv_Type xi1 = (xi0 + 1) & kLatticeMask;
+  const Conv_Type yi1 = (yi0 + 1) & kLatticeMask;
 
   const Result_Type tx = p.x - static_cast<Result_Type>(posX);
   const Result_Type ty = p.y - static_cast<Result_Type>(posY);
@@ -105,10 +135,10 @@ PerlinNoise3D<Period, Engine, Result_Type>::eval(const Vec2_Type &p) const {
   const Result_Type v = perlinRemap<Result_Type>(ty);
 
   // gradients at the corner of the cell
-  const Vec3_Type &c00 = gradients[hash(xi0, yi0)];
-  const Vec3_Type &c10 = gradients[hash(xi1, yi0)];
-  const Vec3_Type &c01 = gradients[hash(xi0, yi1)];
-  const Vec3_Type &c11 = gradients[hash(xi1, yi1)];
+  const Corner_Type c00 = corner(hash(xi0, yi0));
+  const Corner_Type c10 = corner(hash(xi1, yi0));
+  const Corner_Type c01 = corner(hash(xi0, yi1));
+  const Corner_Type c11 = corner(hash(xi1, yi1));
 
   // generate vectors going from the grid points to p
   const Result_Type x0 = tx, x1 = tx - 1;
@@ -121,15 +151,17 @@ PerlinNoise3D<Period, Engine, Result_Type>::eval(const Vec2_Type &p) const {
 
   // linear interpolation
   constexpr auto lerp = utils::lerp<Result_Type>;
-  const Result_Type a = lerp(vector::dot(c00, p00), dot(c10, p10), u);
-  const Result_Type b = lerp(vector::dot(c01, p01), dot(c11, p11), u);
+  const Result_Type a = lerp(cornerDot(c00, p00), cornerDot(c10, p10), u);
+  const Result_Type b = lerp(cornerDot(c01, p01), cornerDot(c11, p11), u);
 
   return lerp(a, b, v); // g
 }
 
-template <uint_least16_t Period, typename Engine, typename Result_Type>
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout, PerlinGradients Gradients>
 Result_Type
-PerlinNoise3D<Period, Engine, Result_Type>::eval(const Vec3_Type &p) const {
+PerlinNoise3D<Period, Engine, Result_Type, Layout,
+              Gradients>::eval(const Vec3_Type &p) const {
 
   constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
 
@@ -137,13 +169,13 @@ PerlinNoise3D<Period, Engine, Result_Type>::eval(const Vec3_Type &p) const {
   const Conv_Type posY = fast_int_trunc(p.y);
   const Conv_Type posZ = fast_int_trunc(p.z);
 
-  const Conv_Type xi0 = posX & kTableSizeMask;
-  const Conv_Type yi0 = posY & kTableSizeMask;
-  const Conv_Type zi0 = posZ & kTableSizeMask;
+  const Conv_Type xi0 = posX & kLatticeMask;
+  const Conv_Type yi0 = posY & kLatticeMask;
+  const Conv_Type zi0 = posZ & kLatticeMask;
 
-  const Conv_Type xi1 = (xi0 + 1) & kTableSizeMask;
-  const Conv_Type yi1 = (yi0 + 1) & kTableSizeMask;
-  const Conv_Type zi1 = (zi0 + 1) & kTableSizeMask;
+  const Conv_Type xi1 = (xi0 + 1) & kLatticeMask;
+  const Conv_Type yi1 = (yi0 + 1) & kLatticeMask;
+  const Conv_Type zi1 = (zi0 + 1) & kLatticeMask;
 
   const Result_Type tx = p.x - static_cast<Result_Type>(posX);
   const Result_Type ty = p.y - static_cast<Result_Type>(posY);
@@ -156,15 +188,15 @@ PerlinNoise3D<Period, Engine, Result_Type>::eval(const Vec3_Type &p) const {
   const Result_Type w = remap(tz);
 
   // gradients at the corner of the cell
-  const Vec3_Type &c000 = gradients[hash(xi0, yi0, zi0)];
-  const Vec3_Type &c100 = gradients[hash(xi1, yi0, zi0)];
-  const Vec3_Type &c010 = gradients[hash(xi0, yi1, zi0)];
-  const Vec3_Type &c110 = gradients[hash(xi1, yi1, zi0)];
+  const Corner_Type c000 = corner(hash(xi0, yi0, zi0));
+  const Corner_Type c100 = corner(hash(xi1, yi0, zi0));
+  const Corner_Type c010 = corner(hash(xi0, yi1, zi0));
+  const Corner_Type c110 = corner(hash(xi1, yi1, zi0));
 
-  const Vec3_Type &c001 = gradients[hash(xi0, yi0, zi1)];
-  const Vec3_Type &c101 = gradients[hash(xi1, yi0, zi1)];
-  const Vec3_Type &c011 = gradients[hash(xi0, yi1, zi1)];
-  const Vec3_Type &c111 = gradients[hash(xi1, yi1, zi1)];
+  const Corner_Type c001 = corner(hash(xi0, yi0, zi1));
+  const Corner_Type c101 = corner(hash(xi1, yi0, zi1));
+  const Corner_Type c011 = corner(hash(xi0, yi1, zi1));
+  const Corner_Type c111 = corner(hash(xi1, yi1, zi1));
 
   // generate vectors going from the grid points to p
   const Result_Type x0 = tx, x1 = tx - 1;
@@ -183,10 +215,10 @@ PerlinNoise3D<Period, Engine, Result_Type>::eval(const Vec3_Type &p) const {
 
   // linear interpolation
   constexpr auto lerp = utils::lerp<Result_Type>;
-  const Result_Type a = lerp(vector::dot(c000, p000), dot(c100, p100), u);
-  const Result_Type b = lerp(vector::dot(c010, p010), dot(c110, p110), u);
-  const Result_Type c = lerp(vector::dot(c001, p001), dot(c101, p101), u);
-  const Result_Type d = lerp(vector::dot(c011, p011), dot(c111, p111), u);
+  const Result_Type a = lerp(cornerDot(c000, p000), cornerDot(c100, p100), u);
+  const Result_Type b = lerp(cornerDot(c010, p010), cornerDot(c110, p110), u);
+  const Result_Type c = lerp(cornerDot(c001, p001), cornerDot(c101, p101), u);
+  const Result_Type d = lerp(cornerDot(c011, p011), cornerDot(c111, p111), u);
 
   const Result_Type e = lerp(a, b, v);
   const Result_Type f = lerp(c, d, v);
@@ -194,9 +226,69 @@ PerlinNoise3D<Period, Engine, Result_Type>::eval(const Vec3_Type &p) const {
   return lerp(e, f, w); // g
 }
 
-template <uint_least16_t Period, typename Engine, typename Result_Type>
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout, PerlinGradients Gradients>
+Result_Type
+PerlinNoise3D<Period, Engine, Result_Type, Layout,
+              Gradients>::eval(const Vec2_Type &p, Vec2_Type &deriv) const {
+
+  constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
+
+  const Conv_Type posX = fast_int_trunc(p.x);
+  const Conv_Type posY = fast_int_trunc(p.y);
+
+  const Conv_Type xi0 = posX & kLatticeMask;
+  const Conv_Type yi0 = posY & kLatticeMask;
+
+  const Conv_Type xi1 = (xi0 + 1) & kLatticeMask;
+  const Conv_Type yi1 = (yi0 + 1) & kLatticeMask;
+
+  const Result_Type tx = p.x - static_cast<Result_Type>(posX);
+  const Result_Type ty = p.y - static_cast<Result_Type>(posY);
+
+  const Result_Type u = perlinRemap<Result_Type>(tx);
+  const Result_Type v = perlinRemap<Result_Type>(ty);
+
+  const Result_Type du = perlinRemapDeriv<Result_Type>(tx);
+  const Result_Type dv = perlinRemapDeriv<Result_Type>(ty);
+
+  // gradients at the corner of the cell
+  const Corner_Type c00 = corner(hash(xi0, yi0));
+  const Corner_Type c10 = corner(hash(xi1, yi0));
+  const Corner_Type c01 = corner(hash(xi0, yi1));
+  const Corner_Type c11 = corner(hash(xi1, yi1));
+
+  // generate vectors going from the grid points to p
+  const Result_Type x0 = tx, x1 = tx - 1;
+  const Result_Type y0 = ty, y1 = ty - 1;
+
+  const Result_Type n00 = cornerDot(c00, Vec3_Type(x0, y0, 0));
+  const Result_Type n10 = cornerDot(c10, Vec3_Type(x1, y0, 0));
+  const Result_Type n01 = cornerDot(c01, Vec3_Type(x0, y1, 0));
+  const Result_Type n11 = cornerDot(c11, Vec3_Type(x1, y1, 0));
+
+  // linear interpolation
+  constexpr auto lerp = utils::lerp<Result_Type>;
+  const Result_Type a = lerp(n00, n10, u);
+  const Result_Type b = lerp(n01, n11, u);
+
+  // The derivative of the interpolation weights, plus the interpolated
+  // gradients, which are the derivatives of the corner dot products
+  const Vec3_Type g = lerpGradients(
+      lerpGradients(cornerGradient(c00), cornerGradient(c10), u),
+      lerpGradients(cornerGradient(c01), cornerGradient(c11), u), v);
+
+  deriv.x = du * lerp(n10 - n00, n11 - n01, v) + g.x;
+  deriv.y = dv * (b - a) + g.y;
+
+  return lerp(a, b, v); // g
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout, PerlinGradients Gradients>
 Result_Type
-PerlinNoise3D<Period, Engine, Result_Type>::eval(const Vec3_Type &p, Vec3_Type &deriv) const {
+PerlinNoise3D<Period, Engine, Result_Type, Layout,
+              Gradients>::eval(const Vec3_Type &p, Vec3_Type &deriv) const {
 
   constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
 
@@ -204,13 +296,13 @@ PerlinNoise3D<Period, Engine, Result_Type>::eval(const Vec3_Type &p, Vec3_Type &
   const Conv_Type posY = fast_int_trunc(p.y);
   const Conv_Type posZ = fast_int_trunc(p.z);
 
-  const Conv_Type xi0 = posX & kTableSizeMask;
-  const Conv_Type yi0 = posY & kTableSizeMask;
-  const Conv_Type zi0 = posZ & kTableSizeMask;
+  const Conv_Type xi0 = posX & kLatticeMask;
+  const Conv_Type yi0 = posY & kLatticeMask;
+  const Conv_Type zi0 = posZ & kLatticeMask;
 
-  const Conv_Type xi1 = (xi0 + 1) & kTableSizeMask;
-  const Conv_Type yi1 = (yi0 + 1) & kTableSizeMask;
-  const Conv_Type zi1 = (zi0 + 1) & kTableSizeMask;
+  const Conv_Type xi1 = (xi0 + 1) & kLatticeMask;
+  const Conv_Type yi1 = (yi0 + 1) & kLatticeMask;
+  const Conv_Type zi1 = (zi0 + 1) & kLatticeMask;
 
   const Result_Type tx = p.x - static_cast<Result_Type>(posX);
   const Result_Type ty = p.y - static_cast<Result_Type>(posY);
@@ -224,60 +316,237 @@ PerlinNoise3D<Period, Engine, Result_Type>::eval(const Vec3_Type &p, Vec3_Type &
 
   constexpr auto remapDeriv = perlinRemapDeriv<Result_Type>;
 
-  const Result_Type du = remapDeriv(tx); 
-  const Result_Type dv = remapDeriv(ty); 
-  const Result_Type dw = remapDeriv(tz); 
+  const Result_Type du = remapDeriv(tx);
+  const Result_Type dv = remapDeriv(ty);
+  const Result_Type dw = remapDeriv(tz);
 
   // gradients at the corner of the cell
-  const Vec3_Type &c000 = gradients[hash(xi0, yi0, zi0)];
-  const Vec3_Type &c100 = gradients[hash(xi1, yi0, zi0)];
-  const Vec3_Type &c010 = gradients[hash(xi0, yi1, zi0)];
-  const Vec3_Type &c110 = gradients[hash(xi1, yi1, zi0)];
+  const Corner_Type c000 = corner(hash(xi0, yi0, zi0));
+  const Corner_Type c100 = corner(hash(xi1, yi0, zi0));
+  const Corner_Type c010 = corner(hash(xi0, yi1, zi0));
+  const Corner_Type c110 = corner(hash(xi1, yi1, zi0));
 
-  const Vec3_Type &c001 = gradients[hash(xi0, yi0, zi1)];
-  const Vec3_Type &c101 = gradients[hash(xi1, yi0, zi1)];
-  const Vec3_Type &c011 = gradients[hash(xi0, yi1, zi1)];
-  const Vec3_Type &c111 = gradients[hash(xi1, yi1, zi1)];
+  const Corner_Type c001 = corner(hash(xi0, yi0, zi1));
+  const Corner_Type c101 = corner(hash(xi1, yi0, zi1));
+  const Corner_Type c011 = corner(hash(xi0, yi1, zi1));
+  const Corner_Type c111 = corner(hash(xi1, yi1, zi1));
 
   // generate vectors going from the grid points to p
   const Result_Type x0 = tx, x1 = tx - 1;
   const Result_Type y0 = ty, y1 = ty - 1;
   const Result_Type z0 = tz, z1 = tz - 1;
 
-  const Vec3_Type p000 = Vec3_Type(x0, y0, z0);
-  const Vec3_Type p100 = Vec3_Type(x1, y0, z0);
-  const Vec3_Type p010 = Vec3_Type(x0, y1, z0);
-  const Vec3_Type p110 = Vec3_Type(x1, y1, z0);
+  const Result_Type n000 = cornerDot(c000, Vec3_Type(x0, y0, z0));
+  const Result_Type n100 = cornerDot(c100, Vec3_Type(x1, y0, z0));
+  const Result_Type n010 = cornerDot(c010, Vec3_Type(x0, y1, z0));
+  const Result_Type n110 = cornerDot(c110, Vec3_Type(x1, y1, z0));
 
-  const Vec3_Type p001 = Vec3_Type(x0, y0, z1);
-  const Vec3_Type p101 = Vec3_Type(x1, y0, z1);
-  const Vec3_Type p011 = Vec3_Type(x0, y1, z1);
-  const Vec3_Type p111 = Vec3_Type(x1, y1, z1);
+  const Result_Type n001 = cornerDot(c001, Vec3_Type(x0, y0, z1));
+  const Result_Type n101 = cornerDot(c101, Vec3_Type(x1, y0, z1));
+  const Result_Type n011 = cornerDot(c011, Vec3_Type(x0, y1, z1));
+  const Result_Type n111 = cornerDot(c111, Vec3_Type(x1, y1, z1));
 
   // linear interpolation
+  constexpr auto lerp = utils::lerp<Result_Type>;
+  const Result_Type a = lerp(n000, n100, u);
+  const Result_Type b = lerp(n010, n110, u);
+  const Result_Type c = lerp(n001, n101, u);
+  const Result_Type d = lerp(n011, n111, u);
+
+  const Result_Type e = lerp(a, b, v);
+  const Result_Type f = lerp(c, d, v);
+
+  // The derivative of the interpolation weights, plus the interpolated
+  // gradients, which are the derivatives of the corner dot products
+  const Vec3_Type g = lerpGradients(
+      lerpGradients(
+          lerpGradients(cornerGradient(c000), cornerGradient(c100), u),
+          lerpGradients(cornerGradient(c010), cornerGradient(c110), u), v),
+      lerpGradients(
+          lerpGradients(cornerGradient(c001), cornerGradient(c101), u),
+          lerpGradients(cornerGradient(c011), cornerGradient(c111), u), v),
+      w);
+
+  const Result_Type dx0 = lerp(n100 - n000, n110 - n010, v);
+  const Result_Type dx1 = lerp(n101 - n001, n111 - n011, v);
+
+  deriv.x = du * lerp(dx0, dx1, w) + g.x;
+  deriv.y = dv * lerp(b - a, d - c, w) + g.y;
+  deriv.z = dw * (f - e) + g.z;
+
+  return lerp(e, f, w); // g
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout, PerlinGradients Gradients>
+void PerlinNoise3D<Period, Engine, Result_Type, Layout,
+                   Gradients>::evalGrid(
+    const Vec2_Type &origin, const Result_Type step, const std::size_t width,
+    const std::size_t height, Result_Type *out, const std::size_t stride,
+    const std::size_t column, const std::size_t row) const {
+
+  constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
+  constexpr auto remap = perlinRemap<Result_Type>;
+  constexpr auto lerp = utils::lerp<Result_Type>;
+
+  for (std::size_t j = 0; j < height; ++j) {
+    // Everything that only depends on y is computed once per row
+    const Result_Type py = origin.y + static_cast<Result_Type>(row + j) * step;
+    const Conv_Type posY = fast_int_trunc(py);
+    const Conv_Type yi0 = posY & kLatticeMask;
+    const Conv_Type yi1 = (yi0 + 1) & kLatticeMask;
+    const Result_Type ty = py - static_cast<Result_Type>(posY);
+    const Result_Type v = remap(ty);
+    const Result_Type y0 = ty, y1 = ty - 1;
+
+    Result_Type *dst = out + j * stride;
+
+    // Corner gradients of the current cell, refreshed when x crosses a cell
+    Corner_Type c00{}, c10{}, c01{}, c11{};
+    Conv_Type cellX{0};
+
+    for (std::size_t i = 0; i < width; ++i) {
+      const Result_Type px =
+          origin.x + static_cast<Result_Type>(column + i) * step;
+      const Conv_Type posX = fast_int_trunc(px);
+
+      if (i == 0 || posX != cellX) {
+        const Conv_Type xi0 = posX & kLatticeMask;
+        const Conv_Type xi1 = (xi0 + 1) & kLatticeMask;
+
+        c00 = corner(hash(xi0, yi0));
+        c10 = corner(hash(xi1, yi0));
+        c01 = corner(hash(xi0, yi1));
+        c11 = corner(hash(xi1, yi1));
+
+        cellX = posX;
+      }
+
+      const Result_Type tx = px - static_cast<Result_Type>(posX);
+      const Result_Type u = remap(tx);
+      const Result_Type x0 = tx, x1 = tx - 1;
+
+      const Vec3_Type p00 = Vec3_Type(x0, y0, 0);
+      const Vec3_Type p10 = Vec3_Type(x1, y0, 0);
+      const Vec3_Type p01 = Vec3_Type(x0, y1, 0);
+      const Vec3_Type p11 = Vec3_Type(x1, y1, 0);
+
+      const Result_Type a = lerp(cornerDot(c00, p00), cornerDot(c10, p10), u);
+      const Result_Type b = lerp(cornerDot(c01, p01), cornerDot(c11, p11), u);
+
+      dst[i] = lerp(a, b, v);
+    }
+  }
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout, PerlinGradients Gradients>
+void PerlinNoise3D<Period, Engine, Result_Type, Layout,
+                   Gradients>::evalGrid(
+    const Vec3_Type &origin, const Result_Type step, const std::size_t width,
+    const std::size_t height, Result_Type *out, const std::size_t stride,
+    const std::size_t column, const std::size_t row) const {
+
+  constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
+  constexpr auto remap = perlinRemap<Result_Type>;
+  constexpr auto lerp = utils::lerp<Result_Type>;
 
-  const Result_Type a = vector::dot(c000, p000); 
-  const Result_Type b = vector::dot(c100, p100); 
-  const Result_Type c = vector::dot(c010, p010); 
-  const Result_Type d = vector::dot(c110, p110); 
-  const Result_Type e = vector::dot(c001, p001); 
-  const Result_Type f = vector::dot(c101, p101); 
-  const Result_Type g = vector::dot(c011, p011); 
-  const Result_Type h = vector::dot(c111, p111); 
-
-  const Result_Type k0 = (b - a); 
-  const Result_Type k1 = (c - a); 
-  const Result_Type k2 = (e - a); 
-  const Result_Type k3 = (a + d - b - c); 
-  const Result_Type k4 = (a + f - b - e); 
-  const Result_Type k5 = (a + g - c - e); 
-  const Result_Type k6 = (b + c + e + h - a - d - f - g); 
-
-  derivs.x = du *(k0 + v * k3 + w * k4 + v * w * k6); 
-  derivs.y = dv *(k1 + u * k3 + w * k5 + u * w * k6); 
-  derivs.z = dw *(k2 + u * k4 + v * k5 + u * v * k6); 
-
-  return a + u * k0 + v * k1 + w * k2 + u * v * k3 + u * w * k4 + v * w * k5 + u * v * w * k6;
+  // The slice has a constant z
+  const Conv_Type posZ = fast_int_trunc(origin.z);
+  const Conv_Type zi0 = posZ & kLatticeMask;
+  const Conv_Type zi1 = (zi0 + 1) & kLatticeMask;
+  const Result_Type tz = origin.z - static_cast<Result_Type>(posZ);
+  const Result_Type w = remap(tz);
+  const Result_Type z0 = tz, z1 = tz - 1;
+
+  for (std::size_t j = 0; j < height; ++j) {
+    const Result_Type py = origin.y + static_cast<Result_Type>(row + j) * step;
+    const Conv_Type posY = fast_int_trunc(py);
+    const Conv_Type yi0 = posY & kLatticeMask;
+    const Conv_Type yi1 = (yi0 + 1) & kLatticeMask;
+    const Result_Type ty = py - static_cast<Result_Type>(posY);
+    const Result_Type v = remap(ty);
+    const Result_Type y0 = ty, y1 = ty - 1;
+
+    Result_Type *dst = out + j * stride;
+
+    std::array<Corner_Type, 8> g{};
+    Conv_Type cellX{0};
+
+    for (std::size_t i = 0; i < width; ++i) {
+      const Result_Type px =
+          origin.x + static_cast<Result_Type>(column + i) * step;
+      const Conv_Type posX = fast_int_trunc(px);
+
+      if (i == 0 || posX != cellX) {
+        const Conv_Type xi0 = posX & kLatticeMask;
+        const Conv_Type xi1 = (xi0 + 1) & kLatticeMask;
+
+        g[0] = corner(hash(xi0, yi0, zi0));
+        g[1] = corner(hash(xi1, yi0, zi0));
+        g[2] = corner(hash(xi0, yi1, zi0));
+        g[3] = corner(hash(xi1, yi1, zi0));
+        g[4] = corner(hash(xi0, yi0, zi1));
+        g[5] = corner(hash(xi1, yi0, zi1));
+        g[6] = corner(hash(xi0, yi1, zi1));
+        g[7] = corner(hash(xi1, yi1, zi1));
+
+        cellX = posX;
+      }
+
+      const Result_Type tx = px - static_cast<Result_Type>(posX);
+      const Result_Type u = remap(tx);
+      const Result_Type x0 = tx, x1 = tx - 1;
+
+      const Result_Type a = lerp(cornerDot(g[0], Vec3_Type(x0, y0, z0)),
+                                 cornerDot(g[1], Vec3_Type(x1, y0, z0)), u);
+      const Result_Type b = lerp(cornerDot(g[2], Vec3_Type(x0, y1, z0)),
+                                 cornerDot(g[3], Vec3_Type(x1, y1, z0)), u);
+      const Result_Type c = lerp(cornerDot(g[4], Vec3_Type(x0, y0, z1)),
+                                 cornerDot(g[5], Vec3_Type(x1, y0, z1)), u);
+      const Result_Type d = lerp(cornerDot(g[6], Vec3_Type(x0, y1, z1)),
+                                 cornerDot(g[7], Vec3_Type(x1, y1, z1)), u);
+
+      const Result_Type e = lerp(a, b, v);
+      const Result_Type f = lerp(c, d, v);
+
+      dst[i] = lerp(e, f, w);
+    }
+  }
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout, PerlinGradients Gradients>
+void PerlinNoise3D<Period, Engine, Result_Type, Layout,
+                   Gradients>::evalBatch(
+    const Result_Type *x, const Result_Type *y, const Result_Type *z,
+    const std::size_t count, Result_Type *out) const {
+
+  if constexpr (kHasKernels) {
+    static_assert(sizeof(Vec3_Type) == 3 * sizeof(Result_Type),
+                  "Gradients must be packed {x, y, z} triples");
+    const bool done = simd::dispatch([&](auto kernels) {
+      if constexpr (kHashed && Gradients == PerlinGradients::Improved) {
+        kernels.perlin3DImprovedHashed(lattice, x, y, z, count, out);
+      } else if constexpr (kHashed) {
+        kernels.perlin3DHashed(lattice, gradients.data(), kTableSizeMask, x,
+                               y, z, count, out);
+      } else if constexpr (Gradients == PerlinGradients::Improved) {
+        kernels.perlin3DImproved(permutationTable.data(), kTableSizeMask, x, y,
+                                 z, count, out);
+      } else {
+        kernels.perlin3D(permutationTable.data(), gradients.data(),
+                         kTableSizeMask, x, y, z, count, out);
+      }
+    });
+    if (done) {
+      return;
+    }
+  }
+
+  for (std::size_t k = 0; k < count; ++k) {
+    out[k] = eval(Vec3_Type(x[k], y[k], z[k]));
+  }
 }
 
 } // namespace noise
@@ -0,0 +1,200 @@
+#ifndef PIXEL_STAGES_H
+#define PIXEL_STAGES_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "noise/simd/noise_kernels.hpp"
+#include "noise/tiled_generator.hpp"
+#include "utils/image_writer.hpp"
+#include "utils/thread_pool.hpp"
+
+namespace noise {
+
+// Output stages turn a run of noise samples into pixels: stage(samples,
+// count, pixels). generateGridPixels runs them on each row of a tile right
+// after it is produced, while it is in L1, so the display-only rasters are
+// never held as floats
+
+// Samples in [low, high] as the full range of an unsigned Pixel (uint8_t or
+// uint16_t), saturated outside of it. The scale is 2^bits - 1 and the
+// fraction is dropped, as utils::ImageWriter does for [0, 1] samples: with
+// the default range the pixels are the ones of its PGM8 and PGM16 files.
+// Float samples are converted by the widest vector kernel the CPU supports
+// (noise::simd::dispatch)
+template <typename Pixel> class QuantizeStage {
+public:
+  static_assert(std::is_same_v<Pixel, std::uint8_t> ||
+                    std::is_same_v<Pixel, std::uint16_t>,
+                "Pixel must be uint8_t or uint16_t");
+
+  explicit QuantizeStage(const float low = 0, const float high = 1)
+      : low(low), scale(1 / (high - low)) {
+    assert(low < high && "The range must not be empty");
+  }
+
+  template <typename T>
+  void operator()(const T *samples, const std::size_t count,
+                  Pixel *out) const {
+    constexpr T kMax = std::numeric_limits<Pixel>::max();
+    if constexpr (std::is_same_v<T, float>) {
+      const bool done = simd::dispatch([&](auto kernels) {
+        kernels.quantize(low, scale, kMax, samples, count, out);
+      });
+      if (done) {
+        return;
+      }
+    }
+
+    const T l = static_cast<T>(low), s = static_cast<T>(scale);
+    for (std::size_t k = 0; k < count; ++k) {
+      // As the max and min of the kernels, a NaN gives 0
+      T v = (samples[k] - l) * s;
+      v = v > T(0) ? v : T(0);
+      v = v < T(1) ? v : T(1);
+      out[k] = static_cast<Pixel>(static_cast<std::int32_t>(v * kMax));
+    }
+  }
+
+private:
+  float low, scale;
+};
+
+// Color of a gradient at position (in [0, 1])
+struct ColorStop {
+  float position;
+  std::uint8_t r, g, b, a = 255;
+};
+
+// Samples in [low, high] colored by the gradient through stops (sorted by
+// position), looked up in a table of lutSize colors: one load per pixel.
+// Pixel is utils::Rgb8, or uint32_t for RGBA8 packed as noise::packNormal
+// (red in the lowest byte, RGBA in memory on little endian machines), which
+// float samples look up with vector gathers
+template <typename Pixel> class ColorizeStage {
+public:
+  static_assert(std::is_same_v<Pixel, utils::Rgb8> ||
+                    std::is_same_v<Pixel, std::uint32_t>,
+                "Pixel must be utils::Rgb8 or uint32_t");
+
+  ColorizeStage(const std::vector<ColorStop> &stops, const float low = 0,
+                const float high = 1, const std::size_t lutSize = 256);
+
+  template <typename T>
+  void operator()(const T *samples, const std::size_t count,
+                  Pixel *out) const {
+    const T last = static_cast<T>(lut.size() - 1);
+    if constexpr (std::is_same_v<T, float> &&
+                  std::is_same_v<Pixel, std::uint32_t>) {
+      const bool done = simd::dispatch([&](auto kernels) {
+        kernels.colorize(lut.data(), low, scale, last, samples, count, out);
+      });
+      if (done) {
+        return;
+      }
+    }
+
+    const T l = static_cast<T>(low), s = static_cast<T>(scale);
+    const Pixel *colors = lut.data();
+    for (std::size_t k = 0; k < count; ++k) {
+      // Nearest entry, the scale already holds lutSize - 1
+      T v = (samples[k] - l) * s;
+      v = v > T(0) ? v : T(0);
+      v = v < last ? v : last;
+      out[k] = colors[static_cast<std::int32_t>(v + T(0.5))];
+    }
+  }
+
+  const std::vector<Pixel> &colors() const { return lut; }
+
+private:
+  float low, scale;
+  std::vector<Pixel> lut;
+};
+
+template <typename Pixel>
+ColorizeStage<Pixel>::ColorizeStage(const std::vector<ColorStop> &stops,
+                                    const float low, const float high,
+                                    const std::size_t lutSize)
+    : low(low), scale((lutSize - 1) / (high - low)), lut(lutSize) {
+  assert(!stops.empty() && lutSize >= 2 &&
+         lutSize <= std::size_t{INT32_MAX} && low < high &&
+         "The gradient needs a stop, the table 2 entries, the range values");
+
+  // Each entry interpolates the stops around its position, the ends hold
+  // the first and the last stop
+  std::size_t next = 0;
+  for (std::size_t e = 0; e < lutSize; ++e) {
+    const float x = static_cast<float>(e) / static_cast<float>(lutSize - 1);
+    while (next < stops.size() && stops[next].position < x) {
+      ++next;
+    }
+    const ColorStop &hi = stops[std::min(next, stops.size() - 1)];
+    const ColorStop &lo = stops[next == 0 ? 0 : next - 1];
+    const float span = hi.position - lo.position;
+    const float t =
+        span > 0 ? std::min(std::max((x - lo.position) / span, 0.0f), 1.0f)
+                 : 1.0f;
+    const auto channel = [t](const std::uint8_t a, const std::uint8_t b) {
+      return static_cast<std::uint8_t>(a + (b - a) * t + 0.5f);
+    };
+
+    const std::uint8_t r = channel(lo.r, hi.r);
+    const std::uint8_t g = channel(lo.g, hi.g);
+    const std::uint8_t b = channel(lo.b, hi.b);
+    if constexpr (std::is_same_v<Pixel, utils::Rgb8>) {
+      lut[e] = utils::Rgb8{r, g, b};
+    } else {
+      lut[e] = std::uint32_t{r} | std::uint32_t{g} << 8 |
+               std::uint32_t{b} << 16 |
+               std::uint32_t{channel(lo.a, hi.a)} << 24;
+    }
+  }
+}
+
+// Side of the blocks of samples generateGridPixels produces before handing
+// them to the stage: the default tile, 16 KB of floats, stays in L1
+constexpr std::size_t kPixelStageBlock = kDefaultTileSize;
+
+// generateGrid fused with stage: the samples of noise.evalGrid(origin, step,
+// width, height) go through stage (e.g. QuantizeStage or ColorizeStage)
+// straight into out (rows stride pixels apart). Tiles are produced in
+// blocks of up to kPixelStageBlock^2 samples, in a buffer on the stack of
+// the task, and converted row by row while in cache. out starts at raster
+// row row, as for generateGrid
+template <typename Noise, typename Vec_Type, typename T, typename Stage,
+          typename Pixel>
+void generateGridPixels(utils::ThreadPool &pool, const Noise &noise,
+                        const Vec_Type &origin, const T step,
+                        const std::size_t width, const std::size_t height,
+                        const Stage &stage, Pixel *out,
+                        const std::size_t stride,
+                        const std::size_t tileSize = kDefaultTileSize,
+                        const std::size_t row = 0) {
+  generateTiles(
+      pool, width, height, out, stride,
+      [&](const Tile &tile, Pixel *tileOut) {
+        T samples[kPixelStageBlock * kPixelStageBlock];
+        for (std::size_t j = 0; j < tile.height; j += kPixelStageBlock) {
+          const std::size_t h = std::min(kPixelStageBlock, tile.height - j);
+          for (std::size_t i = 0; i < tile.width; i += kPixelStageBlock) {
+            const std::size_t w = std::min(kPixelStageBlock, tile.width - i);
+            noise.evalGrid(origin, step, w, h, samples, w, tile.x + i,
+                           row + tile.y + j);
+            for (std::size_t r = 0; r < h; ++r) {
+              stage(samples + r * w, w, tileOut + (j + r) * stride + i);
+            }
+          }
+        }
+      },
+      tileSize);
+}
+
+} // namespace noise
+
+#endif // !PIXEL_STAGES_H
@@ -0,0 +1,101 @@
+#ifndef SHARED_NOISE_H
+#define SHARED_NOISE_H
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "noise/noise_range.hpp"
+
+namespace noise {
+
+// Process wide registry of the instances of Noise (ValueNoise1D,
+// ValueNoiseND, PerlinNoise3D or SimplexNoise) built so far, keyed by seed.
+// Period, Engine, layout and every other parameter are part of the type, so
+// each instantiation has its own registry. An instance is built on the
+// first request for its seed and lives as long as a handle on it does;
+// it is never modified afterwards, so any number of threads can share it
+template <typename Noise> class NoiseRegistry {
+public:
+  using Seed_Type = typename Noise::Seed_Type;
+
+  // The instance for seed, built if no handle on it is alive. Thread safe.
+  // The lock is held while the tables are drawn, so concurrent requests for
+  // a new seed build it once
+  static std::shared_ptr<const Noise> acquire(const Seed_Type seed);
+
+  // Number of distinct instances alive
+  static std::size_t size();
+
+private:
+  static NoiseRegistry &instance();
+
+  // Drop the entries whose instance has been released
+  void prune();
+
+  std::mutex mutex;
+  std::map<Seed_Type, std::weak_ptr<const Noise>> entries;
+};
+
+// Handle on the instance of Noise that NoiseRegistry holds for a seed. All
+// the handles with the same seed share the one set of tables: a handle is
+// the size of a std::shared_ptr, copying it only bumps the reference count
+// and moving it is free. Evaluation goes through one more indirection than
+// on Noise itself, and samples the same values. Every eval, evalGrid and
+// evalBatch overload of Noise is forwarded, so a handle can be used as the
+// base of FractalNoise or NormalizedNoise and with noise::generateGrid
+template <typename Noise> class SharedNoise {
+public:
+  using Noise_Type = Noise;
+  using Seed_Type = typename Noise::Seed_Type;
+  using Result_Type = typename Noise::Value_Type;
+  using Value_Type = Result_Type;
+
+  static constexpr bool kSignedOutput = Noise::kSignedOutput;
+
+  SharedNoise(const Seed_Type seed = 2011);
+
+  template <typename... Args>
+  auto eval(Args &&... args) const
+      -> decltype(std::declval<const Noise &>().eval(
+          std::forward<Args>(args)...)) {
+    return noise->eval(std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  auto evalGrid(Args &&... args) const
+      -> decltype(std::declval<const Noise &>().evalGrid(
+          std::forward<Args>(args)...)) {
+    return noise->evalGrid(std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  auto evalBatch(Args &&... args) const
+      -> decltype(std::declval<const Noise &>().evalBatch(
+          std::forward<Args>(args)...)) {
+    return noise->evalBatch(std::forward<Args>(args)...);
+  }
+
+  Range<Result_Type> outputRange(const unsigned dimension) const {
+    return noise->outputRange(dimension);
+  }
+
+  const Noise &base() const { return *noise; }
+
+  Seed_Type seed() const { return noiseSeed; }
+
+  // Number of handles sharing the tables, this one included
+  long useCount() const { return noise.use_count(); }
+
+private:
+  std::shared_ptr<const Noise> noise;
+  Seed_Type noiseSeed;
+};
+
+} // namespace noise
+
+#include "noise/shared_noise_impl.hpp"
+
+#endif // !SHARED_NOISE_H
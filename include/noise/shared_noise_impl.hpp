@@ -0,0 +1,56 @@
+#ifndef SHARED_NOISE_IMPL_H
+#define SHARED_NOISE_IMPL_H
+
+#include "noise/shared_noise.hpp"
+
+namespace noise {
+
+template <typename Noise>
+NoiseRegistry<Noise> &NoiseRegistry<Noise>::instance() {
+  // Built on first use, so it is ready for the noises of static objects
+  static NoiseRegistry registry;
+  return registry;
+}
+
+template <typename Noise>
+std::shared_ptr<const Noise>
+NoiseRegistry<Noise>::acquire(const Seed_Type seed) {
+  NoiseRegistry &registry = instance();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  std::weak_ptr<const Noise> &entry = registry.entries[seed];
+  std::shared_ptr<const Noise> noise = entry.lock();
+  if (!noise) {
+    // The released instances are only swept when a new one is built, which
+    // keeps the map to the seeds in use without a callback per release
+    registry.prune();
+    noise = std::make_shared<const Noise>(seed);
+    registry.entries[seed] = noise;
+  }
+  return noise;
+}
+
+template <typename Noise> std::size_t NoiseRegistry<Noise>::size() {
+  NoiseRegistry &registry = instance();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  std::size_t alive = 0;
+  for (const auto &entry : registry.entries) {
+    alive += !entry.second.expired();
+  }
+  return alive;
+}
+
+template <typename Noise> void NoiseRegistry<Noise>::prune() {
+  for (auto it = entries.begin(); it != entries.end();) {
+    it = it->second.expired() ? entries.erase(it) : std::next(it);
+  }
+}
+
+template <typename Noise>
+SharedNoise<Noise>::SharedNoise(const Seed_Type seed)
+    : noise(NoiseRegistry<Noise>::acquire(seed)), noiseSeed(seed) {}
+
+} // namespace noise
+
+#endif // !SHARED_NOISE_IMPL_H
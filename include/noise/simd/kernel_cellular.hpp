@@ -0,0 +1,54 @@
+#ifndef KERNEL_CELLULAR_H
+#define KERNEL_CELLULAR_H
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "noise/cellular_metric.hpp"
+
+namespace noise::simd {
+
+// Cells around the one of a sample, 3^N of them
+template <std::size_t N> constexpr std::size_t kNeighborCells = N == 2 ? 9 : 27;
+
+// Offsets in {-1, 0, 1} along each axis of the neighbor cells, by rings:
+// the cell of the sample, then the ones differing from it on 1, 2... axes,
+// i.e. by increasing lower bound of their distance
+template <std::size_t N>
+constexpr std::array<std::array<int, N>, kNeighborCells<N>> neighborRings() {
+  std::array<std::array<int, N>, kNeighborCells<N>> rings{};
+  std::size_t next = 0;
+  for (std::size_t ring = 0; ring <= N; ++ring) {
+    for (std::size_t c = 0; c < kNeighborCells<N>; ++c) {
+      std::array<int, N> offset{};
+      std::size_t moved = 0;
+      for (std::size_t a = 0, rest = c; a < N; ++a, rest /= 3) {
+        offset[a] = static_cast<int>(rest % 3) - 1;
+        moved += offset[a] != 0;
+      }
+      if (moved == ring) {
+        rings[next++] = offset;
+      }
+    }
+  }
+  return rings;
+}
+
+namespace detail {
+template <typename Fn, std::size_t... C>
+constexpr void forEachIndex(Fn &fn, std::index_sequence<C...>) {
+  (fn(std::integral_constant<std::size_t, C>{}), ...);
+}
+} // namespace detail
+
+// Call fn(std::integral_constant<std::size_t, C>) for each index C of the
+// neighborRings, in order, so that fn sees the offsets as constants
+template <std::size_t N, typename Fn> constexpr void forEachNeighbor(Fn &&fn) {
+  detail::forEachIndex(fn, std::make_index_sequence<kNeighborCells<N>>{});
+}
+
+} // namespace noise::simd
+
+#endif // !KERNEL_CELLULAR_H
@@ -0,0 +1,24 @@
+#ifndef KERNEL_REMAP_H
+#define KERNEL_REMAP_H
+
+#include "noise/noise_remap.hpp"
+
+namespace noise::simd {
+
+// Remap functions the batch kernels have a vector version of
+enum class KernelRemap { None, Smoothstep, Perlin };
+
+template <typename T, RemapFunction<T> Remap_Func>
+constexpr KernelRemap kernelRemap() {
+  if constexpr (Remap_Func == smoothstepRemap<T>) {
+    return KernelRemap::Smoothstep;
+  } else if constexpr (Remap_Func == perlinRemap<T>) {
+    return KernelRemap::Perlin;
+  } else {
+    return KernelRemap::None;
+  }
+}
+
+} // namespace noise::simd
+
+#endif // !KERNEL_REMAP_H
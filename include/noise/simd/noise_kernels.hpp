@@ -0,0 +1,71 @@
+#ifndef NOISE_KERNELS_H
+#define NOISE_KERNELS_H
+
+#include <atomic>
+
+#include "noise/simd/kernel_remap.hpp"
+#include "noise/simd/noise_kernels_avx2.hpp"
+#include "noise/simd/noise_kernels_avx512.hpp"
+#include "noise/simd/noise_kernels_sse42.hpp"
+#include "utils/cpu_features.hpp"
+#include "utils/simd_target.hpp"
+
+namespace noise::simd {
+
+// Widest kernel set this CPU supports, detected once on first use
+inline utils::SimdLevel detectedLevel() {
+  static const utils::SimdLevel level = utils::detectSimdLevel();
+  return level;
+}
+
+namespace detail {
+inline std::atomic<utils::SimdLevel> &activeLevel() {
+  static std::atomic<utils::SimdLevel> level{detectedLevel()};
+  return level;
+}
+} // namespace detail
+
+// Kernel set the evalBatch entry points run
+inline utils::SimdLevel activeLevel() {
+  return detail::activeLevel().load(std::memory_order_relaxed);
+}
+
+inline const char *activeKernelName() {
+  return utils::simdLevelName(activeLevel());
+}
+
+// Restrict the entry points to level, e.g. to compare kernels. It is clamped
+// to detectedLevel() and the level actually selected is returned
+inline utils::SimdLevel setActiveLevel(const utils::SimdLevel level) {
+  const utils::SimdLevel selected =
+      level < detectedLevel() ? level : detectedLevel();
+  detail::activeLevel().store(selected, std::memory_order_relaxed);
+  return selected;
+}
+
+// Call fn with the Kernels of the active level. Returns false, without
+// calling fn, when the scalar path is active
+template <typename Fn> inline bool dispatch(Fn &&fn) {
+#if NOISE_SIMD_X86
+  switch (activeLevel()) {
+  case utils::SimdLevel::AVX512:
+    fn(avx512::Kernels{});
+    return true;
+  case utils::SimdLevel::AVX2:
+    fn(avx2::Kernels{});
+    return true;
+  case utils::SimdLevel::SSE42:
+    fn(sse42::Kernels{});
+    return true;
+  default:
+    break;
+  }
+#else
+  (void)fn;
+#endif
+  return false;
+}
+
+} // namespace noise::simd
+
+#endif // !NOISE_KERNELS_H
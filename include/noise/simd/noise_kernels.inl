@@ -0,0 +1,1372 @@
+// Batch noise kernels shared by every ISA.
+//
+// This file is included once per ISA, inside the namespace and the target
+// region of that ISA and right after its Ops wrapper, so it has no include
+// guard and must not include anything itself.
+//
+// Each kernel evaluates the same expressions, in the same order, as the
+// scalar eval it mirrors and never fuses a multiply with an add. As long as
+// the compiler does not contract the scalar code into FMAs either (the
+// default unless FMA is part of the baseline ISA, e.g. -march=native), the
+// results are bit-identical to the scalar path.
+
+struct Kernels {
+  using Float = Ops::Float;
+  using Int = Ops::Int;
+
+  static constexpr std::size_t kWidth = Ops::kWidth;
+
+  // t * t * (3 - 2 * t), see noise::smoothstepRemap
+  static inline Float smoothstepRemap(const Float t) {
+    const Float a = Ops::sub(Ops::set1(3.0f), Ops::mul(Ops::set1(2.0f), t));
+    return Ops::mul(Ops::mul(t, t), a);
+  }
+
+  // t * t * t * (10 - 15 * t + 6 * t * t), see noise::perlinRemap
+  static inline Float perlinRemap(const Float t) {
+    const Float t3 = Ops::mul(Ops::mul(t, t), t);
+    const Float a = Ops::sub(Ops::set1(10.0f), Ops::mul(Ops::set1(15.0f), t));
+    const Float b = Ops::mul(Ops::mul(Ops::set1(6.0f), t), t);
+    return Ops::mul(t3, Ops::add(a, b));
+  }
+
+  template <KernelRemap Remap> static inline Float remap(const Float t) {
+    static_assert(Remap != KernelRemap::None,
+                  "The kernels have no vector version of this remap");
+    if constexpr (Remap == KernelRemap::Smoothstep) {
+      return smoothstepRemap(t);
+    } else {
+      return perlinRemap(t);
+    }
+  }
+
+  // lo * (1 - t) + hi * t, see utils::lerp
+  static inline Float lerp(const Float lo, const Float hi, const Float t) {
+    return Ops::add(Ops::mul(lo, Ops::sub(Ops::set1(1.0f), t)),
+                    Ops::mul(hi, t));
+  }
+
+  // Lattice coordinate of p (as utils::fast_int_trunc) and its fraction
+  static inline Int cell(const Float p, Float &t) {
+    const Int pi = Ops::toInt(Ops::floor(p));
+    t = Ops::sub(p, Ops::toFloat(pi));
+    return pi;
+  }
+
+  // Dot product between the gradient at index h of an array of packed
+  // {x, y, z} floats and (px, py, pz)
+  static inline Float gradientDot(const float *gradients, const Int h,
+                                  const Float px, const Float py,
+                                  const Float pz) {
+    const Int h3 = Ops::addi(Ops::addi(h, h), h);
+    const Float gx = Ops::gatherf(gradients, h3);
+    const Float gy = Ops::gatherf(gradients + 1, h3);
+    const Float gz = Ops::gatherf(gradients + 2, h3);
+    return Ops::add(Ops::add(Ops::mul(gx, px), Ops::mul(gy, py)),
+                    Ops::mul(gz, pz));
+  }
+
+  // Dot product between the improved gradient selected by the low 4 bits of
+  // h and (px, py, pz), see noise::improvedGradientDot
+  static inline Float improvedGradientDot(const Int h, const Float px,
+                                          const Float py, const Float pz) {
+    const Int zero = Ops::set1i(0);
+    const Int b = Ops::andi(h, Ops::set1i(15));
+
+    // u = b < 8 ? x : y
+    const Float u =
+        Ops::select(Ops::cmpeqi(Ops::andi(b, Ops::set1i(8)), zero), px, py);
+    // v = b < 4 ? y : (b == 12 || b == 14 ? x : z)
+    const Int low = Ops::cmpeqi(Ops::andi(b, Ops::set1i(12)), zero);
+    const Int xz = Ops::cmpeqi(Ops::andi(b, Ops::set1i(13)), Ops::set1i(12));
+    const Float v = Ops::select(low, py, Ops::select(xz, px, pz));
+
+    const Int one = Ops::set1i(1), two = Ops::set1i(2);
+    const Float su = Ops::flipSign(u, Ops::cmpeqi(Ops::andi(b, one), one));
+    const Float sv = Ops::flipSign(v, Ops::cmpeqi(Ops::andi(b, two), two));
+    return Ops::add(su, sv);
+  }
+
+  // perm[perm[x] + y] and the 3D and 4D chains, see SimplexNoise::hash
+  static inline Int latticeHash(const std::int32_t *perm, const Int x,
+                                const Int y) {
+    return Ops::gather(perm, Ops::addi(Ops::gather(perm, x), y));
+  }
+
+  static inline Int latticeHash(const std::int32_t *perm, const Int x,
+                                const Int y, const Int z) {
+    return Ops::gather(perm, Ops::addi(latticeHash(perm, x, y), z));
+  }
+
+  static inline Int latticeHash(const std::int32_t *perm, const Int x,
+                                const Int y, const Int z, const Int w) {
+    return Ops::gather(perm, Ops::addi(latticeHash(perm, x, y, z), w));
+  }
+
+  // Lattices of the value and Perlin kernels. start(x) is the hash prefix of
+  // the corners of first coordinate x, extend(h, axis, c) adds the
+  // coordinate c of axis, finish(h) is the hash of a prefix covering every
+  // axis and value(h) its random value. wrap(c) brings a coordinate into the
+  // period of the lattice, if it has one
+
+  // Chains through the doubled permutation table, see ValueNoiseND::hashStart
+  struct TableLattice {
+    const std::int32_t *perm;
+    const float *r; // random values, for value noise only
+    Int mask;
+
+    inline Int wrap(const Int c) const { return Ops::andi(c, mask); }
+    inline Int start(const Int x) const { return Ops::gather(perm, x); }
+    inline Int extend(const Int h, const std::size_t, const Int c) const {
+      return Ops::gather(perm, Ops::addi(h, c));
+    }
+    inline Int finish(const Int h) const { return h; }
+    inline Float value(const Int h) const { return Ops::gatherf(r, h); }
+  };
+
+  // noise::LatticeHash, which does not wrap. shifts are the ones of the
+  // first 3 axes
+  struct HashLattice {
+    Int seed;
+    Int shifts[3];
+
+    inline Int wrap(const Int c) const { return c; }
+    inline Int start(const Int x) const { return extend(seed, 0, x); }
+    inline Int extend(const Int h, const std::size_t axis, const Int c) const {
+      const auto prime = static_cast<std::int32_t>(LatticeHash::kPrimes[axis]);
+      return Ops::xori(
+          h, Ops::addi(Ops::muli(c, Ops::set1i(prime)), shifts[axis]));
+    }
+    inline Int finish(Int h) const {
+      const auto a0 = static_cast<std::int32_t>(LatticeHash::kAvalanche[0]);
+      const auto a1 = static_cast<std::int32_t>(LatticeHash::kAvalanche[1]);
+      h = Ops::xori(h, Ops::srli<16>(h));
+      h = Ops::muli(h, Ops::set1i(a0));
+      h = Ops::xori(h, Ops::srli<15>(h));
+      h = Ops::muli(h, Ops::set1i(a1));
+      return Ops::xori(h, Ops::srli<16>(h));
+    }
+    // LatticeHash::toUnit of the hash
+    inline Float value(const Int h) const {
+      return Ops::mul(Ops::toFloat(Ops::srli<8>(finish(h))),
+                      Ops::set1(1.0f / 16777216.0f));
+    }
+  };
+
+  static inline TableLattice tableLattice(const std::int32_t *perm,
+                                          const float *r,
+                                          const std::int32_t mask) {
+    return TableLattice{perm, r, Ops::set1i(mask)};
+  }
+
+  static inline HashLattice hashLattice(const LatticeHash &hash) {
+    HashLattice lattice;
+    lattice.seed = Ops::set1i(static_cast<std::int32_t>(hash.data()));
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+      lattice.shifts[axis] =
+          Ops::set1i(static_cast<std::int32_t>(hash.shift(axis)));
+    }
+    return lattice;
+  }
+
+  // Mirrors SimplexNoise::gradientDot(h, x, y)
+  static inline Float simplexGradientDot(const Int h, const Float px,
+                                         const Float py) {
+    const Int zero = Ops::set1i(0);
+    const Int b = Ops::andi(h, Ops::set1i(7));
+
+    // u, v = b < 4 ? x, y : y, x
+    const Int low = Ops::cmpeqi(Ops::andi(b, Ops::set1i(4)), zero);
+    const Float u = Ops::select(low, px, py);
+    const Float v = Ops::select(low, py, px);
+
+    const Int one = Ops::set1i(1), two = Ops::set1i(2);
+    const Float su = Ops::flipSign(u, Ops::cmpeqi(Ops::andi(b, one), one));
+    const Float sv = Ops::flipSign(Ops::mul(Ops::set1(2.0f), v),
+                                   Ops::cmpeqi(Ops::andi(b, two), two));
+    return Ops::add(su, sv);
+  }
+
+  // Mirrors SimplexNoise::gradientDot(h, x, y, z, w)
+  static inline Float simplexGradientDot(const Int h, const Float px,
+                                         const Float py, const Float pz,
+                                         const Float pw) {
+    const Int zero = Ops::set1i(0);
+    const Int b = Ops::andi(h, Ops::set1i(31));
+    const Int b24 = Ops::andi(b, Ops::set1i(24));
+
+    // u = b < 24 ? x : y, v = b < 16 ? y : z, t = b < 8 ? z : w
+    const Float u = Ops::select(Ops::cmpeqi(b24, Ops::set1i(24)), py, px);
+    const Float v =
+        Ops::select(Ops::cmpeqi(Ops::andi(b, Ops::set1i(16)), zero), py, pz);
+    const Float t = Ops::select(Ops::cmpeqi(b24, zero), pz, pw);
+
+    const Int one = Ops::set1i(1), two = Ops::set1i(2), four = Ops::set1i(4);
+    const Float su = Ops::flipSign(u, Ops::cmpeqi(Ops::andi(b, one), one));
+    const Float sv = Ops::flipSign(v, Ops::cmpeqi(Ops::andi(b, two), two));
+    const Float st = Ops::flipSign(t, Ops::cmpeqi(Ops::andi(b, four), four));
+    return Ops::add(Ops::add(su, sv), st);
+  }
+
+  // max(t, 0)^4 * gd, see SimplexNoise::falloff
+  static inline Float simplexFalloff(const Float t, const Float gd) {
+    const Float zero = Ops::set1(0.0f);
+    const Float c = Ops::select(Ops::cmplt(zero, t), t, zero);
+    const Float c2 = Ops::mul(c, c);
+    return Ops::mul(Ops::mul(c2, c2), gd);
+  }
+
+  // (a > b ? ra : rb) += 1, ranking the coordinates of a simplex sample
+  static inline void simplexRank(const Float a, const Float b, Int &ra,
+                                 Int &rb) {
+    const Int greater = Ops::cmplt(b, a);
+    ra = Ops::subi(ra, greater);
+    rb = Ops::addi(rb, Ops::addi(Ops::set1i(1), greater));
+  }
+
+  // 1 where rank >= least, 0 elsewhere
+  static inline Int simplexStep(const Int rank, const std::int32_t least) {
+    return Ops::andi(Ops::cmpgti(rank, Ops::set1i(least - 1)),
+                     Ops::set1i(1));
+  }
+
+  // Run block on every kWidth wide chunk of the count samples. The tail goes
+  // through zero padded local copies so block never reads past the inputs
+  template <std::size_t Inputs, typename Block>
+  static inline void forEachBlock(const float *const (&in)[Inputs],
+                                  const std::size_t count, float *out,
+                                  Block block) {
+    const float *chunk[Inputs];
+    std::size_t k = 0;
+    for (; k + kWidth <= count; k += kWidth) {
+      for (std::size_t c = 0; c < Inputs; ++c) {
+        chunk[c] = in[c] + k;
+      }
+      block(chunk, out + k);
+    }
+
+    if (k < count) {
+      const std::size_t rest = count - k;
+      alignas(64) float tail[Inputs][kWidth] = {};
+      alignas(64) float tailOut[kWidth] = {};
+      for (std::size_t c = 0; c < Inputs; ++c) {
+        for (std::size_t l = 0; l < rest; ++l) {
+          tail[c][l] = in[c][k + l];
+        }
+        chunk[c] = tail[c];
+      }
+      block(chunk, tailOut);
+      for (std::size_t l = 0; l < rest; ++l) {
+        out[k + l] = tailOut[l];
+      }
+    }
+  }
+
+  // Mirrors ValueNoise1D::eval. r is the table of random values
+  template <KernelRemap Remap>
+  static inline void valueNoise1D(const float *r, const std::int32_t mask,
+                                  const float *x, const std::size_t count,
+                                  float *out) {
+    const Int vmask = Ops::set1i(mask);
+    const Int one = Ops::set1i(1);
+
+    const float *const in[1] = {x};
+    forEachBlock(in, count, out, [&](const float *const (&p)[1], float *dst) {
+      Float t;
+      const Int xi = cell(Ops::load(p[0]), t);
+
+      const Int xMin = Ops::andi(xi, vmask);
+      const Int xMax = Ops::andi(Ops::addi(xMin, one), vmask);
+
+      const Float tx = remap<Remap>(t);
+
+      Ops::store(dst, lerp(Ops::gatherf(r, xMin), Ops::gatherf(r, xMax), tx));
+    });
+  }
+
+  // Mirrors ValueNoise1D::eval with the hashed layout
+  template <KernelRemap Remap>
+  static inline void valueNoise1DHashed(const LatticeHash &hash,
+                                        const float *x,
+                                        const std::size_t count, float *out) {
+    const HashLattice lattice = hashLattice(hash);
+    const Int one = Ops::set1i(1);
+
+    const float *const in[1] = {x};
+    forEachBlock(in, count, out, [&](const float *const (&p)[1], float *dst) {
+      Float t;
+      const Int xi = cell(Ops::load(p[0]), t);
+
+      const Float tx = remap<Remap>(t);
+
+      const Float c0 = lattice.value(lattice.start(xi));
+      const Float c1 = lattice.value(lattice.start(Ops::addi(xi, one)));
+      Ops::store(dst, lerp(c0, c1, tx));
+    });
+  }
+
+  // Mirrors ValueNoiseND::eval(const Vec2_Type &). perm is the doubled
+  // permutation table, r the table of random values
+  template <KernelRemap Remap>
+  static inline void valueNoise2D(const std::int32_t *perm, const float *r,
+                                  const std::int32_t mask, const float *x,
+                                  const float *y, const std::size_t count,
+                                  float *out) {
+    valueNoise2DWith<Remap>(tableLattice(perm, r, mask), x, y, count, out);
+  }
+
+  // Same with the hashed layout
+  template <KernelRemap Remap>
+  static inline void valueNoise2DHashed(const LatticeHash &hash,
+                                        const float *x, const float *y,
+                                        const std::size_t count, float *out) {
+    valueNoise2DWith<Remap>(hashLattice(hash), x, y, count, out);
+  }
+
+  template <KernelRemap Remap, typename Lattice>
+  static inline void valueNoise2DWith(const Lattice &lattice, const float *x,
+                                      const float *y, const std::size_t count,
+                                      float *out) {
+    const Int one = Ops::set1i(1);
+
+    const float *const in[2] = {x, y};
+    forEachBlock(in, count, out, [&](const float *const (&p)[2], float *dst) {
+      Float tx, ty;
+      const Int xi = cell(Ops::load(p[0]), tx);
+      const Int yi = cell(Ops::load(p[1]), ty);
+
+      const Int rx0 = lattice.wrap(xi);
+      const Int rx1 = lattice.wrap(Ops::addi(rx0, one));
+      const Int ry0 = lattice.wrap(yi);
+      const Int ry1 = lattice.wrap(Ops::addi(ry0, one));
+
+      const Int hx0 = lattice.start(rx0);
+      const Int hx1 = lattice.start(rx1);
+
+      const Float c00 = lattice.value(lattice.extend(hx0, 1, ry0));
+      const Float c10 = lattice.value(lattice.extend(hx1, 1, ry0));
+      const Float c01 = lattice.value(lattice.extend(hx0, 1, ry1));
+      const Float c11 = lattice.value(lattice.extend(hx1, 1, ry1));
+
+      const Float sx = remap<Remap>(tx);
+      const Float sy = remap<Remap>(ty);
+
+      const Float nx0 = lerp(c00, c10, sx);
+      const Float nx1 = lerp(c01, c11, sx);
+
+      Ops::store(dst, lerp(nx0, nx1, sy));
+    });
+  }
+
+  // Mirrors ValueNoiseND::eval(const Vec3_Type &)
+  template <KernelRemap Remap>
+  static inline void valueNoise3D(const std::int32_t *perm, const float *r,
+                                  const std::int32_t mask, const float *x,
+                                  const float *y, const float *z,
+                                  const std::size_t count, float *out) {
+    valueNoise3DWith<Remap>(tableLattice(perm, r, mask), x, y, z, count, out);
+  }
+
+  template <KernelRemap Remap>
+  static inline void valueNoise3DHashed(const LatticeHash &hash,
+                                        const float *x, const float *y,
+                                        const float *z,
+                                        const std::size_t count, float *out) {
+    valueNoise3DWith<Remap>(hashLattice(hash), x, y, z, count, out);
+  }
+
+  template <KernelRemap Remap, typename Lattice>
+  static inline void valueNoise3DWith(const Lattice &lattice, const float *x,
+                                      const float *y, const float *z,
+                                      const std::size_t count, float *out) {
+    const Int one = Ops::set1i(1);
+
+    const float *const in[3] = {x, y, z};
+    forEachBlock(in, count, out, [&](const float *const (&p)[3], float *dst) {
+      Float tx, ty, tz;
+      const Int xi = cell(Ops::load(p[0]), tx);
+      const Int yi = cell(Ops::load(p[1]), ty);
+      const Int zi = cell(Ops::load(p[2]), tz);
+
+      const Int rx0 = lattice.wrap(xi);
+      const Int rx1 = lattice.wrap(Ops::addi(rx0, one));
+      const Int ry0 = lattice.wrap(yi);
+      const Int ry1 = lattice.wrap(Ops::addi(ry0, one));
+      const Int rz0 = lattice.wrap(zi);
+      const Int rz1 = lattice.wrap(Ops::addi(rz0, one));
+
+      const Int hx0 = lattice.start(rx0);
+      const Int hx1 = lattice.start(rx1);
+
+      const Int h00 = lattice.extend(hx0, 1, ry0);
+      const Int h10 = lattice.extend(hx1, 1, ry0);
+      const Int h01 = lattice.extend(hx0, 1, ry1);
+      const Int h11 = lattice.extend(hx1, 1, ry1);
+
+      auto corner = [&](const Int h, const Int rz) {
+        return lattice.value(lattice.extend(h, 2, rz));
+      };
+
+      const Float sx = remap<Remap>(tx);
+      const Float sy = remap<Remap>(ty);
+      const Float sz = remap<Remap>(tz);
+
+      const Float nx00 = lerp(corner(h00, rz0), corner(h10, rz0), sx);
+      const Float nx10 = lerp(corner(h01, rz0), corner(h11, rz0), sx);
+      const Float nx01 = lerp(corner(h00, rz1), corner(h10, rz1), sx);
+      const Float nx11 = lerp(corner(h01, rz1), corner(h11, rz1), sx);
+
+      const Float ny10 = lerp(nx00, nx10, sy);
+      const Float ny11 = lerp(nx01, nx11, sy);
+
+      Ops::store(dst, lerp(ny10, ny11, sz));
+    });
+  }
+
+  // Mirrors PerlinNoise3D::eval(const Vec3_Type &). gradients is the table
+  // of packed {x, y, z} floats
+  static inline void perlin3D(const std::int32_t *perm, const float *gradients,
+                              const std::int32_t mask, const float *x,
+                              const float *y, const float *z,
+                              const std::size_t count, float *out) {
+    perlin3DWith(tableLattice(perm, nullptr, mask), x, y, z, count, out,
+                 [gradients](const Int h, const Float px, const Float py,
+                             const Float pz) {
+                   return gradientDot(gradients, h, px, py, pz);
+                 });
+  }
+
+  // Same for the improved gradient set, which needs no gradients table
+  static inline void perlin3DImproved(const std::int32_t *perm,
+                                      const std::int32_t mask, const float *x,
+                                      const float *y, const float *z,
+                                      const std::size_t count, float *out) {
+    perlin3DWith(tableLattice(perm, nullptr, mask), x, y, z, count, out,
+                 improvedGradientDot);
+  }
+
+  // The hashed layout, whose hashes index the gradients table modulo its
+  // size mask + 1
+  static inline void perlin3DHashed(const LatticeHash &hash,
+                                    const float *gradients,
+                                    const std::int32_t mask, const float *x,
+                                    const float *y, const float *z,
+                                    const std::size_t count, float *out) {
+    const Int vmask = Ops::set1i(mask);
+    perlin3DWith(hashLattice(hash), x, y, z, count, out,
+                 [gradients, vmask](const Int h, const Float px,
+                                    const Float py, const Float pz) {
+                   return gradientDot(gradients, Ops::andi(h, vmask), px, py,
+                                      pz);
+                 });
+  }
+
+  static inline void perlin3DImprovedHashed(const LatticeHash &hash,
+                                            const float *x, const float *y,
+                                            const float *z,
+                                            const std::size_t count,
+                                            float *out) {
+    perlin3DWith(hashLattice(hash), x, y, z, count, out, improvedGradientDot);
+  }
+
+  // Body of the Perlin kernels, cornerDot(h, px, py, pz) being the dot
+  // product between the gradient of the corner of hash h and (px, py, pz)
+  template <typename Lattice, typename CornerDot>
+  static inline void perlin3DWith(const Lattice &lattice, const float *x,
+                                  const float *y, const float *z,
+                                  const std::size_t count, float *out,
+                                  CornerDot cornerDot) {
+    const Int one = Ops::set1i(1);
+    const Float fone = Ops::set1(1.0f);
+
+    const float *const in[3] = {x, y, z};
+    forEachBlock(in, count, out, [&](const float *const (&p)[3], float *dst) {
+      Float tx, ty, tz;
+      const Int posX = cell(Ops::load(p[0]), tx);
+      const Int posY = cell(Ops::load(p[1]), ty);
+      const Int posZ = cell(Ops::load(p[2]), tz);
+
+      const Int xi0 = lattice.wrap(posX);
+      const Int yi0 = lattice.wrap(posY);
+      const Int zi0 = lattice.wrap(posZ);
+
+      const Int xi1 = lattice.wrap(Ops::addi(xi0, one));
+      const Int yi1 = lattice.wrap(Ops::addi(yi0, one));
+      const Int zi1 = lattice.wrap(Ops::addi(zi0, one));
+
+      const Float u = perlinRemap(tx);
+      const Float v = perlinRemap(ty);
+      const Float w = perlinRemap(tz);
+
+      // hash(x, y, z), e.g. perm[perm[perm[x] + y] + z], sharing the prefixes
+      const Int hx0 = lattice.start(xi0);
+      const Int hx1 = lattice.start(xi1);
+
+      const Int h00 = lattice.extend(hx0, 1, yi0);
+      const Int h10 = lattice.extend(hx1, 1, yi0);
+      const Int h01 = lattice.extend(hx0, 1, yi1);
+      const Int h11 = lattice.extend(hx1, 1, yi1);
+
+      auto corner = [&](const Int h, const Int zi) {
+        return lattice.finish(lattice.extend(h, 2, zi));
+      };
+
+      const Int h000 = corner(h00, zi0);
+      const Int h100 = corner(h10, zi0);
+      const Int h010 = corner(h01, zi0);
+      const Int h110 = corner(h11, zi0);
+      const Int h001 = corner(h00, zi1);
+      const Int h101 = corner(h10, zi1);
+      const Int h011 = corner(h01, zi1);
+      const Int h111 = corner(h11, zi1);
+
+      // vectors going from the grid points to p
+      const Float x0 = tx, x1 = Ops::sub(tx, fone);
+      const Float y0 = ty, y1 = Ops::sub(ty, fone);
+      const Float z0 = tz, z1 = Ops::sub(tz, fone);
+
+      const Float a = lerp(cornerDot(h000, x0, y0, z0),
+                           cornerDot(h100, x1, y0, z0), u);
+      const Float b = lerp(cornerDot(h010, x0, y1, z0),
+                           cornerDot(h110, x1, y1, z0), u);
+      const Float c = lerp(cornerDot(h001, x0, y0, z1),
+                           cornerDot(h101, x1, y0, z1), u);
+      const Float d = lerp(cornerDot(h011, x0, y1, z1),
+                           cornerDot(h111, x1, y1, z1), u);
+
+      const Float e = lerp(a, b, v);
+      const Float f = lerp(c, d, v);
+
+      Ops::store(dst, lerp(e, f, w));
+    });
+  }
+
+  // Mirrors SimplexNoise::eval(const Vec2_Type &)
+  static inline void simplex2D(const std::int32_t *perm,
+                               const std::int32_t mask, const float *x,
+                               const float *y, const std::size_t count,
+                               float *out) {
+    constexpr float kF2 = static_cast<float>(0.36602540378443864676);
+    constexpr float kG2 = static_cast<float>(0.21132486540518711775);
+    const Int vmask = Ops::set1i(mask);
+    const Int one = Ops::set1i(1);
+    const Float fone = Ops::set1(1.0f);
+    const Float g1 = Ops::set1(kG2), g2 = Ops::set1(2 * kG2);
+    const Float r2 = Ops::set1(0.5f);
+
+    const float *const in[2] = {x, y};
+    forEachBlock(in, count, out, [&](const float *const (&p)[2], float *dst) {
+      const Float px = Ops::load(p[0]);
+      const Float py = Ops::load(p[1]);
+
+      const Float s = Ops::mul(Ops::add(px, py), Ops::set1(kF2));
+      const Int i = Ops::toInt(Ops::floor(Ops::add(px, s)));
+      const Int j = Ops::toInt(Ops::floor(Ops::add(py, s)));
+
+      const Float t = Ops::mul(Ops::toFloat(Ops::addi(i, j)), g1);
+      const Float x0 = Ops::sub(px, Ops::sub(Ops::toFloat(i), t));
+      const Float y0 = Ops::sub(py, Ops::sub(Ops::toFloat(j), t));
+
+      const Int i1 = Ops::andi(Ops::cmplt(y0, x0), one);
+      const Int j1 = Ops::subi(one, i1);
+
+      const Float x1 = Ops::add(Ops::sub(x0, Ops::toFloat(i1)), g1);
+      const Float y1 = Ops::add(Ops::sub(y0, Ops::toFloat(j1)), g1);
+      const Float x2 = Ops::add(Ops::sub(x0, fone), g2);
+      const Float y2 = Ops::add(Ops::sub(y0, fone), g2);
+
+      const Int ii = Ops::andi(i, vmask);
+      const Int jj = Ops::andi(j, vmask);
+
+      auto corner = [&](const Int di, const Int dj, const Float dx,
+                        const Float dy) {
+        const Int h =
+            latticeHash(perm, Ops::andi(Ops::addi(ii, di), vmask),
+                        Ops::andi(Ops::addi(jj, dj), vmask));
+        const Float r =
+            Ops::sub(Ops::sub(r2, Ops::mul(dx, dx)), Ops::mul(dy, dy));
+        return simplexFalloff(r, simplexGradientDot(h, dx, dy));
+      };
+
+      const Int zero = Ops::set1i(0);
+      const Float n0 = corner(zero, zero, x0, y0);
+      const Float n1 = corner(i1, j1, x1, y1);
+      const Float n2 = corner(one, one, x2, y2);
+
+      Ops::store(dst, Ops::mul(Ops::set1(40.0f),
+                               Ops::add(Ops::add(n0, n1), n2)));
+    });
+  }
+
+  // Mirrors SimplexNoise::eval(const Vec3_Type &)
+  static inline void simplex3D(const std::int32_t *perm,
+                               const std::int32_t mask, const float *x,
+                               const float *y, const float *z,
+                               const std::size_t count, float *out) {
+    constexpr float kF3 = static_cast<float>(1.0 / 3.0);
+    constexpr float kG3 = static_cast<float>(1.0 / 6.0);
+    const Int vmask = Ops::set1i(mask);
+    const Int zero = Ops::set1i(0), one = Ops::set1i(1);
+    const Float fone = Ops::set1(1.0f);
+    const Float g1 = Ops::set1(kG3), g2 = Ops::set1(2 * kG3),
+                g3 = Ops::set1(3 * kG3);
+    const Float r2 = Ops::set1(0.5f);
+
+    const float *const in[3] = {x, y, z};
+    forEachBlock(in, count, out, [&](const float *const (&p)[3], float *dst) {
+      const Float px = Ops::load(p[0]);
+      const Float py = Ops::load(p[1]);
+      const Float pz = Ops::load(p[2]);
+
+      const Float s =
+          Ops::mul(Ops::add(Ops::add(px, py), pz), Ops::set1(kF3));
+      const Int i = Ops::toInt(Ops::floor(Ops::add(px, s)));
+      const Int j = Ops::toInt(Ops::floor(Ops::add(py, s)));
+      const Int k = Ops::toInt(Ops::floor(Ops::add(pz, s)));
+
+      const Float t =
+          Ops::mul(Ops::toFloat(Ops::addi(Ops::addi(i, j), k)), g1);
+      const Float x0 = Ops::sub(px, Ops::sub(Ops::toFloat(i), t));
+      const Float y0 = Ops::sub(py, Ops::sub(Ops::toFloat(j), t));
+      const Float z0 = Ops::sub(pz, Ops::sub(Ops::toFloat(k), t));
+
+      Int rankX = zero, rankY = zero, rankZ = zero;
+      simplexRank(x0, y0, rankX, rankY);
+      simplexRank(x0, z0, rankX, rankZ);
+      simplexRank(y0, z0, rankY, rankZ);
+
+      const Int ii = Ops::andi(i, vmask);
+      const Int jj = Ops::andi(j, vmask);
+      const Int kk = Ops::andi(k, vmask);
+
+      auto corner = [&](const Int di, const Int dj, const Int dk,
+                        const Float dx, const Float dy, const Float dz) {
+        const Int h =
+            latticeHash(perm, Ops::andi(Ops::addi(ii, di), vmask),
+                        Ops::andi(Ops::addi(jj, dj), vmask),
+                        Ops::andi(Ops::addi(kk, dk), vmask));
+        const Float r = Ops::sub(
+            Ops::sub(Ops::sub(r2, Ops::mul(dx, dx)), Ops::mul(dy, dy)),
+            Ops::mul(dz, dz));
+        return simplexFalloff(r, improvedGradientDot(h, dx, dy, dz));
+      };
+
+      // Inner corners of the simplex, offsets from them to p
+      auto inner = [&](const std::int32_t least, const Float g) {
+        const Int di = simplexStep(rankX, least);
+        const Int dj = simplexStep(rankY, least);
+        const Int dk = simplexStep(rankZ, least);
+        return corner(di, dj, dk,
+                      Ops::add(Ops::sub(x0, Ops::toFloat(di)), g),
+                      Ops::add(Ops::sub(y0, Ops::toFloat(dj)), g),
+                      Ops::add(Ops::sub(z0, Ops::toFloat(dk)), g));
+      };
+
+      const Float n0 = corner(zero, zero, zero, x0, y0, z0);
+      const Float n1 = inner(2, g1);
+      const Float n2 = inner(1, g2);
+      const Float n3 = corner(one, one, one, Ops::add(Ops::sub(x0, fone), g3),
+                              Ops::add(Ops::sub(y0, fone), g3),
+                              Ops::add(Ops::sub(z0, fone), g3));
+
+      const Float sum = Ops::add(Ops::add(Ops::add(n0, n1), n2), n3);
+      Ops::store(dst, Ops::mul(Ops::set1(74.0f), sum));
+    });
+  }
+
+  // Mirrors SimplexNoise::eval(const Vec4_Type &)
+  static inline void simplex4D(const std::int32_t *perm,
+                               const std::int32_t mask, const float *x,
+                               const float *y, const float *z, const float *w,
+                               const std::size_t count, float *out) {
+    constexpr float kF4 = static_cast<float>(0.30901699437494742410);
+    constexpr float kG4 = static_cast<float>(0.13819660112501051518);
+    const Int vmask = Ops::set1i(mask);
+    const Int zero = Ops::set1i(0), one = Ops::set1i(1);
+    const Float fone = Ops::set1(1.0f);
+    const Float g1 = Ops::set1(kG4), g2 = Ops::set1(2 * kG4),
+                g3 = Ops::set1(3 * kG4), g4 = Ops::set1(4 * kG4);
+    const Float r2 = Ops::set1(0.5f);
+
+    const float *const in[4] = {x, y, z, w};
+    forEachBlock(in, count, out, [&](const float *const (&p)[4], float *dst) {
+      const Float px = Ops::load(p[0]);
+      const Float py = Ops::load(p[1]);
+      const Float pz = Ops::load(p[2]);
+      const Float pw = Ops::load(p[3]);
+
+      const Float s = Ops::mul(
+          Ops::add(Ops::add(Ops::add(px, py), pz), pw), Ops::set1(kF4));
+      const Int i = Ops::toInt(Ops::floor(Ops::add(px, s)));
+      const Int j = Ops::toInt(Ops::floor(Ops::add(py, s)));
+      const Int k = Ops::toInt(Ops::floor(Ops::add(pz, s)));
+      const Int l = Ops::toInt(Ops::floor(Ops::add(pw, s)));
+
+      const Float t = Ops::mul(
+          Ops::toFloat(Ops::addi(Ops::addi(Ops::addi(i, j), k), l)), g1);
+      const Float x0 = Ops::sub(px, Ops::sub(Ops::toFloat(i), t));
+      const Float y0 = Ops::sub(py, Ops::sub(Ops::toFloat(j), t));
+      const Float z0 = Ops::sub(pz, Ops::sub(Ops::toFloat(k), t));
+      const Float w0 = Ops::sub(pw, Ops::sub(Ops::toFloat(l), t));
+
+      Int rankX = zero, rankY = zero, rankZ = zero, rankW = zero;
+      simplexRank(x0, y0, rankX, rankY);
+      simplexRank(x0, z0, rankX, rankZ);
+      simplexRank(x0, w0, rankX, rankW);
+      simplexRank(y0, z0, rankY, rankZ);
+      simplexRank(y0, w0, rankY, rankW);
+      simplexRank(z0, w0, rankZ, rankW);
+
+      const Int ii = Ops::andi(i, vmask);
+      const Int jj = Ops::andi(j, vmask);
+      const Int kk = Ops::andi(k, vmask);
+      const Int ll = Ops::andi(l, vmask);
+
+      auto corner = [&](const Int di, const Int dj, const Int dk,
+                        const Int dl, const Float dx, const Float dy,
+                        const Float dz, const Float dw) {
+        const Int h =
+            latticeHash(perm, Ops::andi(Ops::addi(ii, di), vmask),
+                        Ops::andi(Ops::addi(jj, dj), vmask),
+                        Ops::andi(Ops::addi(kk, dk), vmask),
+                        Ops::andi(Ops::addi(ll, dl), vmask));
+        const Float r = Ops::sub(
+            Ops::sub(Ops::sub(Ops::sub(r2, Ops::mul(dx, dx)),
+                              Ops::mul(dy, dy)),
+                     Ops::mul(dz, dz)),
+            Ops::mul(dw, dw));
+        return simplexFalloff(r, simplexGradientDot(h, dx, dy, dz, dw));
+      };
+
+      auto inner = [&](const std::int32_t least, const Float g) {
+        const Int di = simplexStep(rankX, least);
+        const Int dj = simplexStep(rankY, least);
+        const Int dk = simplexStep(rankZ, least);
+        const Int dl = simplexStep(rankW, least);
+        return corner(di, dj, dk, dl,
+                      Ops::add(Ops::sub(x0, Ops::toFloat(di)), g),
+                      Ops::add(Ops::sub(y0, Ops::toFloat(dj)), g),
+                      Ops::add(Ops::sub(z0, Ops::toFloat(dk)), g),
+                      Ops::add(Ops::sub(w0, Ops::toFloat(dl)), g));
+      };
+
+      const Float n0 = corner(zero, zero, zero, zero, x0, y0, z0, w0);
+      const Float n1 = inner(3, g1);
+      const Float n2 = inner(2, g2);
+      const Float n3 = inner(1, g3);
+      const Float n4 = corner(one, one, one, one,
+                              Ops::add(Ops::sub(x0, fone), g4),
+                              Ops::add(Ops::sub(y0, fone), g4),
+                              Ops::add(Ops::sub(z0, fone), g4),
+                              Ops::add(Ops::sub(w0, fone), g4));
+
+      const Float sum =
+          Ops::add(Ops::add(Ops::add(Ops::add(n0, n1), n2), n3), n4);
+      Ops::store(dst, Ops::mul(Ops::set1(60.0f), sum));
+    });
+  }
+
+  // Mirrors BakedTexture::eval(const Vec2_Type &). The grid has mask + 1
+  // samples per side, in bricks of 2^Shift per side whose strides are the
+  // distances between neighbouring bricks along each axis
+  template <int Shift>
+  static inline void bakedTexture2D(const float *samples,
+                                    const std::int32_t mask,
+                                    const std::int32_t (&strides)[2],
+                                    const float (&origin)[2],
+                                    const float inverseStep, const float *x,
+                                    const float *y, const std::size_t count,
+                                    float *out) {
+    const Int vmask = Ops::set1i(mask);
+    const Int one = Ops::set1i(1);
+
+    const float *const in[2] = {x, y};
+    forEachBlock(in, count, out, [&](const float *const (&p)[2], float *dst) {
+      Float tx, ty;
+      const Int x0 = textureCell(Ops::load(p[0]), origin[0], inverseStep,
+                                 vmask, tx);
+      const Int y0 = textureCell(Ops::load(p[1]), origin[1], inverseStep,
+                                 vmask, ty);
+
+      const Int ox0 = textureOffset<Shift, 0>(x0, strides[0]);
+      const Int ox1 =
+          textureOffset<Shift, 0>(Ops::andi(Ops::addi(x0, one), vmask),
+                                  strides[0]);
+      const Int oy0 = textureOffset<Shift, 1>(y0, strides[1]);
+      const Int oy1 =
+          textureOffset<Shift, 1>(Ops::andi(Ops::addi(y0, one), vmask),
+                                  strides[1]);
+
+      const Float n0 = lerp(Ops::gatherf(samples, Ops::addi(ox0, oy0)),
+                            Ops::gatherf(samples, Ops::addi(ox1, oy0)), tx);
+      const Float n1 = lerp(Ops::gatherf(samples, Ops::addi(ox0, oy1)),
+                            Ops::gatherf(samples, Ops::addi(ox1, oy1)), tx);
+      Ops::store(dst, lerp(n0, n1, ty));
+    });
+  }
+
+  // Mirrors BakedTexture::eval(const Vec3_Type &)
+  template <int Shift>
+  static inline void bakedTexture3D(const float *samples,
+                                    const std::int32_t mask,
+                                    const std::int32_t (&strides)[3],
+                                    const float (&origin)[3],
+                                    const float inverseStep, const float *x,
+                                    const float *y, const float *z,
+                                    const std::size_t count, float *out) {
+    const Int vmask = Ops::set1i(mask);
+    const Int one = Ops::set1i(1);
+
+    const float *const in[3] = {x, y, z};
+    forEachBlock(in, count, out, [&](const float *const (&p)[3], float *dst) {
+      Float tx, ty, tz;
+      const Int x0 = textureCell(Ops::load(p[0]), origin[0], inverseStep,
+                                 vmask, tx);
+      const Int y0 = textureCell(Ops::load(p[1]), origin[1], inverseStep,
+                                 vmask, ty);
+      const Int z0 = textureCell(Ops::load(p[2]), origin[2], inverseStep,
+                                 vmask, tz);
+
+      const Int ox0 = textureOffset<Shift, 0>(x0, strides[0]);
+      const Int ox1 =
+          textureOffset<Shift, 0>(Ops::andi(Ops::addi(x0, one), vmask),
+                                  strides[0]);
+      const Int oy0 = textureOffset<Shift, 1>(y0, strides[1]);
+      const Int oy1 =
+          textureOffset<Shift, 1>(Ops::andi(Ops::addi(y0, one), vmask),
+                                  strides[1]);
+      const Int oz0 = textureOffset<Shift, 2>(z0, strides[2]);
+      const Int oz1 =
+          textureOffset<Shift, 2>(Ops::andi(Ops::addi(z0, one), vmask),
+                                  strides[2]);
+
+      auto face = [&](const Int oz) {
+        const Int o00 = Ops::addi(oy0, oz), o01 = Ops::addi(oy1, oz);
+        const Float n0 =
+            lerp(Ops::gatherf(samples, Ops::addi(ox0, o00)),
+                 Ops::gatherf(samples, Ops::addi(ox1, o00)), tx);
+        const Float n1 =
+            lerp(Ops::gatherf(samples, Ops::addi(ox0, o01)),
+                 Ops::gatherf(samples, Ops::addi(ox1, o01)), tx);
+        return lerp(n0, n1, ty);
+      };
+      Ops::store(dst, lerp(face(oz0), face(oz1), tz));
+    });
+  }
+
+  // Wrapped grid coordinate of p and its fraction, see BakedTexture::cell
+  static inline Int textureCell(const Float p, const float origin,
+                                const float inverseStep, const Int mask,
+                                Float &t) {
+    const Float u =
+        Ops::mul(Ops::sub(p, Ops::set1(origin)), Ops::set1(inverseStep));
+    return Ops::andi(cell(u, t), mask);
+  }
+
+  // Part of the sample index of the grid coordinates c along Axis, see
+  // BakedTexture::offset
+  template <int Shift, int Axis>
+  static inline Int textureOffset(const Int c, const std::int32_t stride) {
+    const Int inner = Ops::andi(c, Ops::set1i((1 << Shift) - 1));
+    return Ops::addi(Ops::muli(Ops::srli<Shift>(c), Ops::set1i(stride)),
+                     Ops::muli(inner, Ops::set1i(1 << (Axis * Shift))));
+  }
+
+  // Fixed point kernels, see noise/fixed_point.hpp. The lattice hashes run
+  // in int32 lanes, kParts vectors per block, the Q15 remaps and lerps in
+  // kWidth16 int16 lanes. The arithmetic is all integer, so they match
+  // the scalar evals exactly on any CPU and compiler
+  using Int16 = Ops::Int16;
+  static constexpr std::size_t kWidth16 = Ops::kWidth16;
+  static constexpr std::size_t kParts = kWidth16 / kWidth;
+
+  // forEachBlock for Q16.16 coordinates and Q15 samples, kWidth16 at a time
+  template <std::size_t Inputs, typename Block>
+  static inline void forEachFixedBlock(const std::int32_t *const (&in)[Inputs],
+                                       const std::size_t count,
+                                       std::int16_t *out, Block block) {
+    const std::int32_t *chunk[Inputs];
+    std::size_t k = 0;
+    for (; k + kWidth16 <= count; k += kWidth16) {
+      for (std::size_t c = 0; c < Inputs; ++c) {
+        chunk[c] = in[c] + k;
+      }
+      block(chunk, out + k);
+    }
+
+    if (k < count) {
+      const std::size_t rest = count - k;
+      alignas(64) std::int32_t tail[Inputs][kWidth16] = {};
+      alignas(64) std::int16_t tailOut[kWidth16] = {};
+      for (std::size_t c = 0; c < Inputs; ++c) {
+        for (std::size_t l = 0; l < rest; ++l) {
+          tail[c][l] = in[c][k + l];
+        }
+        chunk[c] = tail[c];
+      }
+      block(chunk, tailOut);
+      for (std::size_t l = 0; l < rest; ++l) {
+        out[k + l] = tailOut[l];
+      }
+    }
+  }
+
+  // The int16 lanes of the kParts int32 vectors part(k)
+  template <typename Part> static inline Int16 packParts(Part part) {
+    Int parts[kParts];
+    for (std::size_t k = 0; k < kParts; ++k) {
+      parts[k] = part(k);
+    }
+    return Ops::pack16(parts);
+  }
+
+  // Wrapped lattice cells of the Q16.16 coordinates at p into cells, and
+  // their positions in the cells in Q15, see noise::fixedCell
+  static inline Int16 fixedCells(const std::int32_t *p, const Int mask,
+                                 Int (&cells)[kParts]) {
+    return packParts([&](const std::size_t k) {
+      const Int x = Ops::loadi(p + k * kWidth);
+      cells[k] = Ops::andi(Ops::srai<16>(x), mask);
+      return Ops::srli<1>(Ops::andi(x, Ops::set1i(0xFFFF)));
+    });
+  }
+
+  // lo + (hi - lo) * t, see noise::lerpQ15
+  static inline Int16 lerpQ15(const Int16 lo, const Int16 hi, const Int16 t) {
+    return Ops::add16(lo, Ops::mulhrs16(Ops::sub16(hi, lo), t));
+  }
+
+  // noise::smoothstepRemapQ15 and noise::perlinRemapQ15
+  template <KernelRemap Remap> static inline Int16 remapQ15(const Int16 t) {
+    static_assert(Remap != KernelRemap::None,
+                  "The fixed point kernels have no version of this remap");
+    const Int16 u = Ops::sub16(t, Ops::set1_16(16384));
+    const Int16 u2 = Ops::mulhrs16(u, u);
+    const Int16 u3 = Ops::mulhrs16(u2, u);
+    Int16 inner;
+    if constexpr (Remap == KernelRemap::Smoothstep) {
+      inner = Ops::sub16(Ops::add16(u, Ops::mulhrs16(u, Ops::set1_16(16384))),
+                         Ops::add16(u3, u3));
+    } else {
+      const Int16 u5 = Ops::mulhrs16(u3, u2);
+      inner = Ops::add16(u, Ops::mulhrs16(u, Ops::set1_16(28672)));
+      inner = Ops::sub16(inner, Ops::mullo16(u3, Ops::set1_16(5)));
+      inner = Ops::add16(inner, Ops::mullo16(u5, Ops::set1_16(6)));
+    }
+    return Ops::adds16(inner, Ops::set1_16(16384));
+  }
+
+  // Mirrors FixedValueNoise::eval(const Vec2_Type &). perm is the doubled
+  // permutation table, values the Q15 random values of the corners by hash
+  // prefix, see FixedValueNoise::cornerValues
+  template <KernelRemap Remap>
+  static inline void fixedValueNoise2D(const std::int32_t *perm,
+                                       const std::int32_t *values,
+                                       const std::int32_t mask,
+                                       const std::int32_t *x,
+                                       const std::int32_t *y,
+                                       const std::size_t count,
+                                       std::int16_t *out) {
+    const Int vmask = Ops::set1i(mask);
+    const Int one = Ops::set1i(1);
+
+    const std::int32_t *const in[2] = {x, y};
+    forEachFixedBlock(in, count, out, [&](const std::int32_t *const (&p)[2],
+                                          std::int16_t *dst) {
+      Int rx0[kParts], ry0[kParts];
+      const Int16 tx = fixedCells(p[0], vmask, rx0);
+      const Int16 ty = fixedCells(p[1], vmask, ry0);
+
+      Int hx0[kParts], hx1[kParts], ry1[kParts];
+      for (std::size_t k = 0; k < kParts; ++k) {
+        hx0[k] = Ops::gather(perm, rx0[k]);
+        hx1[k] = Ops::gather(perm, Ops::andi(Ops::addi(rx0[k], one), vmask));
+        ry1[k] = Ops::andi(Ops::addi(ry0[k], one), vmask);
+      }
+
+      auto corner = [&](const Int(&hx)[kParts], const Int(&ry)[kParts]) {
+        return packParts([&](const std::size_t k) {
+          return Ops::gather(values, Ops::addi(hx[k], ry[k]));
+        });
+      };
+
+      const Int16 sx = remapQ15<Remap>(tx);
+      const Int16 sy = remapQ15<Remap>(ty);
+
+      const Int16 nx0 = lerpQ15(corner(hx0, ry0), corner(hx1, ry0), sx);
+      const Int16 nx1 = lerpQ15(corner(hx0, ry1), corner(hx1, ry1), sx);
+      Ops::store16(dst, lerpQ15(nx0, nx1, sy));
+    });
+  }
+
+  // Mirrors FixedValueNoise::eval(const Vec3_Type &)
+  template <KernelRemap Remap>
+  static inline void fixedValueNoise3D(const std::int32_t *perm,
+                                       const std::int32_t *values,
+                                       const std::int32_t mask,
+                                       const std::int32_t *x,
+                                       const std::int32_t *y,
+                                       const std::int32_t *z,
+                                       const std::size_t count,
+                                       std::int16_t *out) {
+    const Int vmask = Ops::set1i(mask);
+    const Int one = Ops::set1i(1);
+
+    const std::int32_t *const in[3] = {x, y, z};
+    forEachFixedBlock(in, count, out, [&](const std::int32_t *const (&p)[3],
+                                          std::int16_t *dst) {
+      Int rx0[kParts], ry0[kParts], rz0[kParts];
+      const Int16 tx = fixedCells(p[0], vmask, rx0);
+      const Int16 ty = fixedCells(p[1], vmask, ry0);
+      const Int16 tz = fixedCells(p[2], vmask, rz0);
+
+      Int h00[kParts], h10[kParts], h01[kParts], h11[kParts], rz1[kParts];
+      for (std::size_t k = 0; k < kParts; ++k) {
+        const Int hx0 = Ops::gather(perm, rx0[k]);
+        const Int hx1 =
+            Ops::gather(perm, Ops::andi(Ops::addi(rx0[k], one), vmask));
+        const Int ry1 = Ops::andi(Ops::addi(ry0[k], one), vmask);
+        h00[k] = Ops::gather(perm, Ops::addi(hx0, ry0[k]));
+        h10[k] = Ops::gather(perm, Ops::addi(hx1, ry0[k]));
+        h01[k] = Ops::gather(perm, Ops::addi(hx0, ry1));
+        h11[k] = Ops::gather(perm, Ops::addi(hx1, ry1));
+        rz1[k] = Ops::andi(Ops::addi(rz0[k], one), vmask);
+      }
+
+      auto corner = [&](const Int(&h)[kParts], const Int(&rz)[kParts]) {
+        return packParts([&](const std::size_t k) {
+          return Ops::gather(values, Ops::addi(h[k], rz[k]));
+        });
+      };
+
+      const Int16 sx = remapQ15<Remap>(tx);
+      const Int16 sy = remapQ15<Remap>(ty);
+      const Int16 sz = remapQ15<Remap>(tz);
+
+      const Int16 nx00 = lerpQ15(corner(h00, rz0), corner(h10, rz0), sx);
+      const Int16 nx10 = lerpQ15(corner(h01, rz0), corner(h11, rz0), sx);
+      const Int16 nx01 = lerpQ15(corner(h00, rz1), corner(h10, rz1), sx);
+      const Int16 nx11 = lerpQ15(corner(h01, rz1), corner(h11, rz1), sx);
+
+      const Int16 ny10 = lerpQ15(nx00, nx10, sy);
+      const Int16 ny11 = lerpQ15(nx01, nx11, sy);
+      Ops::store16(dst, lerpQ15(ny10, ny11, sz));
+    });
+  }
+
+  // Mirrors FixedPerlinNoise3D::eval(const Vec3_Type &). gradientsXY and
+  // gradientsZ are the Q13 gradients of the corners by hash prefix plus z,
+  // see FixedPerlinNoise3D::cornerDot: two gathers per corner
+  static inline void fixedPerlin3D(const std::int32_t *perm,
+                                   const std::int32_t *gradientsXY,
+                                   const std::int32_t *gradientsZ,
+                                   const std::int32_t mask,
+                                   const std::int32_t *x,
+                                   const std::int32_t *y,
+                                   const std::int32_t *z,
+                                   const std::size_t count,
+                                   std::int16_t *out) {
+    const Int vmask = Ops::set1i(mask);
+    const Int one = Ops::set1i(1);
+    const Int low = Ops::set1i(0xFFFF);
+    const Int bias = Ops::set1i(0x8000);
+    const Int16 minusOne = Ops::set1_16(INT16_MIN);
+
+    const std::int32_t *const in[3] = {x, y, z};
+    forEachFixedBlock(in, count, out, [&](const std::int32_t *const (&p)[3],
+                                          std::int16_t *dst) {
+      Int xi0[kParts], yi0[kParts], zi0[kParts];
+      const Int16 tx = fixedCells(p[0], vmask, xi0);
+      const Int16 ty = fixedCells(p[1], vmask, yi0);
+      const Int16 tz = fixedCells(p[2], vmask, zi0);
+
+      // Hash prefixes of the corners (x, y)
+      Int hxy[4][kParts], zi1[kParts];
+      for (std::size_t k = 0; k < kParts; ++k) {
+        const Int hx0 = Ops::gather(perm, xi0[k]);
+        const Int hx1 =
+            Ops::gather(perm, Ops::andi(Ops::addi(xi0[k], one), vmask));
+        const Int yi1 = Ops::andi(Ops::addi(yi0[k], one), vmask);
+        hxy[0][k] = Ops::gather(perm, Ops::addi(hx0, yi0[k]));
+        hxy[1][k] = Ops::gather(perm, Ops::addi(hx1, yi0[k]));
+        hxy[2][k] = Ops::gather(perm, Ops::addi(hx0, yi1));
+        hxy[3][k] = Ops::gather(perm, Ops::addi(hx1, yi1));
+        zi1[k] = Ops::andi(Ops::addi(zi0[k], one), vmask);
+      }
+
+      const Int16 x0 = tx, x1 = Ops::add16(tx, minusOne);
+      const Int16 y0 = ty, y1 = Ops::add16(ty, minusOne);
+      const Int16 z0 = tz, z1 = Ops::add16(tz, minusOne);
+
+      // Dot product between the gradient of corner c and p, in Q13
+      auto cornerDot = [&](const std::size_t c, const Int(&zi)[kParts],
+                           const Int16 px, const Int16 py, const Int16 pz) {
+        Int i[kParts], xy[kParts];
+        for (std::size_t k = 0; k < kParts; ++k) {
+          i[k] = Ops::addi(hxy[c][k], zi[k]);
+          xy[k] = Ops::gather(gradientsXY, i[k]);
+        }
+        const Int16 gx = packParts(
+            [&](const std::size_t k) { return Ops::srai<16>(xy[k]); });
+        const Int16 gy = packParts([&](const std::size_t k) {
+          return Ops::subi(Ops::andi(xy[k], low), bias);
+        });
+        const Int16 gz = packParts([&](const std::size_t k) {
+          return Ops::gather(gradientsZ, i[k]);
+        });
+        return Ops::add16(Ops::add16(Ops::mulhrs16(gx, px),
+                                     Ops::mulhrs16(gy, py)),
+                          Ops::mulhrs16(gz, pz));
+      };
+
+      const Int16 u = remapQ15<KernelRemap::Perlin>(tx);
+      const Int16 v = remapQ15<KernelRemap::Perlin>(ty);
+      const Int16 w = remapQ15<KernelRemap::Perlin>(tz);
+
+      const Int16 a = lerpQ15(cornerDot(0, zi0, x0, y0, z0),
+                              cornerDot(1, zi0, x1, y0, z0), u);
+      const Int16 b = lerpQ15(cornerDot(2, zi0, x0, y1, z0),
+                              cornerDot(3, zi0, x1, y1, z0), u);
+      const Int16 c = lerpQ15(cornerDot(0, zi1, x0, y0, z1),
+                              cornerDot(1, zi1, x1, y0, z1), u);
+      const Int16 d = lerpQ15(cornerDot(2, zi1, x0, y1, z1),
+                              cornerDot(3, zi1, x1, y1, z1), u);
+
+      const Int16 e = lerpQ15(a, b, v);
+      const Int16 f = lerpQ15(c, d, v);
+
+      // Q13 to Q15, saturated as noise::saturateQ13
+      const Int16 g = lerpQ15(e, f, w);
+      const Int16 g2 = Ops::adds16(g, g);
+      Ops::store16(dst, Ops::adds16(g2, g2));
+    });
+  }
+
+  // Output stages, see noise/pixel_stages.hpp. The samples go through the
+  // same float operations as in the scalar stages, so the pixels match
+
+  // forEachBlock for one input and Pixel outputs
+  template <typename Pixel, typename Block>
+  static inline void forEachStageBlock(const float *samples,
+                                       const std::size_t count, Pixel *out,
+                                       Block block) {
+    std::size_t k = 0;
+    for (; k + kWidth <= count; k += kWidth) {
+      block(samples + k, out + k);
+    }
+
+    if (k < count) {
+      const std::size_t rest = count - k;
+      alignas(64) float tail[kWidth] = {};
+      Pixel tailOut[kWidth];
+      for (std::size_t l = 0; l < rest; ++l) {
+        tail[l] = samples[k + l];
+      }
+      block(tail, tailOut);
+      for (std::size_t l = 0; l < rest; ++l) {
+        out[k + l] = tailOut[l];
+      }
+    }
+  }
+
+  // Mirrors QuantizeStage: (samples - low) * scale clamped to [0, 1], times
+  // maxValue, the largest Pixel
+  template <typename Pixel>
+  static inline void quantize(const float low, const float scale,
+                              const float maxValue, const float *samples,
+                              const std::size_t count, Pixel *out) {
+    const Float vlow = Ops::set1(low), vscale = Ops::set1(scale);
+    const Float zero = Ops::set1(0.0f), one = Ops::set1(1.0f);
+    const Float vmax = Ops::set1(maxValue);
+
+    forEachStageBlock(samples, count, out, [&](const float *p, Pixel *dst) {
+      Float v = Ops::mul(Ops::sub(Ops::load(p), vlow), vscale);
+      v = Ops::minf(Ops::maxf(v, zero), one);
+      Ops::storeNarrow(dst, Ops::toInt(Ops::mul(v, vmax)));
+    });
+  }
+
+  // Mirrors ColorizeStage for the packed RGBA8 colors of lut, whose last
+  // entry is last
+  static inline void colorize(const std::uint32_t *lut, const float low,
+                              const float scale, const float last,
+                              const float *samples, const std::size_t count,
+                              std::uint32_t *out) {
+    const std::int32_t *colors = reinterpret_cast<const std::int32_t *>(lut);
+    const Float vlow = Ops::set1(low), vscale = Ops::set1(scale);
+    const Float zero = Ops::set1(0.0f), vlast = Ops::set1(last);
+    const Float half = Ops::set1(0.5f);
+
+    forEachStageBlock(
+        samples, count, reinterpret_cast<std::int32_t *>(out),
+        [&](const float *p, std::int32_t *dst) {
+          Float v = Ops::mul(Ops::sub(Ops::load(p), vlow), vscale);
+          v = Ops::minf(Ops::maxf(v, zero), vlast);
+          Ops::storei(dst, Ops::gather(colors, Ops::toInt(Ops::add(v, half))));
+        });
+  }
+
+  // Worley kernels, see noise/worley_noise.hpp. A feature point is packed
+  // in one int32 per cell, so each neighbor cell costs one gather
+
+  // Offsets of the feature point of packed in its cell, the first axis in
+  // the highest bits: 16 bits per axis in 2D, 10 in 3D
+  template <std::size_t N>
+  static inline void featureOffsets(const Int packed, Float (&f)[N]) {
+    static_assert(N == 2 || N == 3, "Worley kernels are 2D or 3D");
+    if constexpr (N == 2) {
+      const Float scale = Ops::set1(1.0f / 65536);
+      f[0] = Ops::mul(Ops::toFloat(Ops::srli<16>(packed)), scale);
+      f[1] = Ops::mul(Ops::toFloat(Ops::andi(packed, Ops::set1i(0xFFFF))),
+                      scale);
+    } else {
+      const Float scale = Ops::set1(1.0f / 1024);
+      const Int bits = Ops::set1i(0x3FF);
+      f[0] = Ops::mul(Ops::toFloat(Ops::srli<20>(packed)), scale);
+      f[1] = Ops::mul(Ops::toFloat(Ops::andi(Ops::srli<10>(packed), bits)),
+                      scale);
+      f[2] = Ops::mul(Ops::toFloat(Ops::andi(packed, bits)), scale);
+    }
+  }
+
+  // What the metric compares of the per axis differences d, see the
+  // measure of the metric policies
+  template <KernelMetric Metric, std::size_t N>
+  static inline Float cellMeasure(const Float (&d)[N]) {
+    if constexpr (Metric == KernelMetric::Manhattan) {
+      Float s = Ops::absf(d[0]);
+      for (std::size_t a = 1; a < N; ++a) {
+        s = Ops::add(s, Ops::absf(d[a]));
+      }
+      return s;
+    } else if constexpr (Metric == KernelMetric::Chebyshev) {
+      Float s = Ops::absf(d[0]);
+      for (std::size_t a = 1; a < N; ++a) {
+        s = Ops::maxf(s, Ops::absf(d[a]));
+      }
+      return s;
+    } else {
+      Float s = Ops::mul(d[0], d[0]);
+      for (std::size_t a = 1; a < N; ++a) {
+        s = Ops::add(s, Ops::mul(d[a], d[a]));
+      }
+      return s;
+    }
+  }
+
+  template <KernelMetric Metric> static inline Float cellFinish(const Float s) {
+    if constexpr (Metric == KernelMetric::Euclidean) {
+      return Ops::sqrt(s);
+    } else {
+      return s;
+    }
+  }
+
+  // Mirrors WorleyNoiseND::eval(const Vec2_Type &). perm is the doubled
+  // permutation table, features the packed feature points by hash prefix
+  // plus y
+  template <KernelMetric Metric, CellularOutput Output>
+  static inline void worley2D(const std::int32_t *perm,
+                              const std::int32_t *features,
+                              const std::int32_t mask, const float *x,
+                              const float *y, const std::size_t count,
+                              float *out) {
+    const float *const in[2] = {x, y};
+    worleyWith<Metric, Output>(perm, features, mask, in, count, out);
+  }
+
+  // Mirrors WorleyNoiseND::eval(const Vec3_Type &)
+  template <KernelMetric Metric, CellularOutput Output>
+  static inline void worley3D(const std::int32_t *perm,
+                              const std::int32_t *features,
+                              const std::int32_t mask, const float *x,
+                              const float *y, const float *z,
+                              const std::size_t count, float *out) {
+    const float *const in[3] = {x, y, z};
+    worleyWith<Metric, Output>(perm, features, mask, in, count, out);
+  }
+
+  // The 3^N cells around the one of each sample are visited by rings (see
+  // simd::neighborRings), unrolled. A cell is
+  // skipped when the bound of its distance (that of the closest point of
+  // the cell) reaches the distance it could replace in no lane. Skipping
+  // never changes the result, so it does not need to match the scalar path
+  template <KernelMetric Metric, CellularOutput Output, std::size_t N>
+  static inline void worleyWith(const std::int32_t *perm,
+                                const std::int32_t *features,
+                                const std::int32_t mask,
+                                const float *const (&in)[N],
+                                const std::size_t count, float *out) {
+    const Int vmask = Ops::set1i(mask);
+    const Float zero = Ops::set1(0.0f), one = Ops::set1(1.0f);
+    const Float inf = Ops::set1(std::numeric_limits<float>::infinity());
+
+    forEachBlock(in, count, out, [&](const float *const (&p)[N], float *dst) {
+      // Wrapped lattice coordinates of the neighbors along each axis, and
+      // the bounds of the distance to the lower and upper ones
+      Float t[N], upper[N];
+      Int r[N][3];
+      for (std::size_t a = 0; a < N; ++a) {
+        const Int c = cell(Ops::load(p[a]), t[a]);
+        upper[a] = Ops::sub(one, t[a]);
+        for (int o = 0; o < 3; ++o) {
+          r[a][o] = Ops::andi(Ops::addi(c, Ops::set1i(o - 1)), vmask);
+        }
+      }
+
+      // Hash prefixes of the columns of cells, over every axis but the last
+      Int h[9];
+      for (int i = 0; i < 3; ++i) {
+        const Int hx = Ops::gather(perm, r[0][i]);
+        if constexpr (N == 2) {
+          h[i] = hx;
+        } else {
+          for (int j = 0; j < 3; ++j) {
+            h[i + 3 * j] = Ops::gather(perm, Ops::addi(hx, r[1][j]));
+          }
+        }
+      }
+
+      Float f1 = inf, f2 = inf;
+      forEachNeighbor<N>([&](auto cell) {
+        constexpr std::array<int, N> o = neighborRings<N>()[cell];
+
+        if constexpr (cell != 0) {
+          Float b[N];
+          for (std::size_t a = 0; a < N; ++a) {
+            b[a] = o[a] < 0 ? t[a] : (o[a] > 0 ? upper[a] : zero);
+          }
+          const Float limit = Output == CellularOutput::F1 ? f1 : f2;
+          if (!Ops::any(Ops::cmplt(cellMeasure<Metric>(b), limit))) {
+            return;
+          }
+        }
+
+        constexpr int prefix = N == 2 ? o[0] + 1 : o[0] + 1 + 3 * (o[1] + 1);
+        const Int packed = Ops::gather(
+            features, Ops::addi(h[prefix], r[N - 1][o[N - 1] + 1]));
+        Float f[N], d[N];
+        featureOffsets(packed, f);
+        for (std::size_t a = 0; a < N; ++a) {
+          const Float offset = Ops::set1(static_cast<float>(o[a]));
+          d[a] = Ops::sub(t[a], Ops::add(offset, f[a]));
+        }
+
+        const Float s = cellMeasure<Metric>(d);
+        if constexpr (Output != CellularOutput::F1) {
+          f2 = Ops::select(Ops::cmplt(s, f1), f1, Ops::minf(s, f2));
+        }
+        f1 = Ops::minf(s, f1);
+      });
+
+      if constexpr (Output == CellularOutput::F1) {
+        Ops::store(dst, cellFinish<Metric>(f1));
+      } else if constexpr (Output == CellularOutput::F2) {
+        Ops::store(dst, cellFinish<Metric>(f2));
+      } else {
+        Ops::store(dst,
+                   Ops::sub(cellFinish<Metric>(f2), cellFinish<Metric>(f1)));
+      }
+    });
+  }
+};
@@ -0,0 +1,177 @@
+#ifndef NOISE_KERNELS_AVX2_H
+#define NOISE_KERNELS_AVX2_H
+
+#include "utils/simd_target.hpp"
+
+#if NOISE_SIMD_X86
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <immintrin.h>
+
+#include "noise/lattice_tables.hpp"
+#include "noise/simd/kernel_cellular.hpp"
+#include "noise/simd/kernel_remap.hpp"
+
+NOISE_SIMD_TARGET_BEGIN("avx2")
+
+namespace noise::simd::avx2 {
+
+// 8 float / int32 lanes
+struct Ops {
+  using Float = __m256;
+  using Int = __m256i;
+  static constexpr std::size_t kWidth = 8;
+
+  static inline Float load(const float *p) { return _mm256_loadu_ps(p); }
+  static inline void store(float *p, const Float v) { _mm256_storeu_ps(p, v); }
+  static inline Float set1(const float v) { return _mm256_set1_ps(v); }
+  static inline Int set1i(const std::int32_t v) { return _mm256_set1_epi32(v); }
+
+  static inline Float add(const Float a, const Float b) {
+    return _mm256_add_ps(a, b);
+  }
+  static inline Float sub(const Float a, const Float b) {
+    return _mm256_sub_ps(a, b);
+  }
+  static inline Float mul(const Float a, const Float b) {
+    return _mm256_mul_ps(a, b);
+  }
+  static inline Float floor(const Float v) { return _mm256_floor_ps(v); }
+
+  static inline Int toInt(const Float v) { return _mm256_cvttps_epi32(v); }
+  static inline Float toFloat(const Int v) { return _mm256_cvtepi32_ps(v); }
+
+  static inline Int addi(const Int a, const Int b) {
+    return _mm256_add_epi32(a, b);
+  }
+  static inline Int subi(const Int a, const Int b) {
+    return _mm256_sub_epi32(a, b);
+  }
+  static inline Int andi(const Int a, const Int b) {
+    return _mm256_and_si256(a, b);
+  }
+  static inline Int xori(const Int a, const Int b) {
+    return _mm256_xor_si256(a, b);
+  }
+  // Low 32 bits of the products
+  static inline Int muli(const Int a, const Int b) {
+    return _mm256_mullo_epi32(a, b);
+  }
+  // Logical shift
+  template <int Bits> static inline Int srli(const Int v) {
+    return _mm256_srli_epi32(v, Bits);
+  }
+  static inline Int cmpeqi(const Int a, const Int b) {
+    return _mm256_cmpeq_epi32(a, b);
+  }
+  static inline Int cmpgti(const Int a, const Int b) {
+    return _mm256_cmpgt_epi32(a, b);
+  }
+  static inline Int cmplt(const Float a, const Float b) {
+    return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_LT_OQ));
+  }
+  // mask ? a : b, mask lanes being all ones or all zeros
+  static inline Float select(const Int mask, const Float a, const Float b) {
+    return _mm256_blendv_ps(b, a, _mm256_castsi256_ps(mask));
+  }
+  // -v where mask is set
+  static inline Float flipSign(const Float v, const Int mask) {
+    const __m256 sign = _mm256_castsi256_ps(
+        _mm256_and_si256(mask, _mm256_set1_epi32(INT32_MIN)));
+    return _mm256_xor_ps(v, sign);
+  }
+
+  static inline Int gather(const std::int32_t *base, const Int idx) {
+    return _mm256_i32gather_epi32(reinterpret_cast<const int *>(base), idx, 4);
+  }
+  static inline Float gatherf(const float *base, const Int idx) {
+    return _mm256_i32gather_ps(base, idx, 4);
+  }
+
+  // Fixed point kernels: int32 loads and arithmetic shifts, and Q15
+  // arithmetic in 16 int16 lanes, twice the int32 ones
+  using Int16 = __m256i;
+  static constexpr std::size_t kWidth16 = 16;
+
+  static inline Int loadi(const std::int32_t *p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  }
+  template <int Bits> static inline Int srai(const Int v) {
+    return _mm256_srai_epi32(v, Bits);
+  }
+  // The kWidth16 / kWidth int32 vectors of parts, saturated to int16 lanes
+  // in order. packs works within 128 bit halves, the permute restores the
+  // order of the lanes
+  static inline Int16 pack16(const Int *parts) {
+    return _mm256_permute4x64_epi64(_mm256_packs_epi32(parts[0], parts[1]),
+                                    0xD8);
+  }
+  static inline void store16(std::int16_t *p, const Int16 v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+  }
+  static inline Int16 set1_16(const std::int16_t v) {
+    return _mm256_set1_epi16(v);
+  }
+  static inline Int16 add16(const Int16 a, const Int16 b) {
+    return _mm256_add_epi16(a, b);
+  }
+  static inline Int16 adds16(const Int16 a, const Int16 b) {
+    return _mm256_adds_epi16(a, b);
+  }
+  static inline Int16 sub16(const Int16 a, const Int16 b) {
+    return _mm256_sub_epi16(a, b);
+  }
+  static inline Int16 mullo16(const Int16 a, const Int16 b) {
+    return _mm256_mullo_epi16(a, b);
+  }
+  // (a * b + 2^14) >> 15, see noise::mulQ15
+  static inline Int16 mulhrs16(const Int16 a, const Int16 b) {
+    return _mm256_mulhrs_epi16(a, b);
+  }
+
+  // Output stages: float clamps, int32 stores, and int32 lanes known to be
+  // in range stored as uint8 or uint16. packus works within 128 bit halves,
+  // the permute gathers the lanes in the low half
+  static inline Float minf(const Float a, const Float b) {
+    return _mm256_min_ps(a, b);
+  }
+  static inline Float maxf(const Float a, const Float b) {
+    return _mm256_max_ps(a, b);
+  }
+  static inline void storei(std::int32_t *p, const Int v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+  }
+  static inline void storeNarrow(std::uint8_t *p, const Int v) {
+    const __m128i w = _mm256_castsi256_si128(
+        _mm256_permute4x64_epi64(_mm256_packus_epi32(v, v), 0x08));
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(p), _mm_packus_epi16(w, w));
+  }
+  static inline void storeNarrow(std::uint16_t *p, const Int v) {
+    const __m128i w = _mm256_castsi256_si128(
+        _mm256_permute4x64_epi64(_mm256_packus_epi32(v, v), 0x08));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p), w);
+  }
+
+  // Worley kernels: absolute values, square roots, and whether any lane of
+  // a mask is set, to skip the neighbor cells no lane can reach
+  static inline Float absf(const Float v) {
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v);
+  }
+  static inline Float sqrt(const Float v) { return _mm256_sqrt_ps(v); }
+  static inline bool any(const Int mask) {
+    return _mm256_movemask_ps(_mm256_castsi256_ps(mask)) != 0;
+  }
+};
+
+#include "noise/simd/noise_kernels.inl"
+
+} // namespace noise::simd::avx2
+
+NOISE_SIMD_TARGET_END
+
+#endif // NOISE_SIMD_X86
+
+#endif // !NOISE_KERNELS_AVX2_H
@@ -0,0 +1,191 @@
+#ifndef NOISE_KERNELS_AVX512_H
+#define NOISE_KERNELS_AVX512_H
+
+#include "utils/simd_target.hpp"
+
+#if NOISE_SIMD_X86
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <immintrin.h>
+
+#include "noise/lattice_tables.hpp"
+#include "noise/simd/kernel_cellular.hpp"
+#include "noise/simd/kernel_remap.hpp"
+
+NOISE_SIMD_TARGET_BEGIN("avx512f")
+
+// GCC 12 flags the _mm512_undefined_* placeholders the intrinsics pass as
+// unused merge sources as uninitialized
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace noise::simd::avx512 {
+
+// 16 float / int32 lanes
+struct Ops {
+  using Float = __m512;
+  using Int = __m512i;
+  static constexpr std::size_t kWidth = 16;
+
+  static inline Float load(const float *p) { return _mm512_loadu_ps(p); }
+  static inline void store(float *p, const Float v) { _mm512_storeu_ps(p, v); }
+  static inline Float set1(const float v) { return _mm512_set1_ps(v); }
+  static inline Int set1i(const std::int32_t v) { return _mm512_set1_epi32(v); }
+
+  static inline Float add(const Float a, const Float b) {
+    return _mm512_add_ps(a, b);
+  }
+  static inline Float sub(const Float a, const Float b) {
+    return _mm512_sub_ps(a, b);
+  }
+  static inline Float mul(const Float a, const Float b) {
+    return _mm512_mul_ps(a, b);
+  }
+  static inline Float floor(const Float v) {
+    return _mm512_roundscale_ps(v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+  }
+
+  static inline Int toInt(const Float v) { return _mm512_cvttps_epi32(v); }
+  static inline Float toFloat(const Int v) { return _mm512_cvtepi32_ps(v); }
+
+  static inline Int addi(const Int a, const Int b) {
+    return _mm512_add_epi32(a, b);
+  }
+  static inline Int subi(const Int a, const Int b) {
+    return _mm512_sub_epi32(a, b);
+  }
+  static inline Int andi(const Int a, const Int b) {
+    return _mm512_and_si512(a, b);
+  }
+  static inline Int xori(const Int a, const Int b) {
+    return _mm512_xor_si512(a, b);
+  }
+  // Low 32 bits of the products
+  static inline Int muli(const Int a, const Int b) {
+    return _mm512_mullo_epi32(a, b);
+  }
+  // Logical shift
+  template <int Bits> static inline Int srli(const Int v) {
+    return _mm512_srli_epi32(v, Bits);
+  }
+  // Masks are kept in vectors, as for the narrower ISAs
+  static inline Int cmpeqi(const Int a, const Int b) {
+    return _mm512_maskz_mov_epi32(_mm512_cmpeq_epi32_mask(a, b),
+                                  _mm512_set1_epi32(-1));
+  }
+  static inline Int cmpgti(const Int a, const Int b) {
+    return _mm512_maskz_mov_epi32(_mm512_cmpgt_epi32_mask(a, b),
+                                  _mm512_set1_epi32(-1));
+  }
+  static inline Int cmplt(const Float a, const Float b) {
+    return _mm512_maskz_mov_epi32(_mm512_cmp_ps_mask(a, b, _CMP_LT_OQ),
+                                  _mm512_set1_epi32(-1));
+  }
+  // mask ? a : b, mask lanes being all ones or all zeros
+  static inline Float select(const Int mask, const Float a, const Float b) {
+    return _mm512_mask_blend_ps(_mm512_test_epi32_mask(mask, mask), b, a);
+  }
+  // -v where mask is set
+  static inline Float flipSign(const Float v, const Int mask) {
+    const Int sign = _mm512_and_si512(mask, _mm512_set1_epi32(INT32_MIN));
+    return _mm512_castsi512_ps(
+        _mm512_xor_si512(_mm512_castps_si512(v), sign));
+  }
+
+  static inline Int gather(const std::int32_t *base, const Int idx) {
+    return _mm512_i32gather_epi32(idx, base, 4);
+  }
+  static inline Float gatherf(const float *base, const Int idx) {
+    return _mm512_i32gather_ps(idx, base, 4);
+  }
+
+  // Fixed point kernels: int32 loads and arithmetic shifts, and Q15
+  // arithmetic in int16 lanes. AVX-512F has no int16 arithmetic (that is
+  // AVX-512BW), so the 16 int16 lanes of one int32 vector run on AVX2
+  using Int16 = __m256i;
+  static constexpr std::size_t kWidth16 = 16;
+
+  static inline Int loadi(const std::int32_t *p) {
+    return _mm512_loadu_si512(p);
+  }
+  template <int Bits> static inline Int srai(const Int v) {
+    return _mm512_srai_epi32(v, Bits);
+  }
+  // The kWidth16 / kWidth int32 vectors of parts, saturated to int16 lanes
+  // in order
+  static inline Int16 pack16(const Int *parts) {
+    return _mm512_cvtsepi32_epi16(parts[0]);
+  }
+  static inline void store16(std::int16_t *p, const Int16 v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+  }
+  static inline Int16 set1_16(const std::int16_t v) {
+    return _mm256_set1_epi16(v);
+  }
+  static inline Int16 add16(const Int16 a, const Int16 b) {
+    return _mm256_add_epi16(a, b);
+  }
+  static inline Int16 adds16(const Int16 a, const Int16 b) {
+    return _mm256_adds_epi16(a, b);
+  }
+  static inline Int16 sub16(const Int16 a, const Int16 b) {
+    return _mm256_sub_epi16(a, b);
+  }
+  static inline Int16 mullo16(const Int16 a, const Int16 b) {
+    return _mm256_mullo_epi16(a, b);
+  }
+  // (a * b + 2^14) >> 15, see noise::mulQ15
+  static inline Int16 mulhrs16(const Int16 a, const Int16 b) {
+    return _mm256_mulhrs_epi16(a, b);
+  }
+
+  // Output stages: float clamps, int32 stores, and int32 lanes known to be
+  // in range stored as uint8 or uint16
+  static inline Float minf(const Float a, const Float b) {
+    return _mm512_min_ps(a, b);
+  }
+  static inline Float maxf(const Float a, const Float b) {
+    return _mm512_max_ps(a, b);
+  }
+  static inline void storei(std::int32_t *p, const Int v) {
+    _mm512_storeu_si512(p, v);
+  }
+  static inline void storeNarrow(std::uint8_t *p, const Int v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm512_cvtepi32_epi8(v));
+  }
+  static inline void storeNarrow(std::uint16_t *p, const Int v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p),
+                        _mm512_cvtepi32_epi16(v));
+  }
+
+  // Worley kernels: absolute values, square roots, and whether any lane of
+  // a mask is set, to skip the neighbor cells no lane can reach
+  static inline Float absf(const Float v) {
+    return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(v),
+                                                _mm512_set1_epi32(INT32_MAX)));
+  }
+  static inline Float sqrt(const Float v) { return _mm512_sqrt_ps(v); }
+  static inline bool any(const Int mask) {
+    return _mm512_test_epi32_mask(mask, mask) != 0;
+  }
+};
+
+#include "noise/simd/noise_kernels.inl"
+
+} // namespace noise::simd::avx512
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+NOISE_SIMD_TARGET_END
+
+#endif // NOISE_SIMD_X86
+
+#endif // !NOISE_KERNELS_AVX512_H
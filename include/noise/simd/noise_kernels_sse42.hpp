@@ -0,0 +1,178 @@
+#ifndef NOISE_KERNELS_SSE42_H
+#define NOISE_KERNELS_SSE42_H
+
+#include "utils/simd_target.hpp"
+
+#if NOISE_SIMD_X86
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include <immintrin.h>
+
+#include "noise/lattice_tables.hpp"
+#include "noise/simd/kernel_cellular.hpp"
+#include "noise/simd/kernel_remap.hpp"
+
+NOISE_SIMD_TARGET_BEGIN("sse4.2")
+
+namespace noise::simd::sse42 {
+
+// 4 float / int32 lanes. There are no gathers before AVX2 so they are done
+// with scalar loads, the arithmetic still runs 4 wide
+struct Ops {
+  using Float = __m128;
+  using Int = __m128i;
+  static constexpr std::size_t kWidth = 4;
+
+  static inline Float load(const float *p) { return _mm_loadu_ps(p); }
+  static inline void store(float *p, const Float v) { _mm_storeu_ps(p, v); }
+  static inline Float set1(const float v) { return _mm_set1_ps(v); }
+  static inline Int set1i(const std::int32_t v) { return _mm_set1_epi32(v); }
+
+  static inline Float add(const Float a, const Float b) {
+    return _mm_add_ps(a, b);
+  }
+  static inline Float sub(const Float a, const Float b) {
+    return _mm_sub_ps(a, b);
+  }
+  static inline Float mul(const Float a, const Float b) {
+    return _mm_mul_ps(a, b);
+  }
+  static inline Float floor(const Float v) { return _mm_floor_ps(v); }
+
+  static inline Int toInt(const Float v) { return _mm_cvttps_epi32(v); }
+  static inline Float toFloat(const Int v) { return _mm_cvtepi32_ps(v); }
+
+  static inline Int addi(const Int a, const Int b) {
+    return _mm_add_epi32(a, b);
+  }
+  static inline Int subi(const Int a, const Int b) {
+    return _mm_sub_epi32(a, b);
+  }
+  static inline Int andi(const Int a, const Int b) {
+    return _mm_and_si128(a, b);
+  }
+  static inline Int xori(const Int a, const Int b) {
+    return _mm_xor_si128(a, b);
+  }
+  // Low 32 bits of the products
+  static inline Int muli(const Int a, const Int b) {
+    return _mm_mullo_epi32(a, b);
+  }
+  // Logical shift
+  template <int Bits> static inline Int srli(const Int v) {
+    return _mm_srli_epi32(v, Bits);
+  }
+  static inline Int cmpeqi(const Int a, const Int b) {
+    return _mm_cmpeq_epi32(a, b);
+  }
+  static inline Int cmpgti(const Int a, const Int b) {
+    return _mm_cmpgt_epi32(a, b);
+  }
+  static inline Int cmplt(const Float a, const Float b) {
+    return _mm_castps_si128(_mm_cmplt_ps(a, b));
+  }
+  // mask ? a : b, mask lanes being all ones or all zeros
+  static inline Float select(const Int mask, const Float a, const Float b) {
+    return _mm_blendv_ps(b, a, _mm_castsi128_ps(mask));
+  }
+  // -v where mask is set
+  static inline Float flipSign(const Float v, const Int mask) {
+    const __m128 sign = _mm_castsi128_ps(
+        _mm_and_si128(mask, _mm_set1_epi32(INT32_MIN)));
+    return _mm_xor_ps(v, sign);
+  }
+
+  static inline Int gather(const std::int32_t *base, const Int idx) {
+    return _mm_setr_epi32(
+        base[_mm_cvtsi128_si32(idx)], base[_mm_extract_epi32(idx, 1)],
+        base[_mm_extract_epi32(idx, 2)], base[_mm_extract_epi32(idx, 3)]);
+  }
+  static inline Float gatherf(const float *base, const Int idx) {
+    return _mm_setr_ps(
+        base[_mm_cvtsi128_si32(idx)], base[_mm_extract_epi32(idx, 1)],
+        base[_mm_extract_epi32(idx, 2)], base[_mm_extract_epi32(idx, 3)]);
+  }
+
+  // Fixed point kernels: int32 loads and arithmetic shifts, and Q15
+  // arithmetic in 8 int16 lanes, twice the int32 ones
+  using Int16 = __m128i;
+  static constexpr std::size_t kWidth16 = 8;
+
+  static inline Int loadi(const std::int32_t *p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+  }
+  template <int Bits> static inline Int srai(const Int v) {
+    return _mm_srai_epi32(v, Bits);
+  }
+  // The kWidth16 / kWidth int32 vectors of parts, saturated to int16 lanes
+  // in order
+  static inline Int16 pack16(const Int *parts) {
+    return _mm_packs_epi32(parts[0], parts[1]);
+  }
+  static inline void store16(std::int16_t *p, const Int16 v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+  }
+  static inline Int16 set1_16(const std::int16_t v) {
+    return _mm_set1_epi16(v);
+  }
+  static inline Int16 add16(const Int16 a, const Int16 b) {
+    return _mm_add_epi16(a, b);
+  }
+  static inline Int16 adds16(const Int16 a, const Int16 b) {
+    return _mm_adds_epi16(a, b);
+  }
+  static inline Int16 sub16(const Int16 a, const Int16 b) {
+    return _mm_sub_epi16(a, b);
+  }
+  static inline Int16 mullo16(const Int16 a, const Int16 b) {
+    return _mm_mullo_epi16(a, b);
+  }
+  // (a * b + 2^14) >> 15, see noise::mulQ15
+  static inline Int16 mulhrs16(const Int16 a, const Int16 b) {
+    return _mm_mulhrs_epi16(a, b);
+  }
+
+  // Output stages: float clamps, int32 stores, and int32 lanes known to be
+  // in range stored as uint8 or uint16
+  static inline Float minf(const Float a, const Float b) {
+    return _mm_min_ps(a, b);
+  }
+  static inline Float maxf(const Float a, const Float b) {
+    return _mm_max_ps(a, b);
+  }
+  static inline void storei(std::int32_t *p, const Int v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+  }
+  static inline void storeNarrow(std::uint8_t *p, const Int v) {
+    const __m128i w = _mm_packus_epi32(v, v);
+    const std::int32_t bytes = _mm_cvtsi128_si32(_mm_packus_epi16(w, w));
+    std::memcpy(p, &bytes, sizeof(bytes));
+  }
+  static inline void storeNarrow(std::uint16_t *p, const Int v) {
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(p), _mm_packus_epi32(v, v));
+  }
+
+  // Worley kernels: absolute values, square roots, and whether any lane of
+  // a mask is set, to skip the neighbor cells no lane can reach
+  static inline Float absf(const Float v) {
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+  }
+  static inline Float sqrt(const Float v) { return _mm_sqrt_ps(v); }
+  static inline bool any(const Int mask) {
+    return _mm_movemask_ps(_mm_castsi128_ps(mask)) != 0;
+  }
+};
+
+#include "noise/simd/noise_kernels.inl"
+
+} // namespace noise::simd::sse42
+
+NOISE_SIMD_TARGET_END
+
+#endif // NOISE_SIMD_X86
+
+#endif // !NOISE_KERNELS_SSE42_H
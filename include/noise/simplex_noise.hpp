@@ -0,0 +1,202 @@
+
+#ifndef SIMPLEX_NOISE_H
+#define SIMPLEX_NOISE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+
+#include "noise/lattice_tables.hpp"
+#include "noise/noise_range.hpp"
+#include "utils/int_fit.hpp"
+#include "vec/vec2.hpp"
+#include "vec/vec3.hpp"
+#include "vec/vec4.hpp"
+
+namespace noise {
+
+// Gradient noise on the simplex lattice (Perlin 2001, after Gustavson's
+// formulation). A sample only sums the radial falloffs of the N + 1 corners
+// of its simplex, against the 2^N of PerlinNoise3D, which pays off from 3
+// dimensions on and keeps 4D affordable. The permutation is drawn and laid
+// out as for PerlinNoise3D; the gradients are selected from the corner hash
+// (8 directions in 2D, the 12 cube edges in 3D, 32 in 4D), so there is no
+// gradients table
+template <uint_least16_t Period = 256,
+          typename Engine = std::default_random_engine,
+          typename Result_Type = float,
+          TableLayout Layout = TableLayout::Wide>
+class SimplexNoise {
+public:
+  static_assert(std::is_floating_point<Result_Type>(),
+                "Result_Type must be a floating point type");
+
+  using Dist = typename std::uniform_real_distribution<Result_Type>;
+  using Seed_Type = typename Dist::result_type;
+  using Value_Type = Result_Type;
+
+  // Gradient noise is centered on 0
+  static constexpr bool kSignedOutput = true;
+
+  // The sums are scaled so that every dimension stays within [-1, 1]
+  static constexpr Range<Result_Type> outputRange(const unsigned = 2) {
+    return Range<Result_Type>{-1, 1};
+  }
+
+  using Vec2_Type = typename vector::Vec2<Result_Type>;
+  using Vec3_Type = typename vector::Vec3<Result_Type>;
+  using Vec4_Type = typename vector::Vec4<Result_Type>;
+
+  SimplexNoise(Seed_Type seed = 2011);
+
+  // Tables drawn at compile time for a constexpr instance, see StaticSeed
+  explicit constexpr SimplexNoise(const StaticSeed seed);
+
+  Result_Type eval(const Vec2_Type &p) const;
+
+  Result_Type eval(const Vec3_Type &p) const;
+
+  Result_Type eval(const Vec4_Type &p) const;
+
+  // Evaluation with the analytic gradient, returned through deriv. The
+  // value is the one of the overload above
+  Result_Type eval(const Vec2_Type &p, Vec2_Type &deriv) const;
+
+  Result_Type eval(const Vec3_Type &p, Vec3_Type &deriv) const;
+
+  Result_Type eval(const Vec4_Type &p, Vec4_Type &deriv) const;
+
+  // Same contract as PerlinNoise3D::evalGrid. There is no per cell state
+  // worth caching on the simplex lattice, so the rows go through evalBatch
+  void evalGrid(const Vec2_Type &origin, const Result_Type step,
+                const std::size_t width, const std::size_t height,
+                Result_Type *out, const std::size_t stride,
+                const std::size_t column = 0, const std::size_t row = 0) const;
+
+  // Same as above for the z = origin.z slice of the 3D noise
+  void evalGrid(const Vec3_Type &origin, const Result_Type step,
+                const std::size_t width, const std::size_t height,
+                Result_Type *out, const std::size_t stride,
+                const std::size_t column = 0, const std::size_t row = 0) const;
+
+  // Evaluate the count samples (x[k], y[k]...) into out[k]. Float noise
+  // runs the widest vector kernel the CPU supports (noise::simd::dispatch),
+  // which matches eval bit for bit (see noise/simd/noise_kernels.inl)
+  void evalBatch(const Result_Type *x, const Result_Type *y,
+                 const std::size_t count, Result_Type *out) const;
+
+  void evalBatch(const Result_Type *x, const Result_Type *y,
+                 const Result_Type *z, const std::size_t count,
+                 Result_Type *out) const;
+
+  void evalBatch(const Result_Type *x, const Result_Type *y,
+                 const Result_Type *z, const Result_Type *w,
+                 const std::size_t count, Result_Type *out) const;
+
+private:
+  using Conv_Type = typename utils::int_least_fit_t<Seed_Type>;
+
+  static_assert(Period > 1 && !(Period & (Period - 1)),
+                "Period must be power of 2 different from 0");
+  static constexpr auto kTableSize{Period};
+  static constexpr auto kTableSizeMask{Period - 1};
+  // Same condition as PerlinNoise3D: int32 indices in the wide layout
+  static constexpr bool kHasKernels =
+      std::is_same_v<Result_Type, float> &&
+      std::is_same_v<Conv_Type, std::int32_t> && Layout == TableLayout::Wide;
+
+  // Samples per chunk of evalGrid, the coordinate rows live on the stack
+  static constexpr std::size_t kGridChunk = 256;
+
+  // Skew to the lattice of hypercubes (F) and back (G): (sqrt(N + 1) - 1) / N
+  // and (N + 1 - sqrt(N + 1)) / (N (N + 1))
+  static constexpr Result_Type kF2 =
+      static_cast<Result_Type>(0.36602540378443864676);
+  static constexpr Result_Type kG2 =
+      static_cast<Result_Type>(0.21132486540518711775);
+  static constexpr Result_Type kF3 = static_cast<Result_Type>(1.0 / 3.0);
+  static constexpr Result_Type kG3 = static_cast<Result_Type>(1.0 / 6.0);
+  static constexpr Result_Type kF4 =
+      static_cast<Result_Type>(0.30901699437494742410);
+  static constexpr Result_Type kG4 =
+      static_cast<Result_Type>(0.13819660112501051518);
+
+  // Squared radius of the corner falloffs. At 0.5 a falloff ends before the
+  // face of the simplex opposite to its corner, so it never leaks into a
+  // simplex that does not sum it and the noise stays C1 (the 0.6 often used
+  // in 3D and 4D leaves small discontinuities)
+  static constexpr Result_Type kRadius = static_cast<Result_Type>(0.5);
+  // Scales bringing the sums to [-1, 1]. The maxima found by gradient ascent
+  // from many starting points are 0.0221, 0.0130 and 0.0159 before scaling
+  static constexpr Result_Type kScale2 = 40;
+  static constexpr Result_Type kScale3 = 74;
+  static constexpr Result_Type kScale4 = 60;
+
+  // Dot product between (x, y...) and the gradient of the sets of
+  // Gustavson's grad() that h selects
+  static inline Result_Type gradientDot(const Conv_Type h,
+                                        const Result_Type x,
+                                        const Result_Type y);
+  static inline Result_Type gradientDot(const Conv_Type h,
+                                        const Result_Type x,
+                                        const Result_Type y,
+                                        const Result_Type z);
+  static inline Result_Type gradientDot(const Conv_Type h,
+                                        const Result_Type x,
+                                        const Result_Type y,
+                                        const Result_Type z,
+                                        const Result_Type w);
+
+  // The gradient selected by h itself, for the derivatives
+  template <std::size_t N>
+  static inline void gradient(const Conv_Type h, Result_Type (&g)[N]);
+
+  // t^4 * gd, the contribution of a corner at distance^2 r^2 - t, which
+  // vanishes outside of its radius. Whether a corner is in range is a coin
+  // toss for scattered samples, so t is clamped rather than branched on
+  static inline Result_Type falloff(const Result_Type t, const Result_Type gd) {
+    const Result_Type c = std::max(t, Result_Type{0});
+    const Result_Type c2 = c * c;
+    return c2 * c2 * gd;
+  }
+
+  // (a > b ? ra : rb) += 1, without a branch
+  static inline void rank(const Result_Type a, const Result_Type b,
+                          Conv_Type &ra, Conv_Type &rb) {
+    const Conv_Type greater = a > b;
+    ra += greater;
+    rb += 1 - greater;
+  }
+
+  // falloff(t, g.d) with t = r^2 - |d|^2, also adding its gradient with
+  // respect to the sample position, t^4 g - 8 t^3 (g.d) d, to deriv
+  template <std::size_t N>
+  static inline Result_Type falloff(const Result_Type t, const Result_Type gd,
+                                    const Result_Type (&g)[N],
+                                    const Result_Type (&d)[N],
+                                    Result_Type (&deriv)[N]);
+
+  PermutationTable<kTableSize, Conv_Type, Layout> permutationTable{};
+
+  inline Conv_Type hash(const Conv_Type x, const Conv_Type y,
+                        const Conv_Type z, const Conv_Type w) const {
+    return permutationTable[hash(x, y, z) + w];
+  }
+
+  inline Conv_Type hash(const Conv_Type x, const Conv_Type y,
+                        const Conv_Type z) const {
+    return permutationTable[permutationTable[permutationTable[x] + y] + z];
+  }
+
+  inline Conv_Type hash(const Conv_Type x, const Conv_Type y) const {
+    return permutationTable[permutationTable[x] + y];
+  }
+};
+
+} // namespace noise
+
+#include "noise/simplex_noise_impl.hpp"
+
+#endif // !SIMPLEX_NOISE_H
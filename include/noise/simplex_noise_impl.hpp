@@ -0,0 +1,603 @@
+
+#ifndef SIMPLEX_NOISE_IMPL_H
+#define SIMPLEX_NOISE_IMPL_H
+
+#include <functional>
+
+#include "noise/simplex_noise.hpp"
+
+#include "noise/simd/noise_kernels.hpp"
+#include "utils/fast_convertion.hpp"
+
+namespace noise {
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout>
+SimplexNoise<Period, Engine, Result_Type, Layout>::SimplexNoise(
+    Seed_Type seed) {
+  Engine generator;
+  generator.seed(seed);
+
+  for (auto i = 0; i < kTableSize; ++i) {
+    permutationTable.at(i) = i;
+  }
+
+  // shuffle values of the permutation table
+  std::uniform_int_distribution distrUInt{0, kTableSizeMask};
+  auto randUInt = std::bind(distrUInt, generator);
+  for (auto k = 0; k < kTableSize; ++k) {
+    auto i = randUInt();
+    std::swap(permutationTable.at(k), permutationTable.at(i));
+    permutationTable.mirror(k);
+  }
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout>
+constexpr SimplexNoise<Period, Engine, Result_Type, Layout>::SimplexNoise(
+    const StaticSeed seed) {
+  utils::SplitMix64 generator{seed.value};
+  drawPermutation(permutationTable, generator);
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout>
+Result_Type SimplexNoise<Period, Engine, Result_Type, Layout>::gradientDot(
+    const Conv_Type h, const Result_Type x, const Result_Type y) {
+  // (+-1, +-2) and (+-2, +-1): u, v = b < 4 ? x, y : y, x
+  constexpr auto sign = kHashSign<Result_Type>;
+  const unsigned b = static_cast<unsigned>(h) & 7;
+  const Result_Type p[2] = {x, y};
+  const Result_Type u = p[b >> 2];
+  const Result_Type v = p[1 - (b >> 2)];
+  return u * sign[b & 1] + 2 * v * sign[(b >> 1) & 1];
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout>
+Result_Type SimplexNoise<Period, Engine, Result_Type, Layout>::gradientDot(
+    const Conv_Type h, const Result_Type x, const Result_Type y,
+    const Result_Type z) {
+  // The 12 edges of a cube, as PerlinGradients::Improved
+  return improvedGradientDot(h, x, y, z);
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout>
+Result_Type SimplexNoise<Period, Engine, Result_Type, Layout>::gradientDot(
+    const Conv_Type h, const Result_Type x, const Result_Type y,
+    const Result_Type z, const Result_Type w) {
+  // The 32 edges of a 4D hypercube, one component being 0:
+  // u = b < 24 ? x : y, v = b < 16 ? y : z, t = b < 8 ? z : w
+  constexpr auto sign = kHashSign<Result_Type>;
+  const unsigned b = static_cast<unsigned>(h) & 31;
+  const Result_Type p[4] = {x, y, z, w};
+  const Result_Type u = p[b >= 24];
+  const Result_Type v = p[1 + (b >= 16)];
+  const Result_Type t = p[2 + (b >= 8)];
+  return u * sign[b & 1] + v * sign[(b >> 1) & 1] + t * sign[(b >> 2) & 1];
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout>
+template <std::size_t N>
+void SimplexNoise<Period, Engine, Result_Type, Layout>::gradient(
+    const Conv_Type h, Result_Type (&g)[N]) {
+  static_assert(N >= 2 && N <= 4, "Simplex noise is 2D, 3D or 4D");
+
+  // Axes of u, v (and t) in the gradientDot of the same dimension
+  std::size_t axes[3] = {0, 1, 2};
+  Conv_Type b = h;
+  if constexpr (N == 2) {
+    b = h & 7;
+    axes[0] = b < 4 ? 0 : 1;
+    axes[1] = b < 4 ? 1 : 0;
+  } else if constexpr (N == 3) {
+    b = h & 15;
+    axes[0] = b < 8 ? 0 : 1;
+    axes[1] = b < 4 ? 1 : (b == 12 || b == 14 ? 0 : 2);
+  } else {
+    b = h & 31;
+    axes[0] = b < 24 ? 0 : 1;
+    axes[1] = b < 16 ? 1 : 2;
+    axes[2] = b < 8 ? 2 : 3;
+  }
+
+  for (std::size_t a = 0; a < N; ++a) {
+    g[a] = 0;
+  }
+  g[axes[0]] = (b & 1) ? -1 : 1;
+  g[axes[1]] = ((b & 2) ? -1 : 1) * (N == 2 ? 2 : 1);
+  if constexpr (N == 4) {
+    g[axes[2]] = (b & 4) ? -1 : 1;
+  }
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout>
+template <std::size_t N>
+Result_Type SimplexNoise<Period, Engine, Result_Type, Layout>::falloff(
+    const Result_Type t, const Result_Type gd, const Result_Type (&g)[N],
+    const Result_Type (&d)[N], Result_Type (&deriv)[N]) {
+  const Result_Type c = std::max(t, Result_Type{0});
+  const Result_Type c2 = c * c;
+  const Result_Type c4 = c2 * c2;
+  const Result_Type k = 8 * c2 * c * gd;
+  for (std::size_t a = 0; a < N; ++a) {
+    deriv[a] += c4 * g[a] - k * d[a];
+  }
+  return c4 * gd;
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout>
+Result_Type SimplexNoise<Period, Engine, Result_Type, Layout>::eval(
+    const Vec2_Type &p) const {
+
+  constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
+
+  // Cell of the skewed lattice, and position relative to its origin
+  const Result_Type s = (p.x + p.y) * kF2;
+  const Conv_Type i = fast_int_trunc(p.x + s);
+  const Conv_Type j = fast_int_trunc(p.y + s);
+
+  const Result_Type t = static_cast<Result_Type>(i + j) * kG2;
+  const Result_Type x0 = p.x - (static_cast<Result_Type>(i) - t);
+  const Result_Type y0 = p.y - (static_cast<Result_Type>(j) - t);
+
+  // Middle corner of the simplex, along the larger coordinate first
+  const Conv_Type i1 = x0 > y0;
+  const Conv_Type j1 = 1 - i1;
+
+  const Result_Type x1 = x0 - static_cast<Result_Type>(i1) + kG2;
+  const Result_Type y1 = y0 - static_cast<Result_Type>(j1) + kG2;
+  const Result_Type x2 = x0 - 1 + 2 * kG2;
+  const Result_Type y2 = y0 - 1 + 2 * kG2;
+
+  const Conv_Type ii = i & kTableSizeMask;
+  const Conv_Type jj = j & kTableSizeMask;
+
+  const Conv_Type h0 = hash(ii, jj);
+  const Conv_Type h1 =
+      hash((ii + i1) & kTableSizeMask, (jj + j1) & kTableSizeMask);
+  const Conv_Type h2 =
+      hash((ii + 1) & kTableSizeMask, (jj + 1) & kTableSizeMask);
+
+  const Result_Type n0 =
+      falloff(kRadius - x0 * x0 - y0 * y0, gradientDot(h0, x0, y0));
+  const Result_Type n1 =
+      falloff(kRadius - x1 * x1 - y1 * y1, gradientDot(h1, x1, y1));
+  const Result_Type n2 =
+      falloff(kRadius - x2 * x2 - y2 * y2, gradientDot(h2, x2, y2));
+
+  return kScale2 * (n0 + n1 + n2);
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout>
+Result_Type SimplexNoise<Period, Engine, Result_Type, Layout>::eval(
+    const Vec3_Type &p) const {
+
+  constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
+
+  const Result_Type s = (p.x + p.y + p.z) * kF3;
+  const Conv_Type i = fast_int_trunc(p.x + s);
+  const Conv_Type j = fast_int_trunc(p.y + s);
+  const Conv_Type k = fast_int_trunc(p.z + s);
+
+  const Result_Type t = static_cast<Result_Type>(i + j + k) * kG3;
+  const Result_Type x0 = p.x - (static_cast<Result_Type>(i) - t);
+  const Result_Type y0 = p.y - (static_cast<Result_Type>(j) - t);
+  const Result_Type z0 = p.z - (static_cast<Result_Type>(k) - t);
+
+  // Rank of each coordinate, the simplex walks from the largest one down
+  Conv_Type rankX = 0, rankY = 0, rankZ = 0;
+  rank(x0, y0, rankX, rankY);
+  rank(x0, z0, rankX, rankZ);
+  rank(y0, z0, rankY, rankZ);
+
+  const Conv_Type i1 = rankX >= 2, j1 = rankY >= 2, k1 = rankZ >= 2;
+  const Conv_Type i2 = rankX >= 1, j2 = rankY >= 1, k2 = rankZ >= 1;
+
+  const Result_Type x1 = x0 - static_cast<Result_Type>(i1) + kG3;
+  const Result_Type y1 = y0 - static_cast<Result_Type>(j1) + kG3;
+  const Result_Type z1 = z0 - static_cast<Result_Type>(k1) + kG3;
+  const Result_Type x2 = x0 - static_cast<Result_Type>(i2) + 2 * kG3;
+  const Result_Type y2 = y0 - static_cast<Result_Type>(j2) + 2 * kG3;
+  const Result_Type z2 = z0 - static_cast<Result_Type>(k2) + 2 * kG3;
+  const Result_Type x3 = x0 - 1 + 3 * kG3;
+  const Result_Type y3 = y0 - 1 + 3 * kG3;
+  const Result_Type z3 = z0 - 1 + 3 * kG3;
+
+  const Conv_Type ii = i & kTableSizeMask;
+  const Conv_Type jj = j & kTableSizeMask;
+  const Conv_Type kk = k & kTableSizeMask;
+
+  const Conv_Type h0 = hash(ii, jj, kk);
+  const Conv_Type h1 =
+      hash((ii + i1) & kTableSizeMask, (jj + j1) & kTableSizeMask,
+           (kk + k1) & kTableSizeMask);
+  const Conv_Type h2 =
+      hash((ii + i2) & kTableSizeMask, (jj + j2) & kTableSizeMask,
+           (kk + k2) & kTableSizeMask);
+  const Conv_Type h3 =
+      hash((ii + 1) & kTableSizeMask, (jj + 1) & kTableSizeMask,
+           (kk + 1) & kTableSizeMask);
+
+  const Result_Type n0 = falloff(kRadius - x0 * x0 - y0 * y0 - z0 * z0,
+                                 gradientDot(h0, x0, y0, z0));
+  const Result_Type n1 = falloff(kRadius - x1 * x1 - y1 * y1 - z1 * z1,
+                                 gradientDot(h1, x1, y1, z1));
+  const Result_Type n2 = falloff(kRadius - x2 * x2 - y2 * y2 - z2 * z2,
+                                 gradientDot(h2, x2, y2, z2));
+  const Result_Type n3 = falloff(kRadius - x3 * x3 - y3 * y3 - z3 * z3,
+                                 gradientDot(h3, x3, y3, z3));
+
+  return kScale3 * (n0 + n1 + n2 + n3);
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout>
+Result_Type SimplexNoise<Period, Engine, Result_Type, Layout>::eval(
+    const Vec4_Type &p) const {
+
+  constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
+
+  const Result_Type s = (p.x + p.y + p.z + p.w) * kF4;
+  const Conv_Type i = fast_int_trunc(p.x + s);
+  const Conv_Type j = fast_int_trunc(p.y + s);
+  const Conv_Type k = fast_int_trunc(p.z + s);
+  const Conv_Type l = fast_int_trunc(p.w + s);
+
+  const Result_Type t = static_cast<Result_Type>(i + j + k + l) * kG4;
+  const Result_Type x0 = p.x - (static_cast<Result_Type>(i) - t);
+  const Result_Type y0 = p.y - (static_cast<Result_Type>(j) - t);
+  const Result_Type z0 = p.z - (static_cast<Result_Type>(k) - t);
+  const Result_Type w0 = p.w - (static_cast<Result_Type>(l) - t);
+
+  Conv_Type rankX = 0, rankY = 0, rankZ = 0, rankW = 0;
+  rank(x0, y0, rankX, rankY);
+  rank(x0, z0, rankX, rankZ);
+  rank(x0, w0, rankX, rankW);
+  rank(y0, z0, rankY, rankZ);
+  rank(y0, w0, rankY, rankW);
+  rank(z0, w0, rankZ, rankW);
+
+  const Conv_Type i1 = rankX >= 3, j1 = rankY >= 3;
+  const Conv_Type k1 = rankZ >= 3, l1 = rankW >= 3;
+  const Conv_Type i2 = rankX >= 2, j2 = rankY >= 2;
+  const Conv_Type k2 = rankZ >= 2, l2 = rankW >= 2;
+  const Conv_Type i3 = rankX >= 1, j3 = rankY >= 1;
+  const Conv_Type k3 = rankZ >= 1, l3 = rankW >= 1;
+
+  const Result_Type x1 = x0 - static_cast<Result_Type>(i1) + kG4;
+  const Result_Type y1 = y0 - static_cast<Result_Type>(j1) + kG4;
+  const Result_Type z1 = z0 - static_cast<Result_Type>(k1) + kG4;
+  const Result_Type w1 = w0 - static_cast<Result_Type>(l1) + kG4;
+  const Result_Type x2 = x0 - static_cast<Result_Type>(i2) + 2 * kG4;
+  const Result_Type y2 = y0 - static_cast<Result_Type>(j2) + 2 * kG4;
+  const Result_Type z2 = z0 - static_cast<Result_Type>(k2) + 2 * kG4;
+  const Result_Type w2 = w0 - static_cast<Result_Type>(l2) + 2 * kG4;
+  const Result_Type x3 = x0 - static_cast<Result_Type>(i3) + 3 * kG4;
+  const Result_Type y3 = y0 - static_cast<Result_Type>(j3) + 3 * kG4;
+  const Result_Type z3 = z0 - static_cast<Result_Type>(k3) + 3 * kG4;
+  const Result_Type w3 = w0 - static_cast<Result_Type>(l3) + 3 * kG4;
+  const Result_Type x4 = x0 - 1 + 4 * kG4;
+  const Result_Type y4 = y0 - 1 + 4 * kG4;
+  const Result_Type z4 = z0 - 1 + 4 * kG4;
+  const Result_Type w4 = w0 - 1 + 4 * kG4;
+
+  const Conv_Type ii = i & kTableSizeMask;
+  const Conv_Type jj = j & kTableSizeMask;
+  const Conv_Type kk = k & kTableSizeMask;
+  const Conv_Type ll = l & kTableSizeMask;
+
+  auto cornerHash = [&](const Conv_Type di, const Conv_Type dj,
+                        const Conv_Type dk, const Conv_Type dl) {
+    return hash((ii + di) & kTableSizeMask, (jj + dj) & kTableSizeMask,
+                (kk + dk) & kTableSizeMask, (ll + dl) & kTableSizeMask);
+  };
+
+  const Conv_Type h0 = hash(ii, jj, kk, ll);
+  const Conv_Type h1 = cornerHash(i1, j1, k1, l1);
+  const Conv_Type h2 = cornerHash(i2, j2, k2, l2);
+  const Conv_Type h3 = cornerHash(i3, j3, k3, l3);
+  const Conv_Type h4 = cornerHash(1, 1, 1, 1);
+
+  const Result_Type n0 =
+      falloff(kRadius - x0 * x0 - y0 * y0 - z0 * z0 - w0 * w0,
+              gradientDot(h0, x0, y0, z0, w0));
+  const Result_Type n1 =
+      falloff(kRadius - x1 * x1 - y1 * y1 - z1 * z1 - w1 * w1,
+              gradientDot(h1, x1, y1, z1, w1));
+  const Result_Type n2 =
+      falloff(kRadius - x2 * x2 - y2 * y2 - z2 * z2 - w2 * w2,
+              gradientDot(h2, x2, y2, z2, w2));
+  const Result_Type n3 =
+      falloff(kRadius - x3 * x3 - y3 * y3 - z3 * z3 - w3 * w3,
+              gradientDot(h3, x3, y3, z3, w3));
+  const Result_Type n4 =
+      falloff(kRadius - x4 * x4 - y4 * y4 - z4 * z4 - w4 * w4,
+              gradientDot(h4, x4, y4, z4, w4));
+
+  return kScale4 * (n0 + n1 + n2 + n3 + n4);
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout>
+Result_Type SimplexNoise<Period, Engine, Result_Type, Layout>::eval(
+    const Vec2_Type &p, Vec2_Type &deriv) const {
+
+  constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
+
+  const Result_Type s = (p.x + p.y) * kF2;
+  const Conv_Type i = fast_int_trunc(p.x + s);
+  const Conv_Type j = fast_int_trunc(p.y + s);
+
+  const Result_Type t = static_cast<Result_Type>(i + j) * kG2;
+  const Result_Type x0 = p.x - (static_cast<Result_Type>(i) - t);
+  const Result_Type y0 = p.y - (static_cast<Result_Type>(j) - t);
+
+  const Conv_Type i1 = x0 > y0;
+  const Conv_Type j1 = 1 - i1;
+
+  // Offsets from the corners to p, and the corners relative to the cell
+  const Result_Type d[3][2] = {
+      {x0, y0},
+      {x0 - static_cast<Result_Type>(i1) + kG2,
+       y0 - static_cast<Result_Type>(j1) + kG2},
+      {x0 - 1 + 2 * kG2, y0 - 1 + 2 * kG2}};
+  const Conv_Type c[3][2] = {{0, 0}, {i1, j1}, {1, 1}};
+
+  const Conv_Type ii = i & kTableSizeMask;
+  const Conv_Type jj = j & kTableSizeMask;
+
+  Result_Type sum = 0;
+  Result_Type dsum[2] = {0, 0};
+  for (std::size_t n = 0; n < 3; ++n) {
+    const Conv_Type h = hash((ii + c[n][0]) & kTableSizeMask,
+                             (jj + c[n][1]) & kTableSizeMask);
+    Result_Type g[2];
+    gradient(h, g);
+    sum += falloff(kRadius - d[n][0] * d[n][0] - d[n][1] * d[n][1],
+                   gradientDot(h, d[n][0], d[n][1]), g, d[n], dsum);
+  }
+
+  deriv = Vec2_Type(kScale2 * dsum[0], kScale2 * dsum[1]);
+  return kScale2 * sum;
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout>
+Result_Type SimplexNoise<Period, Engine, Result_Type, Layout>::eval(
+    const Vec3_Type &p, Vec3_Type &deriv) const {
+
+  constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
+
+  const Result_Type s = (p.x + p.y + p.z) * kF3;
+  const Conv_Type i = fast_int_trunc(p.x + s);
+  const Conv_Type j = fast_int_trunc(p.y + s);
+  const Conv_Type k = fast_int_trunc(p.z + s);
+
+  const Result_Type t = static_cast<Result_Type>(i + j + k) * kG3;
+  const Result_Type x0 = p.x - (static_cast<Result_Type>(i) - t);
+  const Result_Type y0 = p.y - (static_cast<Result_Type>(j) - t);
+  const Result_Type z0 = p.z - (static_cast<Result_Type>(k) - t);
+
+  Conv_Type rankX = 0, rankY = 0, rankZ = 0;
+  rank(x0, y0, rankX, rankY);
+  rank(x0, z0, rankX, rankZ);
+  rank(y0, z0, rankY, rankZ);
+
+  const Conv_Type c[4][3] = {{0, 0, 0},
+                             {rankX >= 2, rankY >= 2, rankZ >= 2},
+                             {rankX >= 1, rankY >= 1, rankZ >= 1},
+                             {1, 1, 1}};
+  const Result_Type p0[3] = {x0, y0, z0};
+
+  const Conv_Type ii = i & kTableSizeMask;
+  const Conv_Type jj = j & kTableSizeMask;
+  const Conv_Type kk = k & kTableSizeMask;
+
+  Result_Type sum = 0;
+  Result_Type dsum[3] = {0, 0, 0};
+  for (std::size_t n = 0; n < 4; ++n) {
+    // Same expressions as eval, the first corner being p0 itself
+    Result_Type d[3];
+    for (std::size_t a = 0; a < 3; ++a) {
+      d[a] = n == 0 ? p0[a]
+                    : p0[a] - static_cast<Result_Type>(c[n][a]) +
+                          static_cast<Result_Type>(n) * kG3;
+    }
+    const Conv_Type h = hash((ii + c[n][0]) & kTableSizeMask,
+                             (jj + c[n][1]) & kTableSizeMask,
+                             (kk + c[n][2]) & kTableSizeMask);
+    Result_Type g[3];
+    gradient(h, g);
+    sum += falloff(kRadius - d[0] * d[0] - d[1] * d[1] - d[2] * d[2],
+                   gradientDot(h, d[0], d[1], d[2]), g, d, dsum);
+  }
+
+  deriv = Vec3_Type(kScale3 * dsum[0], kScale3 * dsum[1], kScale3 * dsum[2]);
+  return kScale3 * sum;
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout>
+Result_Type SimplexNoise<Period, Engine, Result_Type, Layout>::eval(
+    const Vec4_Type &p, Vec4_Type &deriv) const {
+
+  constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
+
+  const Result_Type s = (p.x + p.y + p.z + p.w) * kF4;
+  const Conv_Type i = fast_int_trunc(p.x + s);
+  const Conv_Type j = fast_int_trunc(p.y + s);
+  const Conv_Type k = fast_int_trunc(p.z + s);
+  const Conv_Type l = fast_int_trunc(p.w + s);
+
+  const Result_Type t = static_cast<Result_Type>(i + j + k + l) * kG4;
+  const Result_Type x0 = p.x - (static_cast<Result_Type>(i) - t);
+  const Result_Type y0 = p.y - (static_cast<Result_Type>(j) - t);
+  const Result_Type z0 = p.z - (static_cast<Result_Type>(k) - t);
+  const Result_Type w0 = p.w - (static_cast<Result_Type>(l) - t);
+
+  Conv_Type rankX = 0, rankY = 0, rankZ = 0, rankW = 0;
+  rank(x0, y0, rankX, rankY);
+  rank(x0, z0, rankX, rankZ);
+  rank(x0, w0, rankX, rankW);
+  rank(y0, z0, rankY, rankZ);
+  rank(y0, w0, rankY, rankW);
+  rank(z0, w0, rankZ, rankW);
+
+  const Conv_Type c[5][4] = {
+      {0, 0, 0, 0},
+      {rankX >= 3, rankY >= 3, rankZ >= 3, rankW >= 3},
+      {rankX >= 2, rankY >= 2, rankZ >= 2, rankW >= 2},
+      {rankX >= 1, rankY >= 1, rankZ >= 1, rankW >= 1},
+      {1, 1, 1, 1}};
+  const Result_Type p0[4] = {x0, y0, z0, w0};
+
+  const Conv_Type ii = i & kTableSizeMask;
+  const Conv_Type jj = j & kTableSizeMask;
+  const Conv_Type kk = k & kTableSizeMask;
+  const Conv_Type ll = l & kTableSizeMask;
+
+  Result_Type sum = 0;
+  Result_Type dsum[4] = {0, 0, 0, 0};
+  for (std::size_t n = 0; n < 5; ++n) {
+    Result_Type d[4];
+    for (std::size_t a = 0; a < 4; ++a) {
+      d[a] = n == 0 ? p0[a]
+                    : p0[a] - static_cast<Result_Type>(c[n][a]) +
+                          static_cast<Result_Type>(n) * kG4;
+    }
+    const Conv_Type h = hash(
+        (ii + c[n][0]) & kTableSizeMask, (jj + c[n][1]) & kTableSizeMask,
+        (kk + c[n][2]) & kTableSizeMask, (ll + c[n][3]) & kTableSizeMask);
+    Result_Type g[4];
+    gradient(h, g);
+    sum += falloff(
+        kRadius - d[0] * d[0] - d[1] * d[1] - d[2] * d[2] - d[3] * d[3],
+        gradientDot(h, d[0], d[1], d[2], d[3]), g, d, dsum);
+  }
+
+  deriv = Vec4_Type(kScale4 * dsum[0], kScale4 * dsum[1], kScale4 * dsum[2],
+                    kScale4 * dsum[3]);
+  return kScale4 * sum;
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout>
+void SimplexNoise<Period, Engine, Result_Type, Layout>::evalGrid(
+    const Vec2_Type &origin, const Result_Type step, const std::size_t width,
+    const std::size_t height, Result_Type *out, const std::size_t stride,
+    const std::size_t column, const std::size_t row) const {
+  Result_Type xs[kGridChunk], ys[kGridChunk];
+
+  for (std::size_t j = 0; j < height; ++j) {
+    const Result_Type py = origin.y + static_cast<Result_Type>(row + j) * step;
+    Result_Type *dst = out + j * stride;
+
+    for (std::size_t first = 0; first < width; first += kGridChunk) {
+      const std::size_t n =
+          width - first < kGridChunk ? width - first : kGridChunk;
+      for (std::size_t i = 0; i < n; ++i) {
+        xs[i] = origin.x + static_cast<Result_Type>(column + first + i) * step;
+        ys[i] = py;
+      }
+      evalBatch(xs, ys, n, dst + first);
+    }
+  }
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout>
+void SimplexNoise<Period, Engine, Result_Type, Layout>::evalGrid(
+    const Vec3_Type &origin, const Result_Type step, const std::size_t width,
+    const std::size_t height, Result_Type *out, const std::size_t stride,
+    const std::size_t column, const std::size_t row) const {
+  Result_Type xs[kGridChunk], ys[kGridChunk], zs[kGridChunk];
+
+  for (std::size_t j = 0; j < height; ++j) {
+    const Result_Type py = origin.y + static_cast<Result_Type>(row + j) * step;
+    Result_Type *dst = out + j * stride;
+
+    for (std::size_t first = 0; first < width; first += kGridChunk) {
+      const std::size_t n =
+          width - first < kGridChunk ? width - first : kGridChunk;
+      for (std::size_t i = 0; i < n; ++i) {
+        xs[i] = origin.x + static_cast<Result_Type>(column + first + i) * step;
+        ys[i] = py;
+        zs[i] = origin.z;
+      }
+      evalBatch(xs, ys, zs, n, dst + first);
+    }
+  }
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout>
+void SimplexNoise<Period, Engine, Result_Type, Layout>::evalBatch(
+    const Result_Type *x, const Result_Type *y, const std::size_t count,
+    Result_Type *out) const {
+
+  if constexpr (kHasKernels) {
+    const bool done = simd::dispatch([&](auto kernels) {
+      kernels.simplex2D(permutationTable.data(), kTableSizeMask, x, y, count,
+                        out);
+    });
+    if (done) {
+      return;
+    }
+  }
+
+  for (std::size_t k = 0; k < count; ++k) {
+    out[k] = eval(Vec2_Type(x[k], y[k]));
+  }
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout>
+void SimplexNoise<Period, Engine, Result_Type, Layout>::evalBatch(
+    const Result_Type *x, const Result_Type *y, const Result_Type *z,
+    const std::size_t count, Result_Type *out) const {
+
+  if constexpr (kHasKernels) {
+    const bool done = simd::dispatch([&](auto kernels) {
+      kernels.simplex3D(permutationTable.data(), kTableSizeMask, x, y, z,
+                        count, out);
+    });
+    if (done) {
+      return;
+    }
+  }
+
+  for (std::size_t k = 0; k < count; ++k) {
+    out[k] = eval(Vec3_Type(x[k], y[k], z[k]));
+  }
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          TableLayout Layout>
+void SimplexNoise<Period, Engine, Result_Type, Layout>::evalBatch(
+    const Result_Type *x, const Result_Type *y, const Result_Type *z,
+    const Result_Type *w, const std::size_t count, Result_Type *out) const {
+
+  if constexpr (kHasKernels) {
+    const bool done = simd::dispatch([&](auto kernels) {
+      kernels.simplex4D(permutationTable.data(), kTableSizeMask, x, y, z, w,
+                        count, out);
+    });
+    if (done) {
+      return;
+    }
+  }
+
+  for (std::size_t k = 0; k < count; ++k) {
+    out[k] = eval(Vec4_Type(x[k], y[k], z[k], w[k]));
+  }
+}
+
+} // namespace noise
+
+#endif // !SIMPLEX_NOISE_IMPL_H
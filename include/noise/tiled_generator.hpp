@@ -0,0 +1,142 @@
+#ifndef TILED_GENERATOR_H
+#define TILED_GENERATOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "utils/thread_pool.hpp"
+
+namespace noise {
+
+// Side of the square tiles a raster is split in. 64 x 64 floats are 16 KB,
+// which stays in L1 while a tile is produced
+constexpr std::size_t kDefaultTileSize = 64;
+
+// Window of a raster, in samples. Tiles are numbered row by row
+struct Tile {
+  std::size_t x, y;
+  std::size_t width, height;
+  std::size_t index;
+};
+
+inline std::size_t tileCount(const std::size_t width, const std::size_t height,
+                             const std::size_t tileSize = kDefaultTileSize) {
+  return ((width + tileSize - 1) / tileSize) *
+         ((height + tileSize - 1) / tileSize);
+}
+
+// Split the width x height raster at out (rows stride elements apart) into
+// tileSize x tileSize tiles and run fill(tile, tileOut) for every tile on
+// pool, tileOut pointing at the first sample of the tile. Each sample is
+// written by exactly one tile, from its raster coordinates only, so the
+// output is the same for any number of threads
+template <typename T, typename Fill>
+void generateTiles(utils::ThreadPool &pool, const std::size_t width,
+                   const std::size_t height, T *out, const std::size_t stride,
+                   Fill fill, const std::size_t tileSize = kDefaultTileSize) {
+  const std::size_t tilesX = (width + tileSize - 1) / tileSize;
+  const std::size_t tilesY = (height + tileSize - 1) / tileSize;
+
+  pool.parallelFor(tilesX * tilesY, [&](const std::size_t t) {
+    Tile tile;
+    tile.x = (t % tilesX) * tileSize;
+    tile.y = (t / tilesX) * tileSize;
+    tile.width = std::min(tileSize, width - tile.x);
+    tile.height = std::min(tileSize, height - tile.y);
+    tile.index = t;
+
+    fill(tile, out + tile.y * stride + tile.x);
+  });
+}
+
+// Tiled noise.evalGrid(origin, step, width, height, out, stride). The noise
+// tables are only read, so all the threads share the one instance. out
+// starts at raster row row, so a band of rows of a taller raster can be
+// produced on its own (see utils::writeImageBands)
+template <typename Noise, typename Vec_Type, typename T>
+void generateGrid(utils::ThreadPool &pool, const Noise &noise,
+                  const Vec_Type &origin, const T step,
+                  const std::size_t width, const std::size_t height, T *out,
+                  const std::size_t stride,
+                  const std::size_t tileSize = kDefaultTileSize,
+                  const std::size_t row = 0) {
+  generateTiles(
+      pool, width, height, out, stride,
+      [&](const Tile &tile, T *tileOut) {
+        noise.evalGrid(origin, step, tile.width, tile.height, tileOut, stride,
+                       tile.x, row + tile.y);
+      },
+      tileSize);
+}
+
+// generateGrid that also gathers the statistics of the samples into stats
+// (a utils::StreamingStats, or any type with its add, merge and reset), for
+// the rasters that do need data dependent normalization. Each tile is
+// accounted for right after it is produced, while it is in cache. A task
+// produces one row of tiles, left to right, into its own copy of stats, so
+// there is one copy per tile row rather than per tile. The copies are
+// merged in row order, so the result is the same for any number of
+// threads. Bands of tile rows (see row in generateGrid) merge the tiles in
+// the same order as the whole raster
+template <typename Noise, typename Vec_Type, typename T, typename Stats>
+void generateGridStats(utils::ThreadPool &pool, const Noise &noise,
+                       const Vec_Type &origin, const T step,
+                       const std::size_t width, const std::size_t height,
+                       T *out, const std::size_t stride, Stats &stats,
+                       const std::size_t tileSize = kDefaultTileSize,
+                       const std::size_t row = 0) {
+  const std::size_t tilesX = (width + tileSize - 1) / tileSize;
+  const std::size_t tilesY = (height + tileSize - 1) / tileSize;
+
+  // Empty copies, with the settings (e.g. histogram range) of stats
+  Stats empty = stats;
+  empty.reset();
+  std::vector<Stats> partial(tilesY, empty);
+
+  pool.parallelFor(tilesY, [&](const std::size_t ty) {
+    Tile tile;
+    tile.y = ty * tileSize;
+    tile.height = std::min(tileSize, height - tile.y);
+    for (std::size_t tx = 0; tx < tilesX; ++tx) {
+      tile.x = tx * tileSize;
+      tile.width = std::min(tileSize, width - tile.x);
+      tile.index = ty * tilesX + tx;
+
+      T *tileOut = out + tile.y * stride + tile.x;
+      noise.evalGrid(origin, step, tile.width, tile.height, tileOut, stride,
+                     tile.x, row + tile.y);
+      for (std::size_t j = 0; j < tile.height; ++j) {
+        partial[ty].add(tileOut + j * stride, tile.width);
+      }
+    }
+  });
+
+  for (const Stats &rowStats : partial) {
+    stats.merge(rowStats);
+  }
+}
+
+// Tiled out(i, j) = sample(i, j) for samples that are not a plain grid,
+// e.g. fractal sums. sample must be safe to call from several threads
+template <typename T, typename Sample>
+void generateSamples(utils::ThreadPool &pool, const std::size_t width,
+                     const std::size_t height, T *out,
+                     const std::size_t stride, Sample sample,
+                     const std::size_t tileSize = kDefaultTileSize) {
+  generateTiles(
+      pool, width, height, out, stride,
+      [&](const Tile &tile, T *tileOut) {
+        for (std::size_t j = 0; j < tile.height; ++j) {
+          T *row = tileOut + j * stride;
+          for (std::size_t i = 0; i < tile.width; ++i) {
+            row[i] = sample(tile.x + i, tile.y + j);
+          }
+        }
+      },
+      tileSize);
+}
+
+} // namespace noise
+
+#endif // !TILED_GENERATOR_H
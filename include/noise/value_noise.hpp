@@ -4,22 +4,32 @@
 
 #include <array>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <random>
 #include <type_traits>
+#include <utility>
 
+#include "noise/lattice_tables.hpp"
+#include "noise/noise_range.hpp"
 #include "noise/noise_remap.hpp"
+#include "noise/simd/kernel_remap.hpp"
 #include "utils/int_fit.hpp"
 #include "vec/vec2.hpp"
 #include "vec/vec3.hpp"
+#include "vec/vec4.hpp"
+#include "vec/vec5.hpp"
 
 
 namespace noise {
 
+// The layout only matters as TableLayout::Hashed, which replaces the table of
+// random values by a LatticeHash. There are no indices to narrow in 1D
 template <uint_least16_t Period = 256,
           typename Engine = std::default_random_engine,
           typename Result_Type = float,
-          RemapFunction<Result_Type> Remap_Func = smoothstepRemap<Result_Type>>
+          RemapFunction<Result_Type> Remap_Func = smoothstepRemap<Result_Type>,
+          TableLayout Layout = TableLayout::Wide>
 class ValueNoise1D {
 public:
   static_assert(std::is_floating_point<Result_Type>(),
@@ -27,13 +37,45 @@ public:
 
   using Dist = typename std::uniform_real_distribution<Result_Type>;
   using Seed_Type = typename Dist::result_type;
+  using Value_Type = Result_Type;
+
+  // Value noise is in [0, 1), not centered on 0
+  static constexpr bool kSignedOutput = false;
+
+  // Period of the lattice along every axis, 0 for the hashed layout whose
+  // lattice does not wrap. See noise/large_world.hpp
+  static constexpr std::size_t kPeriod =
+      Layout == TableLayout::Hashed ? 0 : Period;
+
+  // Bounds of eval in any dimension, for normalizing samples as they are
+  // produced (see noise/normalized_noise.hpp)
+  static constexpr Range<Result_Type> outputRange(const unsigned = 1) {
+    return Range<Result_Type>{low, high};
+  }
 
   ValueNoise1D(Seed_Type seed = 2011);
-  virtual ~ValueNoise1D();
+
+  // Tables drawn at compile time for a constexpr instance, see StaticSeed
+  explicit constexpr ValueNoise1D(const StaticSeed seed);
+
+  ~ValueNoise1D() = default;
 
   // Evaluate the noise function at position x
   Result_Type eval(const Result_Type x) const;
 
+  // Evaluate the count samples x[k] into out[k] with the widest vector
+  // kernel the CPU supports (noise::simd::dispatch). Matches eval bit for bit
+  void evalBatch(const Result_Type *x, const std::size_t count,
+                 Result_Type *out) const;
+
+  // The hashed layout only: lattice cell c along axis (0 for x) becomes the
+  // cell origin + c, see RebasedNoise in noise/large_world.hpp
+  template <TableLayout L = Layout>
+  std::enable_if_t<L == TableLayout::Hashed>
+  shiftLatticeOrigin(const std::size_t axis, const std::int64_t origin) {
+    lattice.shiftOrigin(axis, origin);
+  }
+
   // Copy Constructor and Assignment
   ValueNoise1D(const ValueNoise1D &other);
   ValueNoise1D &operator=(const ValueNoise1D &other);
@@ -51,30 +93,56 @@ protected:
   static constexpr auto kMaxVerticesMask{Period - 1};
   static constexpr Result_Type low{0.0};
   static constexpr Result_Type high{1.0};
-  std::array<Result_Type, kMaxVertices> r{0.0};
+
+  static constexpr bool kHashed = Layout == TableLayout::Hashed;
+  // Wrapping of the lattice coordinates, none without tables
+  static constexpr Conv_Type kLatticeMask =
+      kHashed ? ~Conv_Type{0} : Conv_Type{kMaxVerticesMask};
+
+  // The vector kernels need float values, int32 indices and a remap they
+  // have a vector version of
+  static constexpr simd::KernelRemap kKernelRemap =
+      simd::kernelRemap<Result_Type, Remap_Func>();
+  static constexpr bool kHasKernels =
+      std::is_same_v<Result_Type, float> &&
+      std::is_same_v<Conv_Type, std::int32_t> &&
+      kKernelRemap != simd::KernelRemap::None;
+
+  [[no_unique_address]] std::conditional_t<
+      kHashed, Unused, std::array<Result_Type, kMaxVertices>> r{};
+  [[no_unique_address]] std::conditional_t<kHashed, LatticeHash, Unused>
+      lattice{};
 };
 
 template <uint_least8_t Dimension = 2, uint_least16_t Period = 256,
           typename Engine = std::default_random_engine,
           typename Result_Type = float,
-          RemapFunction<Result_Type> Remap_Func = smoothstepRemap<Result_Type>>
+          RemapFunction<Result_Type> Remap_Func = smoothstepRemap<Result_Type>,
+          TableLayout Layout = TableLayout::Wide>
 class ValueNoiseND
-    : public ValueNoise1D<Period, Engine, Result_Type, Remap_Func> {
+    : public ValueNoise1D<Period, Engine, Result_Type, Remap_Func, Layout> {
 public:
   static_assert(
       2 <= Dimension && Dimension <= 5,
       "Dimension must be between 2 and 5. For 1 Dimensions use ValueNoise1D");
 
-  using ValueNoise1D = ValueNoise1D<Period, Engine, Result_Type, Remap_Func>;
+  using ValueNoise1D_Type =
+      ValueNoise1D<Period, Engine, Result_Type, Remap_Func, Layout>;
 
-  using Dist = typename ValueNoise1D::Dist;
-  using Seed_Type = typename ValueNoise1D::Seed_Type;
+  using Dist = typename ValueNoise1D_Type::Dist;
+  using Seed_Type = typename ValueNoise1D_Type::Seed_Type;
 
   ValueNoiseND(Seed_Type seed = 2011);
-  virtual ~ValueNoiseND();
+
+  // Tables drawn at compile time for a constexpr instance, see StaticSeed
+  explicit constexpr ValueNoiseND(const StaticSeed seed);
+
+  ~ValueNoiseND() = default;
 
   using Vec2_Type = typename vector::Vec2<Result_Type>;
   using Vec3_Type = typename vector::Vec3<Result_Type>;
+  using Vec4_Type = typename vector::Vec4<Result_Type>;
+  using Vec5_Type = typename vector::Vec5<Result_Type>;
 
   Result_Type eval(const Vec2_Type &p) const;
 
@@ -82,7 +150,56 @@ public:
   template <uint_least8_t T = Dimension>
   std::enable_if_t<3 <= T, Result_Type> eval(const Vec3_Type &p) const;
 
-  // TODO : create implementation for 4D and 5D Noise
+  // Implementation for 4D and 5D noise, over the 16 and 32 corners of the
+  // cell (see evalCell)
+  template <uint_least8_t T = Dimension>
+  std::enable_if_t<4 <= T, Result_Type> eval(const Vec4_Type &p) const;
+
+  template <uint_least8_t T = Dimension>
+  std::enable_if_t<5 <= T, Result_Type> eval(const Vec5_Type &p) const;
+
+  // Evaluation with the analytic gradient, returned through deriv. The
+  // value is the one of the overload without deriv. Needs a remap that
+  // noise::remapDeriv knows the derivative of
+  Result_Type eval(const Vec2_Type &p, Vec2_Type &deriv) const;
+
+  template <uint_least8_t T = Dimension>
+  std::enable_if_t<3 <= T, Result_Type> eval(const Vec3_Type &p,
+                                             Vec3_Type &deriv) const;
+
+  // Fill a width x height raster with the samples at origin + (i, j) * step.
+  // Rows are stride elements apart in out, whose first sample is (column,
+  // row) of the raster, so it can be filled tile by tile. Corner values are
+  // fetched once per lattice cell and the y remap once per row, instead of
+  // once per sample
+  void evalGrid(const Vec2_Type &origin, const Result_Type step,
+                const std::size_t width, const std::size_t height,
+                Result_Type *out, const std::size_t stride,
+                const std::size_t column = 0, const std::size_t row = 0) const;
+
+  // Same as above for the z = origin.z slice of the 3D noise
+  template <uint_least8_t T = Dimension>
+  std::enable_if_t<3 <= T> evalGrid(const Vec3_Type &origin,
+                                    const Result_Type step,
+                                    const std::size_t width,
+                                    const std::size_t height, Result_Type *out,
+                                    const std::size_t stride,
+                                    const std::size_t column = 0,
+                                    const std::size_t row = 0) const;
+
+  // Evaluate the count samples (x[k], y[k]) into out[k] with the widest
+  // vector kernel the CPU supports (noise::simd::dispatch). Matches eval bit
+  // for bit
+  void evalBatch(const Result_Type *x, const Result_Type *y,
+                 const std::size_t count, Result_Type *out) const;
+
+  // Same as above for the 3D samples (x[k], y[k], z[k])
+  template <uint_least8_t T = Dimension>
+  std::enable_if_t<3 <= T> evalBatch(const Result_Type *x,
+                                     const Result_Type *y,
+                                     const Result_Type *z,
+                                     const std::size_t count,
+                                     Result_Type *out) const;
 
   // Copy Constructor and Assignment
   ValueNoiseND(const ValueNoiseND &other);
@@ -93,19 +210,112 @@ public:
   ValueNoiseND &operator=(ValueNoiseND &&other) noexcept;
 
 protected:
-  using Conv_Type = typename ValueNoise1D::Conv_Type;
+  using Conv_Type = typename ValueNoise1D_Type::Conv_Type;
+
+  using ValueNoise1D_Type::kMaxVertices;
+  using ValueNoise1D_Type::kMaxVerticesMask;
+  using ValueNoise1D_Type::kKernelRemap;
+  using ValueNoise1D_Type::kHashed;
+  using ValueNoise1D_Type::kLatticeMask;
+  using ValueNoise1D_Type::r;
+  using ValueNoise1D_Type::lattice;
+
+  static constexpr RemapFunction<Result_Type> kRemapDeriv =
+      remapDeriv<Result_Type, Remap_Func>();
+
+  // The vector kernels read the wide permutation table, or hash
+  static constexpr bool kHasKernels =
+      ValueNoise1D_Type::kHasKernels &&
+      (Layout == TableLayout::Wide || kHashed);
+
+  [[no_unique_address]] std::conditional_t<
+      kHashed, Unused, PermutationTable<kMaxVertices, Conv_Type, Layout>>
+      permutationTable{};
+
+  // Corner hashes: hashStart(x) for the first axis, extended with the
+  // coordinate c of each next axis by hashExtend(h, axis, c), and the random
+  // value of a hash covering every axis. The chains go through the
+  // permutation table, or the LatticeHash of the hashed layout
+  using Hash_Type = std::conditional_t<kHashed, std::uint32_t, Conv_Type>;
+
+  inline Hash_Type hashStart(const Conv_Type x) const {
+    if constexpr (kHashed) {
+      return lattice.start(x);
+    } else {
+      return permutationTable[x];
+    }
+  }
 
-  using ValueNoise1D::kMaxVertices;
-  using ValueNoise1D::kMaxVerticesMask;
-  using ValueNoise1D::r;
+  inline Hash_Type hashExtend(const Hash_Type h, const std::size_t axis,
+                              const Conv_Type c) const {
+    if constexpr (kHashed) {
+      return lattice.extend(h, axis, c);
+    } else {
+      return permutationTable[h + c];
+    }
+  }
 
-  std::array<Conv_Type, kMaxVertices * 2> permutationTable{0};
+  inline Result_Type hashValue(const Hash_Type h) const {
+    if constexpr (kHashed) {
+      return LatticeHash::toUnit<Result_Type>(LatticeHash::finish(h));
+    } else {
+      return r[h];
+    }
+  }
+
+  // Interpolated value of the cell whose wrapped lattice coordinates are
+  // rc[a][0] and rc[a][1] = rc[a][0] + 1 along each axis a, at the remapped
+  // fractions s. The corner hashes perm[...perm[perm[x] + y]...] are built
+  // one axis at a time, so the corners sharing a prefix share its lookups:
+  // 2 + 4 + ... + 2^N of them instead of N 2^N
+  template <std::size_t N>
+  Result_Type evalCell(const Conv_Type (&rc)[N][2],
+                       const Result_Type (&s)[N]) const;
+
+  // rc and s of evalCell for the coordinates p
+  template <std::size_t N>
+  static inline void cellOf(const Result_Type (&p)[N], Conv_Type (&rc)[N][2],
+                            Result_Type (&s)[N]);
+
+  // The steps of evalCell are unrolled through index sequences, which lets
+  // the hashes and values live in registers. Bit a of a corner index selects
+  // rc[a][0] or rc[a][1]
+
+  // Hashes of the corners of axes [0, A] from the ones of axes [0, A)
+  template <std::size_t... K>
+  inline std::array<Hash_Type, 2 * sizeof...(K)>
+  extendHashes(const std::array<Hash_Type, sizeof...(K)> &h,
+               const std::size_t axis, const Conv_Type (&rc)[2],
+               std::index_sequence<K...>) const;
+
+  template <std::size_t... K>
+  inline std::array<Result_Type, sizeof...(K)>
+  cornerValues(const std::array<Hash_Type, sizeof...(K)> &h,
+               std::index_sequence<K...>) const;
+
+  // Interpolation along the lowest axis left, between corners 2m and 2m + 1
+  template <std::size_t... M>
+  static inline std::array<Result_Type, sizeof...(M)>
+  lerpPairs(const std::array<Result_Type, 2 * sizeof...(M)> &c,
+            const Result_Type s, std::index_sequence<M...>);
+
+  template <std::size_t A, std::size_t N, std::size_t C>
+  inline auto cornerHashes(const std::array<Hash_Type, C> &h,
+                           const Conv_Type (&rc)[N][2]) const;
+
+  template <std::size_t A, std::size_t N, std::size_t C>
+  static inline Result_Type interpolate(const std::array<Result_Type, C> &c,
+                                        const Result_Type (&s)[N]);
 };
 
 using ValueNoise2D = ValueNoiseND<2>;
 
 using ValueNoise3D = ValueNoiseND<3>;
 
+using ValueNoise4D = ValueNoiseND<4>;
+
+using ValueNoise5D = ValueNoiseND<5>;
+
 } // namespace noise
 
 #include "noise/value_noise_impl.hpp"
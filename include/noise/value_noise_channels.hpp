@@ -0,0 +1,119 @@
+#ifndef VALUE_NOISE_CHANNELS_H
+#define VALUE_NOISE_CHANNELS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+
+#include "noise/lattice_tables.hpp"
+#include "noise/noise_range.hpp"
+#include "noise/noise_remap.hpp"
+#include "utils/int_fit.hpp"
+#include "vec/vec2.hpp"
+#include "vec/vec3.hpp"
+
+namespace noise {
+
+// Channels decorrelated value noises sampled together, for domain warping
+// and other uses of several noises at the same point. The channels share
+// the permutation, so a sample computes the cell, the remap weights and the
+// corner hashes once; each corner then holds the random values of every
+// channel side by side (one cache line for 4 floats) instead of one table
+// per noise. The values of each channel are drawn independently, which
+// makes the channels as decorrelated as noises of different seeds. Channel 0
+// is the ValueNoiseND of the same seed and parameters
+template <std::size_t Channels, uint_least8_t Dimension = 2,
+          uint_least16_t Period = 256,
+          typename Engine = std::default_random_engine,
+          typename Result_Type = float,
+          RemapFunction<Result_Type> Remap_Func = smoothstepRemap<Result_Type>,
+          TableLayout Layout = TableLayout::Wide>
+class ValueNoiseChannels {
+public:
+  static_assert(std::is_floating_point<Result_Type>(),
+                "Result_Type must be a floating point type");
+  static_assert(Channels >= 1, "At least one channel is needed");
+  static_assert(Dimension == 2 || Dimension == 3,
+                "Dimension must be 2 or 3");
+  static_assert(Layout != TableLayout::Hashed,
+                "The channel values live in a table, there is no hashed "
+                "layout");
+
+  using Dist = typename std::uniform_real_distribution<Result_Type>;
+  using Seed_Type = typename Dist::result_type;
+  using Value_Type = Result_Type;
+
+  // The samples of all the channels at one point
+  using Channels_Type = std::array<Result_Type, Channels>;
+
+  static constexpr bool kSignedOutput = false;
+
+  static constexpr Range<Result_Type> outputRange(const unsigned = 2) {
+    return Range<Result_Type>{low, high};
+  }
+
+  using Vec2_Type = typename vector::Vec2<Result_Type>;
+  using Vec3_Type = typename vector::Vec3<Result_Type>;
+
+  ValueNoiseChannels(Seed_Type seed = 2011);
+
+  Channels_Type eval(const Vec2_Type &p) const;
+
+  template <uint_least8_t T = Dimension>
+  std::enable_if_t<3 <= T, Channels_Type> eval(const Vec3_Type &p) const;
+
+  // Domain warping fused in one call: the first 2 (or 3) channels at p,
+  // mapped to [-strength, strength), displace p, and all the channels are
+  // sampled at the displaced point. Needs more channels than coordinates,
+  // so at least one channel is not correlated with the displacement
+  Channels_Type evalWarped(const Vec2_Type &p, const Result_Type strength) const;
+
+  template <uint_least8_t T = Dimension>
+  std::enable_if_t<3 <= T, Channels_Type>
+  evalWarped(const Vec3_Type &p, const Result_Type strength) const;
+
+  // Evaluate the count samples (x[k], y[k]...) into out[k * Channels + c],
+  // the channels of a sample side by side
+  void evalBatch(const Result_Type *x, const Result_Type *y,
+                 const std::size_t count, Result_Type *out) const;
+
+  template <uint_least8_t T = Dimension>
+  std::enable_if_t<3 <= T> evalBatch(const Result_Type *x,
+                                     const Result_Type *y,
+                                     const Result_Type *z,
+                                     const std::size_t count,
+                                     Result_Type *out) const;
+
+private:
+  using Conv_Type = typename utils::int_least_fit_t<Seed_Type>;
+
+  static_assert(Period > 1 && !(Period & (Period - 1)),
+                "Period must be power of 2 different from 0");
+  static constexpr auto kMaxVertices{Period};
+  static constexpr auto kMaxVerticesMask{Period - 1};
+  static constexpr Result_Type low{0.0};
+  static constexpr Result_Type high{1.0};
+
+  // c0 + (c1 - c0) * s for every channel, in the arithmetic of utils::lerp
+  static inline Channels_Type lerpChannels(const Channels_Type &c0,
+                                           const Channels_Type &c1,
+                                           const Result_Type s);
+
+  // p + strength * (2 v - 1) along each coordinate, from the channels v
+  static inline Result_Type warp(const Result_Type p, const Result_Type v,
+                                 const Result_Type strength) {
+    return p + strength * (2 * v - 1);
+  }
+
+  // The values of all the channels at a lattice point, interleaved
+  std::array<Channels_Type, kMaxVertices> r{};
+  PermutationTable<kMaxVertices, Conv_Type, Layout> permutationTable{};
+};
+
+} // namespace noise
+
+#include "noise/value_noise_channels_impl.hpp"
+
+#endif // !VALUE_NOISE_CHANNELS_H
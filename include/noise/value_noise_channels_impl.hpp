@@ -0,0 +1,219 @@
+#ifndef VALUE_NOISE_CHANNELS_IMPL_H
+#define VALUE_NOISE_CHANNELS_IMPL_H
+
+#include "noise/value_noise_channels.hpp"
+
+#include <functional>
+#include <utility>
+
+#include "utils/fast_convertion.hpp"
+#include "utils/lerp.hpp"
+
+namespace noise {
+
+template <std::size_t Channels, uint_least8_t Dimension,
+          uint_least16_t Period, typename Engine, typename Result_Type,
+          RemapFunction<Result_Type> Remap_Func, TableLayout Layout>
+ValueNoiseChannels<Channels, Dimension, Period, Engine, Result_Type,
+                   Remap_Func, Layout>::ValueNoiseChannels(Seed_Type seed) {
+  Dist distribution{low, high};
+  Engine generator;
+
+  // Channel 0 and the permutation are drawn as by ValueNoiseND
+  generator.seed(seed);
+  for (auto i = 0; i < kMaxVertices; ++i) {
+    r[i][0] = distribution(generator);
+    permutationTable.at(i) = i;
+  }
+
+  // shuffle values of the permutation table
+  std::uniform_int_distribution distrUInt{0, kMaxVerticesMask};
+  auto randUInt = std::bind(distrUInt, generator);
+  for (auto k = 0; k < kMaxVertices; ++k) {
+    auto i = randUInt();
+    std::swap(permutationTable.at(k), permutationTable.at(i));
+    permutationTable.mirror(k);
+  }
+
+  // The other channels continue the stream of the values
+  for (std::size_t c = 1; c < Channels; ++c) {
+    for (auto i = 0; i < kMaxVertices; ++i) {
+      r[i][c] = distribution(generator);
+    }
+  }
+}
+
+template <std::size_t Channels, uint_least8_t Dimension,
+          uint_least16_t Period, typename Engine, typename Result_Type,
+          RemapFunction<Result_Type> Remap_Func, TableLayout Layout>
+inline typename ValueNoiseChannels<Channels, Dimension, Period, Engine,
+                                   Result_Type, Remap_Func,
+                                   Layout>::Channels_Type
+ValueNoiseChannels<Channels, Dimension, Period, Engine, Result_Type,
+                   Remap_Func, Layout>::lerpChannels(const Channels_Type &c0,
+                                                     const Channels_Type &c1,
+                                                     const Result_Type s) {
+  constexpr auto lerp = utils::lerp<Result_Type>;
+  Channels_Type out;
+  for (std::size_t c = 0; c < Channels; ++c) {
+    out[c] = lerp(c0[c], c1[c], s);
+  }
+  return out;
+}
+
+template <std::size_t Channels, uint_least8_t Dimension,
+          uint_least16_t Period, typename Engine, typename Result_Type,
+          RemapFunction<Result_Type> Remap_Func, TableLayout Layout>
+typename ValueNoiseChannels<Channels, Dimension, Period, Engine, Result_Type,
+                            Remap_Func, Layout>::Channels_Type
+ValueNoiseChannels<Channels, Dimension, Period, Engine, Result_Type,
+                   Remap_Func, Layout>::eval(const Vec2_Type &p) const {
+  constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
+  const Conv_Type xi = fast_int_trunc(p.x);
+  const Conv_Type yi = fast_int_trunc(p.y);
+
+  const Result_Type tx = p.x - static_cast<Result_Type>(xi);
+  const Result_Type ty = p.y - static_cast<Result_Type>(yi);
+
+  const Conv_Type rx0 = xi & kMaxVerticesMask;
+  const Conv_Type rx1 = (rx0 + 1) & kMaxVerticesMask;
+  const Conv_Type ry0 = yi & kMaxVerticesMask;
+  const Conv_Type ry1 = (ry0 + 1) & kMaxVerticesMask;
+
+  // The channels of the corners of the cell, one hash chain for all
+  const Conv_Type hx0 = permutationTable[rx0];
+  const Conv_Type hx1 = permutationTable[rx1];
+  const Channels_Type &c00 = r[permutationTable[hx0 + ry0]];
+  const Channels_Type &c10 = r[permutationTable[hx1 + ry0]];
+  const Channels_Type &c01 = r[permutationTable[hx0 + ry1]];
+  const Channels_Type &c11 = r[permutationTable[hx1 + ry1]];
+
+  const Result_Type sx = (*Remap_Func)(tx);
+  const Result_Type sy = (*Remap_Func)(ty);
+
+  return lerpChannels(lerpChannels(c00, c10, sx), lerpChannels(c01, c11, sx),
+                      sy);
+}
+
+template <std::size_t Channels, uint_least8_t Dimension,
+          uint_least16_t Period, typename Engine, typename Result_Type,
+          RemapFunction<Result_Type> Remap_Func, TableLayout Layout>
+template <uint_least8_t T>
+std::enable_if_t<3 <= T, typename ValueNoiseChannels<
+                             Channels, Dimension, Period, Engine, Result_Type,
+                             Remap_Func, Layout>::Channels_Type>
+ValueNoiseChannels<Channels, Dimension, Period, Engine, Result_Type,
+                   Remap_Func, Layout>::eval(const Vec3_Type &p) const {
+  constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
+  const Conv_Type xi = fast_int_trunc(p.x);
+  const Conv_Type yi = fast_int_trunc(p.y);
+  const Conv_Type zi = fast_int_trunc(p.z);
+
+  const Result_Type tx = p.x - static_cast<Result_Type>(xi);
+  const Result_Type ty = p.y - static_cast<Result_Type>(yi);
+  const Result_Type tz = p.z - static_cast<Result_Type>(zi);
+
+  const Conv_Type rx0 = xi & kMaxVerticesMask;
+  const Conv_Type rx1 = (rx0 + 1) & kMaxVerticesMask;
+  const Conv_Type ry0 = yi & kMaxVerticesMask;
+  const Conv_Type ry1 = (ry0 + 1) & kMaxVerticesMask;
+  const Conv_Type rz0 = zi & kMaxVerticesMask;
+  const Conv_Type rz1 = (rz0 + 1) & kMaxVerticesMask;
+
+  // The channels of the corners of the cell, one hash chain for all
+  const Conv_Type hx0 = permutationTable[rx0];
+  const Conv_Type hx1 = permutationTable[rx1];
+  const Conv_Type h00 = permutationTable[hx0 + ry0];
+  const Conv_Type h10 = permutationTable[hx1 + ry0];
+  const Conv_Type h01 = permutationTable[hx0 + ry1];
+  const Conv_Type h11 = permutationTable[hx1 + ry1];
+
+  const Channels_Type &c000 = r[permutationTable[h00 + rz0]];
+  const Channels_Type &c100 = r[permutationTable[h10 + rz0]];
+  const Channels_Type &c010 = r[permutationTable[h01 + rz0]];
+  const Channels_Type &c110 = r[permutationTable[h11 + rz0]];
+  const Channels_Type &c001 = r[permutationTable[h00 + rz1]];
+  const Channels_Type &c101 = r[permutationTable[h10 + rz1]];
+  const Channels_Type &c011 = r[permutationTable[h01 + rz1]];
+  const Channels_Type &c111 = r[permutationTable[h11 + rz1]];
+
+  const Result_Type sx = (*Remap_Func)(tx);
+  const Result_Type sy = (*Remap_Func)(ty);
+  const Result_Type sz = (*Remap_Func)(tz);
+
+  const Channels_Type ny0 = lerpChannels(lerpChannels(c000, c100, sx),
+                                         lerpChannels(c010, c110, sx), sy);
+  const Channels_Type ny1 = lerpChannels(lerpChannels(c001, c101, sx),
+                                         lerpChannels(c011, c111, sx), sy);
+  return lerpChannels(ny0, ny1, sz);
+}
+
+template <std::size_t Channels, uint_least8_t Dimension,
+          uint_least16_t Period, typename Engine, typename Result_Type,
+          RemapFunction<Result_Type> Remap_Func, TableLayout Layout>
+typename ValueNoiseChannels<Channels, Dimension, Period, Engine, Result_Type,
+                            Remap_Func, Layout>::Channels_Type
+ValueNoiseChannels<Channels, Dimension, Period, Engine, Result_Type,
+                   Remap_Func, Layout>::evalWarped(const Vec2_Type &p,
+                                                   const Result_Type strength)
+    const {
+  static_assert(Channels > 2, "Warping 2D samples needs 3 or more channels");
+  const Channels_Type q = eval(p);
+  return eval(Vec2_Type(warp(p.x, q[0], strength), warp(p.y, q[1], strength)));
+}
+
+template <std::size_t Channels, uint_least8_t Dimension,
+          uint_least16_t Period, typename Engine, typename Result_Type,
+          RemapFunction<Result_Type> Remap_Func, TableLayout Layout>
+template <uint_least8_t T>
+std::enable_if_t<3 <= T, typename ValueNoiseChannels<
+                             Channels, Dimension, Period, Engine, Result_Type,
+                             Remap_Func, Layout>::Channels_Type>
+ValueNoiseChannels<Channels, Dimension, Period, Engine, Result_Type,
+                   Remap_Func, Layout>::evalWarped(const Vec3_Type &p,
+                                                   const Result_Type strength)
+    const {
+  static_assert(Channels > 3, "Warping 3D samples needs 4 or more channels");
+  const Channels_Type q = eval(p);
+  return eval(Vec3_Type(warp(p.x, q[0], strength), warp(p.y, q[1], strength),
+                        warp(p.z, q[2], strength)));
+}
+
+template <std::size_t Channels, uint_least8_t Dimension,
+          uint_least16_t Period, typename Engine, typename Result_Type,
+          RemapFunction<Result_Type> Remap_Func, TableLayout Layout>
+void ValueNoiseChannels<Channels, Dimension, Period, Engine, Result_Type,
+                        Remap_Func, Layout>::evalBatch(const Result_Type *x,
+                                                       const Result_Type *y,
+                                                       const std::size_t count,
+                                                       Result_Type *out) const {
+  for (std::size_t k = 0; k < count; ++k) {
+    const Channels_Type v = eval(Vec2_Type(x[k], y[k]));
+    for (std::size_t c = 0; c < Channels; ++c) {
+      out[k * Channels + c] = v[c];
+    }
+  }
+}
+
+template <std::size_t Channels, uint_least8_t Dimension,
+          uint_least16_t Period, typename Engine, typename Result_Type,
+          RemapFunction<Result_Type> Remap_Func, TableLayout Layout>
+template <uint_least8_t T>
+std::enable_if_t<3 <= T>
+ValueNoiseChannels<Channels, Dimension, Period, Engine, Result_Type,
+                   Remap_Func, Layout>::evalBatch(const Result_Type *x,
+                                                  const Result_Type *y,
+                                                  const Result_Type *z,
+                                                  const std::size_t count,
+                                                  Result_Type *out) const {
+  for (std::size_t k = 0; k < count; ++k) {
+    const Channels_Type v = eval(Vec3_Type(x[k], y[k], z[k]));
+    for (std::size_t c = 0; c < Channels; ++c) {
+      out[k * Channels + c] = v[c];
+    }
+  }
+}
+
+} // namespace noise
+
+#endif // !VALUE_NOISE_CHANNELS_IMPL_H
@@ -7,38 +7,60 @@
 #include <cassert>
 #include <functional>
 
+#include "noise/simd/noise_kernels.hpp"
 #include "utils/fast_convertion.hpp"
 #include "utils/int_fit.hpp"
 #include "utils/lerp.hpp"
 #include "vec/vec2.hpp"
+#include "vec/vec3.hpp"
+#include "vec/vec4.hpp"
+#include "vec/vec5.hpp"
 
 namespace noise
 {
 
 template <uint_least16_t Period, typename Engine, typename Result_Type,
-          RemapFunction<Result_Type> Remap_Func>
-ValueNoise1D<Period, Engine, Result_Type, Remap_Func>::ValueNoise1D(
+          RemapFunction<Result_Type> Remap_Func, TableLayout Layout>
+ValueNoise1D<Period, Engine, Result_Type, Remap_Func, Layout>::ValueNoise1D(
     Seed_Type seed)
 {
-  Dist distribution{ValueNoise1D::low, ValueNoise1D::high};
-  Engine generator;
-
-  generator.seed(seed);
-  for (auto i = 0; i < kMaxVertices; ++i)
+  if constexpr (kHashed)
+  {
+    lattice = LatticeHash::draw<Engine>(seed);
+  }
+  else
   {
-    r[i] = distribution(generator);
+    Dist distribution{ValueNoise1D::low, ValueNoise1D::high};
+    Engine generator;
+
+    generator.seed(seed);
+    for (auto i = 0; i < kMaxVertices; ++i)
+    {
+      r[i] = distribution(generator);
+    }
   }
 }
 
-// Auto Generated destructor
 template <uint_least16_t Period, typename Engine, typename Result_Type,
-          RemapFunction<Result_Type> Remap_Func>
-ValueNoise1D<Period, Engine, Result_Type, Remap_Func>::~ValueNoise1D() =
-    default;
+          RemapFunction<Result_Type> Remap_Func, TableLayout Layout>
+constexpr ValueNoise1D<Period, Engine, Result_Type, Remap_Func,
+                       Layout>::ValueNoise1D(const StaticSeed seed)
+{
+  utils::SplitMix64 generator{seed.value};
+  if constexpr (kHashed)
+  {
+    lattice = LatticeHash::draw(generator);
+  }
+  else
+  {
+    drawValues(r, generator);
+  }
+}
 
 template <uint_least16_t Period, typename Engine, typename Result_Type,
-          RemapFunction<Result_Type> Remap_Func>
-Result_Type ValueNoise1D<Period, Engine, Result_Type, Remap_Func>::eval(
+          RemapFunction<Result_Type> Remap_Func, TableLayout Layout>
+Result_Type
+ValueNoise1D<Period, Engine, Result_Type, Remap_Func, Layout>::eval(
     const Result_Type x) const
 {
   // Floor using Integer trunc function
@@ -46,80 +68,145 @@ Result_Type ValueNoise1D<Period, Engine, Result_Type, Remap_Func>::eval(
 
   const Result_Type t = x - static_cast<Result_Type>(xi);
 
-  // Modulo using the fact that kMaxVerticesMask is a power of 2
-  const Conv_Type xMin = xi & static_cast<Conv_Type>(kMaxVerticesMask);
-  const Conv_Type xMax = (xMin + 1) & static_cast<Conv_Type>(kMaxVerticesMask);
+  const Result_Type tx = (*Remap_Func)(t);
 
-  assert(xMin <= kMaxVertices - 1);
-  assert(xMax <= kMaxVertices - 1);
+  if constexpr (kHashed)
+  {
+    constexpr auto value = [](const std::uint32_t h) {
+      return LatticeHash::toUnit<Result_Type>(h);
+    };
+    return utils::lerp<Result_Type>(value(lattice(xi)), value(lattice(xi + 1)),
+                                    tx);
+  }
+  else
+  {
+    // Modulo using the fact that kMaxVerticesMask is a power of 2
+    const Conv_Type xMin = xi & static_cast<Conv_Type>(kMaxVerticesMask);
+    const Conv_Type xMax =
+        (xMin + 1) & static_cast<Conv_Type>(kMaxVerticesMask);
 
-  const Result_Type tx = (*Remap_Func)(t);
+    assert(xMin <= kMaxVertices - 1);
+    assert(xMax <= kMaxVertices - 1);
 
-  return utils::lerp<Result_Type>(r[xMin], r[xMax], tx);
+    return utils::lerp<Result_Type>(r[xMin], r[xMax], tx);
+  }
+}
+
+template <uint_least16_t Period, typename Engine, typename Result_Type,
+          RemapFunction<Result_Type> Remap_Func, TableLayout Layout>
+void ValueNoise1D<Period, Engine, Result_Type, Remap_Func,
+                  Layout>::evalBatch(
+    const Result_Type *x, const std::size_t count, Result_Type *out) const
+{
+  if constexpr (kHasKernels)
+  {
+    const bool done = simd::dispatch([&](auto kernels) {
+      if constexpr (kHashed)
+      {
+        kernels.template valueNoise1DHashed<kKernelRemap>(lattice, x, count,
+                                                          out);
+      }
+      else
+      {
+        kernels.template valueNoise1D<kKernelRemap>(
+            r.data(), kMaxVerticesMask, x, count, out);
+      }
+    });
+    if (done)
+    {
+      return;
+    }
+  }
+
+  for (std::size_t k = 0; k < count; ++k)
+  {
+    out[k] = eval(x[k]);
+  }
 }
 
 // Copy and Move auto generated members
 
 template <uint_least16_t Period, typename Engine, typename Result_Type,
-          RemapFunction<Result_Type> Remap_Func>
-ValueNoise1D<Period, Engine, Result_Type, Remap_Func>::ValueNoise1D(
+          RemapFunction<Result_Type> Remap_Func, TableLayout Layout>
+ValueNoise1D<Period, Engine, Result_Type, Remap_Func, Layout>::ValueNoise1D(
     const ValueNoise1D &other) = default;
 
 template <uint_least16_t Period, typename Engine, typename Result_Type,
-          RemapFunction<Result_Type> Remap_Func>
-ValueNoise1D<Period, Engine, Result_Type, Remap_Func> &
-ValueNoise1D<Period, Engine, Result_Type, Remap_Func>::
+          RemapFunction<Result_Type> Remap_Func, TableLayout Layout>
+ValueNoise1D<Period, Engine, Result_Type, Remap_Func, Layout> &
+ValueNoise1D<Period, Engine, Result_Type, Remap_Func, Layout>::
 operator=(const ValueNoise1D &other) = default;
 
 template <uint_least16_t Period, typename Engine, typename Result_Type,
-          RemapFunction<Result_Type> Remap_Func>
-ValueNoise1D<Period, Engine, Result_Type, Remap_Func>::ValueNoise1D(
+          RemapFunction<Result_Type> Remap_Func, TableLayout Layout>
+ValueNoise1D<Period, Engine, Result_Type, Remap_Func, Layout>::ValueNoise1D(
     ValueNoise1D &&other) noexcept = default;
 
 template <uint_least16_t Period, typename Engine, typename Result_Type,
-          RemapFunction<Result_Type> Remap_Func>
-ValueNoise1D<Period, Engine, Result_Type, Remap_Func> &
-ValueNoise1D<Period, Engine, Result_Type, Remap_Func>::
+          RemapFunction<Result_Type> Remap_Func, TableLayout Layout>
+ValueNoise1D<Period, Engine, Result_Type, Remap_Func, Layout> &
+ValueNoise1D<Period, Engine, Result_Type, Remap_Func, Layout>::
 operator=(ValueNoise1D &&other) noexcept = default;
 
 // ValueNoiseND
 
 template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
-          typename Result_Type, RemapFunction<Result_Type> Remap_Func>
-ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func>::ValueNoiseND(
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::ValueNoiseND(
     Seed_Type seed)
 {
-  Dist distribution{ValueNoise1D::low, ValueNoise1D::high};
-  Engine generator;
-
-  generator.seed(seed);
-  for (auto i = 0; i < kMaxVertices; ++i)
+  if constexpr (kHashed)
   {
-    r[i] = distribution(generator);
-    permutationTable[i] = i;
+    lattice = LatticeHash::draw<Engine>(seed);
   }
-
-  // shuffle values of the permutation table
-  std::uniform_int_distribution distrUInt{0, kMaxVerticesMask};
-  auto randUInt = std::bind(distrUInt, generator);
-  for (auto k = 0; k < kMaxVertices; ++k)
+  else
   {
-    auto i = randUInt();
-    std::swap(permutationTable[k], permutationTable[i]);
-    permutationTable[k + kMaxVertices] = permutationTable[k];
+    Dist distribution{ValueNoise1D_Type::low, ValueNoise1D_Type::high};
+    Engine generator;
+
+    generator.seed(seed);
+    for (auto i = 0; i < kMaxVertices; ++i)
+    {
+      r[i] = distribution(generator);
+      permutationTable.at(i) = i;
+    }
+
+    // shuffle values of the permutation table
+    std::uniform_int_distribution distrUInt{0, kMaxVerticesMask};
+    auto randUInt = std::bind(distrUInt, generator);
+    for (auto k = 0; k < kMaxVertices; ++k)
+    {
+      auto i = randUInt();
+      std::swap(permutationTable.at(k), permutationTable.at(i));
+      permutationTable.mirror(k);
+    }
   }
 }
 
-// Auto Generated destructor
 template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
-          typename Result_Type, RemapFunction<Result_Type> Remap_Func>
-ValueNoiseND<Dimension, Period, Engine, Result_Type,
-             Remap_Func>::~ValueNoiseND() = default;
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+constexpr ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+                       Layout>::ValueNoiseND(const StaticSeed seed)
+    : ValueNoise1D_Type(seed)
+{
+  if constexpr (!kHashed)
+  {
+    // The permutation comes after the values in the stream of the seed
+    utils::SplitMix64 generator{seed.value};
+    generator.discard(kMaxVertices);
+    drawPermutation(permutationTable, generator);
+  }
+}
 
 template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
-          typename Result_Type, RemapFunction<Result_Type> Remap_Func>
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
 Result_Type
-ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func>::eval(
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::eval(
     const Vec2_Type &p) const
 {
   constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
@@ -129,16 +216,18 @@ ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func>::eval(
   const Result_Type tx = p.x - static_cast<Result_Type>(xi);
   const Result_Type ty = p.y - static_cast<Result_Type>(yi);
 
-  const Conv_Type rx0 = xi & kMaxVerticesMask;
-  const Conv_Type rx1 = (rx0 + 1) & kMaxVerticesMask;
-  const Conv_Type ry0 = yi & kMaxVerticesMask;
-  const Conv_Type ry1 = (ry0 + 1) & kMaxVerticesMask;
+  const Conv_Type rx0 = xi & kLatticeMask;
+  const Conv_Type rx1 = (rx0 + 1) & kLatticeMask;
+  const Conv_Type ry0 = yi & kLatticeMask;
+  const Conv_Type ry1 = (ry0 + 1) & kLatticeMask;
 
-  // random values at the corners of the cell using permutation table
-  const auto &c00 = r[permutationTable[permutationTable[rx0] + ry0]];
-  const auto &c10 = r[permutationTable[permutationTable[rx1] + ry0]];
-  const auto &c01 = r[permutationTable[permutationTable[rx0] + ry1]];
-  const auto &c11 = r[permutationTable[permutationTable[rx1] + ry1]];
+  // random values at the corners of the cell
+  const Hash_Type hx0 = hashStart(rx0);
+  const Hash_Type hx1 = hashStart(rx1);
+  const Result_Type c00 = hashValue(hashExtend(hx0, 1, ry0));
+  const Result_Type c10 = hashValue(hashExtend(hx1, 1, ry0));
+  const Result_Type c01 = hashValue(hashExtend(hx0, 1, ry1));
+  const Result_Type c11 = hashValue(hashExtend(hx1, 1, ry1));
 
   // remapping of tx and ty using the Smoothstep function
   const Result_Type sx = (*Remap_Func)(tx);
@@ -154,10 +243,12 @@ ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func>::eval(
 }
 
 template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
-          typename Result_Type, RemapFunction<Result_Type> Remap_Func>
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
 template <uint_least8_t T>
 std::enable_if_t<3 <= T, Result_Type>
-ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func>::eval(
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::eval(
     const Vec3_Type &p) const
 {
   static_assert(Dimension >= 3, "Eval function for Vector3 requires a "
@@ -171,22 +262,29 @@ ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func>::eval(
   const Result_Type ty = p.y - static_cast<Result_Type>(yi);
   const Result_Type tz = p.z - static_cast<Result_Type>(zi);
 
-  const Conv_Type rx0 = xi & kMaxVerticesMask;
-  const Conv_Type rx1 = (rx0 + 1) & kMaxVerticesMask;
-  const Conv_Type ry0 = yi & kMaxVerticesMask;
-  const Conv_Type ry1 = (ry0 + 1) & kMaxVerticesMask;
-  const Conv_Type rz0 = zi & kMaxVerticesMask;
-  const Conv_Type rz1 = (rz0 + 1) & kMaxVerticesMask;
-
-  // random values at the corners of the cell using permutation table
-  const auto &c000 = r[permutationTable[permutationTable[permutationTable[rx0] + ry0] + rz0]];
-  const auto &c100 = r[permutationTable[permutationTable[permutationTable[rx1] + ry0] + rz0]];
-  const auto &c010 = r[permutationTable[permutationTable[permutationTable[rx0] + ry1] + rz0]];
-  const auto &c110 = r[permutationTable[permutationTable[permutationTable[rx1] + ry1] + rz0]];
-  const auto &c001 = r[permutationTable[permutationTable[permutationTable[rx0] + ry0] + rz1]];
-  const auto &c101 = r[permutationTable[permutationTable[permutationTable[rx1] + ry0] + rz1]];
-  const auto &c011 = r[permutationTable[permutationTable[permutationTable[rx0] + ry1] + rz1]];
-  const auto &c111 = r[permutationTable[permutationTable[permutationTable[rx1] + ry1] + rz1]];
+  const Conv_Type rx0 = xi & kLatticeMask;
+  const Conv_Type rx1 = (rx0 + 1) & kLatticeMask;
+  const Conv_Type ry0 = yi & kLatticeMask;
+  const Conv_Type ry1 = (ry0 + 1) & kLatticeMask;
+  const Conv_Type rz0 = zi & kLatticeMask;
+  const Conv_Type rz1 = (rz0 + 1) & kLatticeMask;
+
+  // random values at the corners of the cell
+  const Hash_Type hx0 = hashStart(rx0);
+  const Hash_Type hx1 = hashStart(rx1);
+  const Hash_Type h00 = hashExtend(hx0, 1, ry0);
+  const Hash_Type h10 = hashExtend(hx1, 1, ry0);
+  const Hash_Type h01 = hashExtend(hx0, 1, ry1);
+  const Hash_Type h11 = hashExtend(hx1, 1, ry1);
+
+  const Result_Type c000 = hashValue(hashExtend(h00, 2, rz0));
+  const Result_Type c100 = hashValue(hashExtend(h10, 2, rz0));
+  const Result_Type c010 = hashValue(hashExtend(h01, 2, rz0));
+  const Result_Type c110 = hashValue(hashExtend(h11, 2, rz0));
+  const Result_Type c001 = hashValue(hashExtend(h00, 2, rz1));
+  const Result_Type c101 = hashValue(hashExtend(h10, 2, rz1));
+  const Result_Type c011 = hashValue(hashExtend(h01, 2, rz1));
+  const Result_Type c111 = hashValue(hashExtend(h11, 2, rz1));
 
   // remapping of tx, ty and tz using the Smoothstep function
   const Result_Type sx = (*Remap_Func)(tx);
@@ -208,29 +306,528 @@ ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func>::eval(
   return lerp(ny10, ny11, sz);
 }
 
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+Result_Type
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::eval(
+    const Vec2_Type &p, Vec2_Type &deriv) const
+{
+  static_assert(kRemapDeriv != nullptr,
+                "The derivative of Remap_Func is unknown, see remapDeriv");
+  constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
+  const Conv_Type xi = fast_int_trunc(p.x);
+  const Conv_Type yi = fast_int_trunc(p.y);
+
+  const Result_Type tx = p.x - static_cast<Result_Type>(xi);
+  const Result_Type ty = p.y - static_cast<Result_Type>(yi);
+
+  const Conv_Type rx0 = xi & kLatticeMask;
+  const Conv_Type rx1 = (rx0 + 1) & kLatticeMask;
+  const Conv_Type ry0 = yi & kLatticeMask;
+  const Conv_Type ry1 = (ry0 + 1) & kLatticeMask;
+
+  // random values at the corners of the cell
+  const Hash_Type hx0 = hashStart(rx0);
+  const Hash_Type hx1 = hashStart(rx1);
+  const Result_Type c00 = hashValue(hashExtend(hx0, 1, ry0));
+  const Result_Type c10 = hashValue(hashExtend(hx1, 1, ry0));
+  const Result_Type c01 = hashValue(hashExtend(hx0, 1, ry1));
+  const Result_Type c11 = hashValue(hashExtend(hx1, 1, ry1));
+
+  const Result_Type sx = (*Remap_Func)(tx);
+  const Result_Type sy = (*Remap_Func)(ty);
+
+  constexpr auto lerp = utils::lerp<Result_Type>;
+  const Result_Type nx0 = lerp(c00, c10, sx);
+  const Result_Type nx1 = lerp(c01, c11, sx);
+
+  // Only the remap varies inside the cell, each partial derivative is the
+  // remap slope times the interpolated differences along its axis
+  deriv.x = (*kRemapDeriv)(tx) * lerp(c10 - c00, c11 - c01, sy);
+  deriv.y = (*kRemapDeriv)(ty) * (nx1 - nx0);
+
+  return lerp(nx0, nx1, sy);
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+template <uint_least8_t T>
+std::enable_if_t<3 <= T, Result_Type>
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::eval(
+    const Vec3_Type &p, Vec3_Type &deriv) const
+{
+  static_assert(kRemapDeriv != nullptr,
+                "The derivative of Remap_Func is unknown, see remapDeriv");
+  constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
+  const Conv_Type xi = fast_int_trunc(p.x);
+  const Conv_Type yi = fast_int_trunc(p.y);
+  const Conv_Type zi = fast_int_trunc(p.z);
+
+  const Result_Type tx = p.x - static_cast<Result_Type>(xi);
+  const Result_Type ty = p.y - static_cast<Result_Type>(yi);
+  const Result_Type tz = p.z - static_cast<Result_Type>(zi);
+
+  const Conv_Type rx0 = xi & kLatticeMask;
+  const Conv_Type rx1 = (rx0 + 1) & kLatticeMask;
+  const Conv_Type ry0 = yi & kLatticeMask;
+  const Conv_Type ry1 = (ry0 + 1) & kLatticeMask;
+  const Conv_Type rz0 = zi & kLatticeMask;
+  const Conv_Type rz1 = (rz0 + 1) & kLatticeMask;
+
+  // random values at the corners of the cell
+  const Hash_Type hx0 = hashStart(rx0);
+  const Hash_Type hx1 = hashStart(rx1);
+  const Hash_Type h00 = hashExtend(hx0, 1, ry0);
+  const Hash_Type h10 = hashExtend(hx1, 1, ry0);
+  const Hash_Type h01 = hashExtend(hx0, 1, ry1);
+  const Hash_Type h11 = hashExtend(hx1, 1, ry1);
+
+  const Result_Type c000 = hashValue(hashExtend(h00, 2, rz0));
+  const Result_Type c100 = hashValue(hashExtend(h10, 2, rz0));
+  const Result_Type c010 = hashValue(hashExtend(h01, 2, rz0));
+  const Result_Type c110 = hashValue(hashExtend(h11, 2, rz0));
+  const Result_Type c001 = hashValue(hashExtend(h00, 2, rz1));
+  const Result_Type c101 = hashValue(hashExtend(h10, 2, rz1));
+  const Result_Type c011 = hashValue(hashExtend(h01, 2, rz1));
+  const Result_Type c111 = hashValue(hashExtend(h11, 2, rz1));
+
+  const Result_Type sx = (*Remap_Func)(tx);
+  const Result_Type sy = (*Remap_Func)(ty);
+  const Result_Type sz = (*Remap_Func)(tz);
+
+  constexpr auto lerp = utils::lerp<Result_Type>;
+  const Result_Type nx00 = lerp(c000, c100, sx);
+  const Result_Type nx10 = lerp(c010, c110, sx);
+  const Result_Type nx01 = lerp(c001, c101, sx);
+  const Result_Type nx11 = lerp(c011, c111, sx);
+
+  const Result_Type ny10 = lerp(nx00, nx10, sy);
+  const Result_Type ny11 = lerp(nx01, nx11, sy);
+
+  // Remap slope times the differences along each axis, interpolated over
+  // the other axes
+  const Result_Type dx0 = lerp(c100 - c000, c110 - c010, sy);
+  const Result_Type dx1 = lerp(c101 - c001, c111 - c011, sy);
+  deriv.x = (*kRemapDeriv)(tx) * lerp(dx0, dx1, sz);
+  deriv.y = (*kRemapDeriv)(ty) * lerp(nx10 - nx00, nx11 - nx01, sz);
+  deriv.z = (*kRemapDeriv)(tz) * (ny11 - ny10);
+
+  return lerp(ny10, ny11, sz);
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+template <uint_least8_t T>
+std::enable_if_t<4 <= T, Result_Type>
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::eval(
+    const Vec4_Type &p) const
+{
+  static_assert(Dimension >= 4, "Eval function for Vector4 requires a "
+                                "ValueNoiseND with 4 or more dimensions");
+  const Result_Type q[4] = {p.x, p.y, p.z, p.w};
+  Conv_Type rc[4][2];
+  Result_Type s[4];
+  cellOf(q, rc, s);
+  return evalCell(rc, s);
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+template <uint_least8_t T>
+std::enable_if_t<5 <= T, Result_Type>
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::eval(
+    const Vec5_Type &p) const
+{
+  static_assert(Dimension >= 5, "Eval function for Vector5 requires a "
+                                "ValueNoiseND with 5 dimensions");
+  const Result_Type q[5] = {p.x, p.y, p.z, p.w, p.v};
+  Conv_Type rc[5][2];
+  Result_Type s[5];
+  cellOf(q, rc, s);
+  return evalCell(rc, s);
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+template <std::size_t N>
+inline void
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::cellOf(
+    const Result_Type (&p)[N], Conv_Type (&rc)[N][2], Result_Type (&s)[N])
+{
+  constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
+  for (std::size_t a = 0; a < N; ++a)
+  {
+    const Conv_Type i = fast_int_trunc(p[a]);
+    rc[a][0] = i & kLatticeMask;
+    rc[a][1] = (rc[a][0] + 1) & kLatticeMask;
+    s[a] = (*Remap_Func)(p[a] - static_cast<Result_Type>(i));
+  }
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+template <std::size_t N>
+Result_Type
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::evalCell(
+    const Conv_Type (&rc)[N][2], const Result_Type (&s)[N]) const
+{
+  const std::array<Hash_Type, 2> hx{{hashStart(rc[0][0]), hashStart(rc[0][1])}};
+  const auto h = cornerHashes<1>(hx, rc);
+
+  // random values at the corners of the cell
+  const auto c = cornerValues(h, std::make_index_sequence<h.size()>{});
+
+  // linearly interpolate along x, then y...
+  return interpolate<0>(c, s);
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+template <std::size_t... K>
+inline std::array<typename ValueNoiseND<Dimension, Period, Engine, Result_Type,
+                                        Remap_Func, Layout>::Hash_Type,
+                  2 * sizeof...(K)>
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::extendHashes(
+    const std::array<Hash_Type, sizeof...(K)> &h, const std::size_t axis,
+    const Conv_Type (&rc)[2], std::index_sequence<K...>) const
+{
+  return {{hashExtend(h[K], axis, rc[0])..., hashExtend(h[K], axis, rc[1])...}};
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+template <std::size_t... K>
+inline std::array<Result_Type, sizeof...(K)>
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::cornerValues(
+    const std::array<Hash_Type, sizeof...(K)> &h,
+    std::index_sequence<K...>) const
+{
+  return {{hashValue(h[K])...}};
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+template <std::size_t... M>
+inline std::array<Result_Type, sizeof...(M)>
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::lerpPairs(
+    const std::array<Result_Type, 2 * sizeof...(M)> &c, const Result_Type s,
+    std::index_sequence<M...>)
+{
+  constexpr auto lerp = utils::lerp<Result_Type>;
+  return {{lerp(c[2 * M], c[2 * M + 1], s)...}};
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+template <std::size_t A, std::size_t N, std::size_t C>
+inline auto
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::cornerHashes(
+    const std::array<Hash_Type, C> &h, const Conv_Type (&rc)[N][2]) const
+{
+  if constexpr (A == N)
+  {
+    return h;
+  }
+  else
+  {
+    return cornerHashes<A + 1>(
+        extendHashes(h, A, rc[A], std::make_index_sequence<C>{}), rc);
+  }
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+template <std::size_t A, std::size_t N, std::size_t C>
+inline Result_Type
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::interpolate(
+    const std::array<Result_Type, C> &c, const Result_Type (&s)[N])
+{
+  if constexpr (C == 1)
+  {
+    return c[0];
+  }
+  else
+  {
+    return interpolate<A + 1>(
+        lerpPairs(c, s[A], std::make_index_sequence<C / 2>{}), s);
+  }
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+void ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+                  Layout>::evalGrid(
+    const Vec2_Type &origin, const Result_Type step, const std::size_t width,
+    const std::size_t height, Result_Type *out, const std::size_t stride,
+    const std::size_t column, const std::size_t row) const
+{
+  constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
+  constexpr auto lerp = utils::lerp<Result_Type>;
+
+  for (std::size_t j = 0; j < height; ++j)
+  {
+    // Everything that only depends on y is computed once per row
+    const Result_Type y = origin.y + static_cast<Result_Type>(row + j) * step;
+    const Conv_Type yi = fast_int_trunc(y);
+    const Result_Type ty = y - static_cast<Result_Type>(yi);
+    const Conv_Type ry0 = yi & kLatticeMask;
+    const Conv_Type ry1 = (ry0 + 1) & kLatticeMask;
+    const Result_Type sy = (*Remap_Func)(ty);
+
+    Result_Type *dst = out + j * stride;
+
+    // Corner values of the current cell, refreshed when x crosses a cell
+    Result_Type c00{0}, c10{0}, c01{0}, c11{0};
+    Conv_Type cellX{0};
+    bool hasCell = false;
+
+    for (std::size_t i = 0; i < width; ++i)
+    {
+      const Result_Type x =
+          origin.x + static_cast<Result_Type>(column + i) * step;
+      const Conv_Type xi = fast_int_trunc(x);
+
+      if (!hasCell || xi != cellX)
+      {
+        const Conv_Type rx0 = xi & kLatticeMask;
+        const Conv_Type rx1 = (rx0 + 1) & kLatticeMask;
+
+        const Hash_Type hx0 = hashStart(rx0);
+        const Hash_Type hx1 = hashStart(rx1);
+        c00 = hashValue(hashExtend(hx0, 1, ry0));
+        c10 = hashValue(hashExtend(hx1, 1, ry0));
+        c01 = hashValue(hashExtend(hx0, 1, ry1));
+        c11 = hashValue(hashExtend(hx1, 1, ry1));
+
+        cellX = xi;
+        hasCell = true;
+      }
+
+      const Result_Type tx = x - static_cast<Result_Type>(xi);
+      const Result_Type sx = (*Remap_Func)(tx);
+
+      const Result_Type nx0 = lerp(c00, c10, sx);
+      const Result_Type nx1 = lerp(c01, c11, sx);
+
+      dst[i] = lerp(nx0, nx1, sy);
+    }
+  }
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+template <uint_least8_t T>
+std::enable_if_t<3 <= T>
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::evalGrid(
+    const Vec3_Type &origin, const Result_Type step, const std::size_t width,
+    const std::size_t height, Result_Type *out, const std::size_t stride,
+    const std::size_t column, const std::size_t row) const
+{
+  static_assert(Dimension >= 3, "evalGrid function for Vector3 requires a "
+                                "ValueNoiseND with 3 or more dimensions");
+  constexpr auto fast_int_trunc = utils::fast_int_trunc<Result_Type, Conv_Type>;
+  constexpr auto lerp = utils::lerp<Result_Type>;
+
+  // The slice has a constant z
+  const Conv_Type zi = fast_int_trunc(origin.z);
+  const Result_Type tz = origin.z - static_cast<Result_Type>(zi);
+  const Conv_Type rz0 = zi & kLatticeMask;
+  const Conv_Type rz1 = (rz0 + 1) & kLatticeMask;
+  const Result_Type sz = (*Remap_Func)(tz);
+
+  for (std::size_t j = 0; j < height; ++j)
+  {
+    const Result_Type y = origin.y + static_cast<Result_Type>(row + j) * step;
+    const Conv_Type yi = fast_int_trunc(y);
+    const Result_Type ty = y - static_cast<Result_Type>(yi);
+    const Conv_Type ry0 = yi & kLatticeMask;
+    const Conv_Type ry1 = (ry0 + 1) & kLatticeMask;
+    const Result_Type sy = (*Remap_Func)(ty);
+
+    Result_Type *dst = out + j * stride;
+
+    Result_Type c000{0}, c100{0}, c010{0}, c110{0};
+    Result_Type c001{0}, c101{0}, c011{0}, c111{0};
+    Conv_Type cellX{0};
+    bool hasCell = false;
+
+    for (std::size_t i = 0; i < width; ++i)
+    {
+      const Result_Type x =
+          origin.x + static_cast<Result_Type>(column + i) * step;
+      const Conv_Type xi = fast_int_trunc(x);
+
+      if (!hasCell || xi != cellX)
+      {
+        const Conv_Type rx0 = xi & kLatticeMask;
+        const Conv_Type rx1 = (rx0 + 1) & kLatticeMask;
+
+        const Hash_Type hx0 = hashStart(rx0);
+        const Hash_Type hx1 = hashStart(rx1);
+        const Hash_Type h00 = hashExtend(hx0, 1, ry0);
+        const Hash_Type h10 = hashExtend(hx1, 1, ry0);
+        const Hash_Type h01 = hashExtend(hx0, 1, ry1);
+        const Hash_Type h11 = hashExtend(hx1, 1, ry1);
+
+        c000 = hashValue(hashExtend(h00, 2, rz0));
+        c100 = hashValue(hashExtend(h10, 2, rz0));
+        c010 = hashValue(hashExtend(h01, 2, rz0));
+        c110 = hashValue(hashExtend(h11, 2, rz0));
+        c001 = hashValue(hashExtend(h00, 2, rz1));
+        c101 = hashValue(hashExtend(h10, 2, rz1));
+        c011 = hashValue(hashExtend(h01, 2, rz1));
+        c111 = hashValue(hashExtend(h11, 2, rz1));
+
+        cellX = xi;
+        hasCell = true;
+      }
+
+      const Result_Type tx = x - static_cast<Result_Type>(xi);
+      const Result_Type sx = (*Remap_Func)(tx);
+
+      const Result_Type nx00 = lerp(c000, c100, sx);
+      const Result_Type nx10 = lerp(c010, c110, sx);
+      const Result_Type nx01 = lerp(c001, c101, sx);
+      const Result_Type nx11 = lerp(c011, c111, sx);
+
+      const Result_Type ny10 = lerp(nx00, nx10, sy);
+      const Result_Type ny11 = lerp(nx01, nx11, sy);
+
+      dst[i] = lerp(ny10, ny11, sz);
+    }
+  }
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+void ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+                  Layout>::
+    evalBatch(const Result_Type *x, const Result_Type *y,
+              const std::size_t count, Result_Type *out) const
+{
+  if constexpr (kHasKernels)
+  {
+    const bool done = simd::dispatch([&](auto kernels) {
+      if constexpr (kHashed)
+      {
+        kernels.template valueNoise2DHashed<kKernelRemap>(lattice, x, y,
+                                                          count, out);
+      }
+      else
+      {
+        kernels.template valueNoise2D<kKernelRemap>(
+            permutationTable.data(), r.data(), kMaxVerticesMask, x, y, count,
+            out);
+      }
+    });
+    if (done)
+    {
+      return;
+    }
+  }
+
+  for (std::size_t k = 0; k < count; ++k)
+  {
+    out[k] = eval(Vec2_Type(x[k], y[k]));
+  }
+}
+
+template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+template <uint_least8_t T>
+std::enable_if_t<3 <= T>
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::evalBatch(
+    const Result_Type *x, const Result_Type *y, const Result_Type *z,
+    const std::size_t count, Result_Type *out) const
+{
+  static_assert(Dimension >= 3, "evalBatch function for Vector3 requires a "
+                                "ValueNoiseND with 3 or more dimensions");
+  if constexpr (kHasKernels)
+  {
+    const bool done = simd::dispatch([&](auto kernels) {
+      if constexpr (kHashed)
+      {
+        kernels.template valueNoise3DHashed<kKernelRemap>(lattice, x, y, z,
+                                                          count, out);
+      }
+      else
+      {
+        kernels.template valueNoise3D<kKernelRemap>(
+            permutationTable.data(), r.data(), kMaxVerticesMask, x, y, z,
+            count, out);
+      }
+    });
+    if (done)
+    {
+      return;
+    }
+  }
+
+  for (std::size_t k = 0; k < count; ++k)
+  {
+    out[k] = eval(Vec3_Type(x[k], y[k], z[k]));
+  }
+}
+
 // Copy and Move auto generated members
 
 template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
-          typename Result_Type, RemapFunction<Result_Type> Remap_Func>
-ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func>::ValueNoiseND(
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::ValueNoiseND(
     const ValueNoiseND &other) = default;
 
 template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
-          typename Result_Type, RemapFunction<Result_Type> Remap_Func>
-ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func> &
-ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func>::
-operator=(const ValueNoiseND &other) = default;
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout> &
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::operator=(const ValueNoiseND &other) = default;
 
 template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
-          typename Result_Type, RemapFunction<Result_Type> Remap_Func>
-ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func>::ValueNoiseND(
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::ValueNoiseND(
     ValueNoiseND &&other) noexcept = default;
 
 template <uint_least8_t Dimension, uint_least16_t Period, typename Engine,
-          typename Result_Type, RemapFunction<Result_Type> Remap_Func>
-ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func> &
-ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func>::
-operator=(ValueNoiseND &&other) noexcept = default;
+          typename Result_Type, RemapFunction<Result_Type> Remap_Func,
+          TableLayout Layout>
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout> &
+ValueNoiseND<Dimension, Period, Engine, Result_Type, Remap_Func,
+             Layout>::operator=(ValueNoiseND &&other) noexcept = default;
 
 } // namespace noise
 
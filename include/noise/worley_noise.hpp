@@ -0,0 +1,169 @@
+#ifndef WORLEY_NOISE_H
+#define WORLEY_NOISE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+
+#include "noise/cellular_metric.hpp"
+#include "noise/lattice_tables.hpp"
+#include "noise/simd/kernel_cellular.hpp"
+#include "vec/vec2.hpp"
+#include "vec/vec3.hpp"
+
+namespace noise {
+
+// Cellular noise: the distances from p to the feature points scattered one
+// per lattice cell, F1 to the nearest and F2 to the second nearest, of the
+// Metric policy. Output selects F1, F2 or F2 - F1, which is 0 on the
+// borders between the cells of two points (CellularOutput).
+//
+// The points are drawn from the Engine seeded with seed and looked up with
+// the permutation table of ValueNoiseND (same draws, same shuffle), with
+// the lattice wrapping every Period cells. Each point lies within jitter
+// (in [0, 1]) times its cell around the center, its offsets quantized to
+// 16 bits per axis in 2D, 10 in 3D, so the point of a cell is one int32.
+//
+// The search covers the 3^Dimension cells around p, nearest first, and
+// skips those whose closest point is already farther than the distance
+// they could replace. With a jitter of 1, a point two cells away may be
+// nearer than the ones searched, which shows as rare steps of F2 (and
+// rarer ones of F1) on the cell borders; a smaller jitter makes them rarer.
+template <uint_least8_t Dimension, typename Metric = EuclideanMetric,
+          CellularOutput Output = CellularOutput::F1,
+          uint_least16_t Period = 256,
+          typename Engine = std::default_random_engine,
+          typename Result_Type = float>
+class WorleyNoiseND {
+public:
+  static_assert(Dimension == 2 || Dimension == 3, "Dimension must be 2 or 3");
+  static_assert(std::is_floating_point<Result_Type>(),
+                "Result_Type must be a floating point type");
+
+  using Dist = typename std::uniform_real_distribution<Result_Type>;
+  using Seed_Type = typename Dist::result_type;
+  using Value_Type = Result_Type;
+
+  // Distances are positive
+  static constexpr bool kSignedOutput = false;
+
+  // Period of the lattice along every axis, see noise/large_world.hpp
+  static constexpr std::size_t kPeriod = Period;
+
+  using Vec2_Type = typename vector::Vec2<Result_Type>;
+  using Vec3_Type = typename vector::Vec3<Result_Type>;
+
+  WorleyNoiseND(Seed_Type seed = 2011, const Result_Type jitter = 1);
+
+  template <uint_least8_t T = Dimension>
+  std::enable_if_t<T == 2, Result_Type> eval(const Vec2_Type &p) const;
+
+  template <uint_least8_t T = Dimension>
+  std::enable_if_t<T == 3, Result_Type> eval(const Vec3_Type &p) const;
+
+  // Fill a width x height raster with the samples at origin + (i, j) * step.
+  // Rows are stride elements apart in out, whose first sample is (column,
+  // row) of the raster, so it can be filled tile by tile. The coordinates
+  // of each row go through evalBatch, chunk by chunk on the stack
+  template <uint_least8_t T = Dimension>
+  std::enable_if_t<T == 2> evalGrid(const Vec2_Type &origin,
+                                    const Result_Type step,
+                                    const std::size_t width,
+                                    const std::size_t height, Result_Type *out,
+                                    const std::size_t stride,
+                                    const std::size_t column = 0,
+                                    const std::size_t row = 0) const;
+
+  // Same as above for the z = origin.z slice of the 3D noise
+  template <uint_least8_t T = Dimension>
+  std::enable_if_t<T == 3> evalGrid(const Vec3_Type &origin,
+                                    const Result_Type step,
+                                    const std::size_t width,
+                                    const std::size_t height, Result_Type *out,
+                                    const std::size_t stride,
+                                    const std::size_t column = 0,
+                                    const std::size_t row = 0) const;
+
+  // Evaluate the count samples (x[k], y[k]...) into out[k]. Float noise
+  // with a metric of the kernels runs the widest vector kernel the CPU
+  // supports (noise::simd::dispatch), which matches eval bit for bit
+  template <uint_least8_t T = Dimension>
+  std::enable_if_t<T == 2> evalBatch(const Result_Type *x,
+                                     const Result_Type *y,
+                                     const std::size_t count,
+                                     Result_Type *out) const;
+
+  template <uint_least8_t T = Dimension>
+  std::enable_if_t<T == 3> evalBatch(const Result_Type *x,
+                                     const Result_Type *y,
+                                     const Result_Type *z,
+                                     const std::size_t count,
+                                     Result_Type *out) const;
+
+private:
+  static_assert(Period > 1 && !(Period & (Period - 1)),
+                "Period must be power of 2 different from 0");
+  static constexpr auto kTableSize{Period};
+  static constexpr std::int32_t kTableSizeMask{Period - 1};
+
+  // Bits of a feature point offset along each axis, and their scale
+  static constexpr unsigned kBits = Dimension == 2 ? 16 : 10;
+  static constexpr std::uint32_t kBitsMask = (std::uint32_t{1} << kBits) - 1;
+  static constexpr Result_Type kBitsScale =
+      Result_Type(1) / static_cast<Result_Type>(std::uint32_t{1} << kBits);
+
+  template <typename M, typename = void>
+  struct HasKernelMetric : std::false_type {};
+  template <typename M>
+  struct HasKernelMetric<M, std::void_t<decltype(M::kKernel)>>
+      : std::true_type {};
+
+  static constexpr bool kHasKernels =
+      std::is_same_v<Result_Type, float> && HasKernelMetric<Metric>::value;
+
+  // Samples per chunk of evalGrid, the coordinates live on the stack
+  static constexpr std::size_t kGridChunk = 256;
+
+  // F1, F2 or the edge distance of the coordinates p
+  Result_Type search(const Result_Type (&p)[Dimension]) const;
+
+  void evalGridRows(const Result_Type (&origin)[Dimension],
+                    const Result_Type step, const std::size_t width,
+                    const std::size_t height, Result_Type *out,
+                    const std::size_t stride, const std::size_t column,
+                    const std::size_t row) const;
+
+  void evalBatchN(const Result_Type *const (&p)[Dimension],
+                  const std::size_t count, Result_Type *out) const;
+
+  // Packed feature points by hash prefix plus the last coordinate, i.e.
+  // already through the last permutation, as int32 for the gathers of the
+  // kernels. The offset along the first axis is in the highest bits
+  std::array<std::int32_t, 2 * kTableSize> features{};
+  PermutationTable<kTableSize, std::int32_t, TableLayout::Wide>
+      permutationTable{};
+};
+
+template <typename Metric = EuclideanMetric,
+          CellularOutput Output = CellularOutput::F1,
+          uint_least16_t Period = 256,
+          typename Engine = std::default_random_engine,
+          typename Result_Type = float>
+using WorleyNoise2D =
+    WorleyNoiseND<2, Metric, Output, Period, Engine, Result_Type>;
+
+template <typename Metric = EuclideanMetric,
+          CellularOutput Output = CellularOutput::F1,
+          uint_least16_t Period = 256,
+          typename Engine = std::default_random_engine,
+          typename Result_Type = float>
+using WorleyNoise3D =
+    WorleyNoiseND<3, Metric, Output, Period, Engine, Result_Type>;
+
+} // namespace noise
+
+#include "noise/worley_noise_impl.hpp"
+
+#endif // !WORLEY_NOISE_H
@@ -0,0 +1,272 @@
+#ifndef WORLEY_NOISE_IMPL_H
+#define WORLEY_NOISE_IMPL_H
+
+#include "noise/worley_noise.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <utility>
+
+#include "noise/simd/noise_kernels.hpp"
+#include "utils/fast_convertion.hpp"
+
+namespace noise {
+
+template <uint_least8_t Dimension, typename Metric, CellularOutput Output,
+          uint_least16_t Period, typename Engine, typename Result_Type>
+WorleyNoiseND<Dimension, Metric, Output, Period, Engine,
+              Result_Type>::WorleyNoiseND(Seed_Type seed,
+                                          const Result_Type jitter) {
+  assert(jitter >= 0 && jitter <= 1 && "The jitter must be in [0, 1]");
+  Dist distribution{0, 1};
+  Engine generator;
+  std::array<std::uint32_t, kTableSize> points;
+
+  // One point per cell, its offsets around the center of the cell
+  // quantized and packed, the first axis in the highest bits
+  generator.seed(seed);
+  for (auto i = 0; i < kTableSize; ++i) {
+    std::uint32_t packed = 0;
+    for (std::size_t a = 0; a < Dimension; ++a) {
+      const Result_Type half{0.5};
+      const Result_Type v = half + jitter * (distribution(generator) - half);
+      const auto q = static_cast<std::uint32_t>(
+          v * static_cast<Result_Type>(kBitsMask + 1));
+      packed = packed << kBits | std::min(q, kBitsMask);
+    }
+    points[i] = packed;
+    permutationTable.at(i) = i;
+  }
+
+  // shuffle values of the permutation table
+  std::uniform_int_distribution distrUInt{0, kTableSizeMask};
+  auto randUInt = std::bind(distrUInt, generator);
+  for (auto k = 0; k < kTableSize; ++k) {
+    auto i = randUInt();
+    std::swap(permutationTable.at(k), permutationTable.at(i));
+    permutationTable.mirror(k);
+  }
+
+  for (auto i = 0; i < 2 * kTableSize; ++i) {
+    features[i] = static_cast<std::int32_t>(points[permutationTable[i]]);
+  }
+}
+
+template <uint_least8_t Dimension, typename Metric, CellularOutput Output,
+          uint_least16_t Period, typename Engine, typename Result_Type>
+template <uint_least8_t T>
+std::enable_if_t<T == 2, Result_Type>
+WorleyNoiseND<Dimension, Metric, Output, Period, Engine, Result_Type>::eval(
+    const Vec2_Type &p) const {
+  const Result_Type c[Dimension] = {p.x, p.y};
+  return search(c);
+}
+
+template <uint_least8_t Dimension, typename Metric, CellularOutput Output,
+          uint_least16_t Period, typename Engine, typename Result_Type>
+template <uint_least8_t T>
+std::enable_if_t<T == 3, Result_Type>
+WorleyNoiseND<Dimension, Metric, Output, Period, Engine, Result_Type>::eval(
+    const Vec3_Type &p) const {
+  const Result_Type c[Dimension] = {p.x, p.y, p.z};
+  return search(c);
+}
+
+template <uint_least8_t Dimension, typename Metric, CellularOutput Output,
+          uint_least16_t Period, typename Engine, typename Result_Type>
+Result_Type
+WorleyNoiseND<Dimension, Metric, Output, Period, Engine, Result_Type>::search(
+    const Result_Type (&p)[Dimension]) const {
+  constexpr auto fast_int_trunc =
+      utils::fast_int_trunc<Result_Type, std::int32_t>;
+
+  // Wrapped lattice coordinates of the neighbors along each axis
+  Result_Type t[Dimension];
+  std::int32_t r[Dimension][3];
+  for (std::size_t a = 0; a < Dimension; ++a) {
+    const std::int32_t pos = fast_int_trunc(p[a]);
+    t[a] = p[a] - static_cast<Result_Type>(pos);
+    for (int o = 0; o < 3; ++o) {
+      r[a][o] = (pos + o - 1) & kTableSizeMask;
+    }
+  }
+
+  // Hash prefixes of the columns of cells, over every axis but the last
+  std::int32_t h[9];
+  for (int i = 0; i < 3; ++i) {
+    const std::int32_t hx = permutationTable[r[0][i]];
+    if constexpr (Dimension == 2) {
+      h[i] = hx;
+    } else {
+      for (int j = 0; j < 3; ++j) {
+        h[i + 3 * j] = permutationTable[hx + r[1][j]];
+      }
+    }
+  }
+
+  // The cells by rings, the one of p and then the ones differing on 1, 2...
+  // axes. A cell is skipped when the distance to its closest point does not
+  // beat the distance it could replace, which leaves the result unchanged
+  Result_Type f1 = std::numeric_limits<Result_Type>::infinity();
+  Result_Type f2 = f1;
+  simd::forEachNeighbor<Dimension>([&](auto cell) {
+    constexpr std::array<int, Dimension> o =
+        simd::neighborRings<Dimension>()[cell];
+
+    if constexpr (cell != 0) {
+      Result_Type b[Dimension];
+      for (std::size_t a = 0; a < Dimension; ++a) {
+        b[a] = o[a] < 0 ? t[a] : (o[a] > 0 ? 1 - t[a] : 0);
+      }
+      const Result_Type limit = Output == CellularOutput::F1 ? f1 : f2;
+      if (!(Metric::measure(b) < limit)) {
+        return;
+      }
+    }
+
+    constexpr int prefix =
+        Dimension == 2 ? o[0] + 1 : o[0] + 1 + 3 * (o[1] + 1);
+    const auto packed = static_cast<std::uint32_t>(
+        features[h[prefix] + r[Dimension - 1][o[Dimension - 1] + 1]]);
+
+    // Difference between p and the point, relative to the cell of p
+    Result_Type d[Dimension];
+    for (std::size_t a = 0; a < Dimension; ++a) {
+      const unsigned shift = kBits * (Dimension - 1 - a);
+      const Result_Type f =
+          static_cast<Result_Type>((packed >> shift) & kBitsMask) * kBitsScale;
+      d[a] = t[a] - (static_cast<Result_Type>(o[a]) + f);
+    }
+
+    const Result_Type s = Metric::measure(d);
+    if constexpr (Output != CellularOutput::F1) {
+      f2 = s < f1 ? f1 : (s < f2 ? s : f2);
+    }
+    f1 = s < f1 ? s : f1;
+  });
+
+  if constexpr (Output == CellularOutput::F1) {
+    return Metric::finish(f1);
+  } else if constexpr (Output == CellularOutput::F2) {
+    return Metric::finish(f2);
+  } else {
+    return Metric::finish(f2) - Metric::finish(f1);
+  }
+}
+
+template <uint_least8_t Dimension, typename Metric, CellularOutput Output,
+          uint_least16_t Period, typename Engine, typename Result_Type>
+template <uint_least8_t T>
+std::enable_if_t<T == 2>
+WorleyNoiseND<Dimension, Metric, Output, Period, Engine, Result_Type>::evalGrid(
+    const Vec2_Type &origin, const Result_Type step, const std::size_t width,
+    const std::size_t height, Result_Type *out, const std::size_t stride,
+    const std::size_t column, const std::size_t row) const {
+  const Result_Type o[Dimension] = {origin.x, origin.y};
+  evalGridRows(o, step, width, height, out, stride, column, row);
+}
+
+template <uint_least8_t Dimension, typename Metric, CellularOutput Output,
+          uint_least16_t Period, typename Engine, typename Result_Type>
+template <uint_least8_t T>
+std::enable_if_t<T == 3>
+WorleyNoiseND<Dimension, Metric, Output, Period, Engine, Result_Type>::evalGrid(
+    const Vec3_Type &origin, const Result_Type step, const std::size_t width,
+    const std::size_t height, Result_Type *out, const std::size_t stride,
+    const std::size_t column, const std::size_t row) const {
+  const Result_Type o[Dimension] = {origin.x, origin.y, origin.z};
+  evalGridRows(o, step, width, height, out, stride, column, row);
+}
+
+template <uint_least8_t Dimension, typename Metric, CellularOutput Output,
+          uint_least16_t Period, typename Engine, typename Result_Type>
+void WorleyNoiseND<Dimension, Metric, Output, Period, Engine, Result_Type>::
+    evalGridRows(const Result_Type (&origin)[Dimension],
+                 const Result_Type step, const std::size_t width,
+                 const std::size_t height, Result_Type *out,
+                 const std::size_t stride, const std::size_t column,
+                 const std::size_t row) const {
+  // x varies along the row, y (and z) are the same for every sample
+  Result_Type coords[Dimension][kGridChunk];
+  const Result_Type *p[Dimension];
+  for (std::size_t a = 0; a < Dimension; ++a) {
+    p[a] = coords[a];
+  }
+  if constexpr (Dimension == 3) {
+    std::fill(coords[2], coords[2] + kGridChunk, origin[2]);
+  }
+
+  for (std::size_t j = 0; j < height; ++j) {
+    const Result_Type py =
+        origin[1] + static_cast<Result_Type>(row + j) * step;
+    std::fill(coords[1], coords[1] + kGridChunk, py);
+
+    for (std::size_t first = 0; first < width; first += kGridChunk) {
+      const std::size_t n = std::min(kGridChunk, width - first);
+      for (std::size_t i = 0; i < n; ++i) {
+        coords[0][i] =
+            origin[0] + static_cast<Result_Type>(column + first + i) * step;
+      }
+      evalBatchN(p, n, out + j * stride + first);
+    }
+  }
+}
+
+template <uint_least8_t Dimension, typename Metric, CellularOutput Output,
+          uint_least16_t Period, typename Engine, typename Result_Type>
+template <uint_least8_t T>
+std::enable_if_t<T == 2>
+WorleyNoiseND<Dimension, Metric, Output, Period, Engine, Result_Type>::
+    evalBatch(const Result_Type *x, const Result_Type *y,
+              const std::size_t count, Result_Type *out) const {
+  const Result_Type *const p[Dimension] = {x, y};
+  evalBatchN(p, count, out);
+}
+
+template <uint_least8_t Dimension, typename Metric, CellularOutput Output,
+          uint_least16_t Period, typename Engine, typename Result_Type>
+template <uint_least8_t T>
+std::enable_if_t<T == 3>
+WorleyNoiseND<Dimension, Metric, Output, Period, Engine, Result_Type>::
+    evalBatch(const Result_Type *x, const Result_Type *y, const Result_Type *z,
+              const std::size_t count, Result_Type *out) const {
+  const Result_Type *const p[Dimension] = {x, y, z};
+  evalBatchN(p, count, out);
+}
+
+template <uint_least8_t Dimension, typename Metric, CellularOutput Output,
+          uint_least16_t Period, typename Engine, typename Result_Type>
+void WorleyNoiseND<Dimension, Metric, Output, Period, Engine, Result_Type>::
+    evalBatchN(const Result_Type *const (&p)[Dimension],
+               const std::size_t count, Result_Type *out) const {
+  if constexpr (kHasKernels) {
+    const bool done = simd::dispatch([&](auto kernels) {
+      if constexpr (Dimension == 2) {
+        kernels.template worley2D<Metric::kKernel, Output>(
+            permutationTable.data(), features.data(), kTableSizeMask, p[0],
+            p[1], count, out);
+      } else {
+        kernels.template worley3D<Metric::kKernel, Output>(
+            permutationTable.data(), features.data(), kTableSizeMask, p[0],
+            p[1], p[2], count, out);
+      }
+    });
+    if (done) {
+      return;
+    }
+  }
+
+  for (std::size_t k = 0; k < count; ++k) {
+    Result_Type c[Dimension];
+    for (std::size_t a = 0; a < Dimension; ++a) {
+      c[a] = p[a][k];
+    }
+    out[k] = search(c);
+  }
+}
+
+} // namespace noise
+
+#endif // !WORLEY_NOISE_IMPL_H
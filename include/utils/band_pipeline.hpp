@@ -0,0 +1,242 @@
+#ifndef BAND_PIPELINE_H
+#define BAND_PIPELINE_H
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "utils/image_writer.hpp"
+
+namespace utils {
+
+// Producer / consumer pipeline between the threads generating images band
+// by band and a dedicated writer thread streaming the bands to disk. The
+// bands live in a bounded ring of reusable buffers: a producer takes a free
+// one with acquire, fills it and submits it with the function writing it,
+// and the writer thread runs the writes in submission order and hands the
+// buffers back. When every buffer is queued or being written, acquire waits
+// for the disk, so generation never runs more than bandCount() bands ahead
+// and memory stays bounded. Images queued one after the other overlap: the
+// next one is generated while the bands of the previous one are written
+class BandPipeline {
+public:
+  // bands buffers of bandBytes bytes each, aligned for any scalar type
+  explicit BandPipeline(const std::size_t bands = kDefaultBandCount,
+                        const std::size_t bandBytes = kDefaultBandBytes);
+
+  // Writes what is queued, then stops the writer thread
+  ~BandPipeline();
+
+  BandPipeline(const BandPipeline &other) = delete;
+  BandPipeline &operator=(const BandPipeline &other) = delete;
+
+  std::size_t bandBytes() const { return bytes; }
+  std::size_t bandCount() const { return storage.size(); }
+
+  // A free buffer, waiting for the writer thread to release one if needed
+  void *acquire();
+
+  // Give back band (from acquire) without writing it, e.g. when filling it
+  // failed
+  void release(void *band);
+
+  // Queue write(band) on the writer thread, after the bands submitted
+  // before. band (from acquire) is free again once write returns, and write
+  // is destroyed on the writer thread, along with what it captured. write
+  // returns false when the output failed
+  void submit(void *band, std::function<bool(const void *)> write);
+
+  // Wait until every band submitted is written. False if a write failed
+  // since the previous drain
+  bool drain();
+
+  static constexpr std::size_t kDefaultBandCount = 4;
+  // A band of 256 KB stays in L2 between its generation and its write
+  static constexpr std::size_t kDefaultBandBytes = 256 << 10;
+
+private:
+  struct Pending {
+    void *band;
+    std::function<bool(const void *)> write;
+  };
+
+  void writerLoop();
+
+  std::size_t bytes;
+  std::vector<std::unique_ptr<std::max_align_t[]>> storage;
+
+  std::mutex mutex;
+  std::condition_variable bandFree, bandReady, idle;
+  std::vector<void *> freeBands;
+  std::deque<Pending> pending;
+  bool writing = false;
+  bool failed = false;
+  bool stopping = false;
+
+  // Started last, once the state it reads is initialized
+  std::thread writer;
+};
+
+inline BandPipeline::BandPipeline(const std::size_t bands,
+                                  const std::size_t bandBytes)
+    : bytes(bandBytes) {
+  assert(bands >= 1 && bandBytes >= 1 && "The ring needs a buffer");
+  const std::size_t units =
+      (bandBytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+  for (std::size_t b = 0; b < bands; ++b) {
+    storage.push_back(std::make_unique<std::max_align_t[]>(units));
+    freeBands.push_back(storage.back().get());
+  }
+  writer = std::thread([this] { writerLoop(); });
+}
+
+inline BandPipeline::~BandPipeline() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  bandReady.notify_all();
+  writer.join();
+}
+
+inline void *BandPipeline::acquire() {
+  std::unique_lock<std::mutex> lock(mutex);
+  bandFree.wait(lock, [this] { return !freeBands.empty(); });
+  void *band = freeBands.back();
+  freeBands.pop_back();
+  return band;
+}
+
+inline void BandPipeline::release(void *band) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    freeBands.push_back(band);
+  }
+  bandFree.notify_one();
+}
+
+inline void BandPipeline::submit(void *band,
+                                 std::function<bool(const void *)> write) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.push_back(Pending{band, std::move(write)});
+  }
+  bandReady.notify_one();
+}
+
+inline bool BandPipeline::drain() {
+  std::unique_lock<std::mutex> lock(mutex);
+  idle.wait(lock, [this] { return pending.empty() && !writing; });
+  const bool ok = !failed;
+  failed = false;
+  return ok;
+}
+
+inline void BandPipeline::writerLoop() {
+  for (;;) {
+    Pending job;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      bandReady.wait(lock, [this] { return stopping || !pending.empty(); });
+      // Stops only once the queue is empty
+      if (pending.empty()) {
+        return;
+      }
+      job = std::move(pending.front());
+      pending.pop_front();
+      writing = true;
+    }
+
+    const bool ok = job.write(job.band);
+    // The captures (e.g. the last reference to a file) go away here, before
+    // the band is free again
+    job.write = nullptr;
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      failed = failed || !ok;
+      freeBands.push_back(job.band);
+      writing = false;
+    }
+    bandFree.notify_one();
+    idle.notify_all();
+  }
+}
+
+// Rows of Pixel per band of pipeline for images width pixels wide, rounded
+// down to a multiple of rowMultiple (e.g. the tile size) when there are more.
+// Throws std::length_error when a row does not fit in a band
+inline std::size_t bandRows(const BandPipeline &pipeline,
+                            const std::size_t width,
+                            const std::size_t pixelBytes,
+                            const std::size_t rowMultiple = 1) {
+  assert(width >= 1 && pixelBytes >= 1 && rowMultiple >= 1 &&
+         "A row must hold a pixel");
+  std::size_t rows = pipeline.bandBytes() / (width * pixelBytes);
+  if (rows == 0) {
+    throw std::length_error("utils::bandRows: a row is larger than a band");
+  }
+  if (rows > rowMultiple) {
+    rows -= rows % rowMultiple;
+  }
+  return rows;
+}
+
+// Image file produced band by band through pipeline. fill(row, rows, band)
+// writes the rows [row, row + rows) of the width x height image into band,
+// rows width pixels apart, on the calling thread (and typically a
+// ThreadPool), while the writer thread writes the previous bands. Pixel is
+// float, or a pixel ImageWriter::writeRow takes for format. Returns once the
+// last band is queued: the file is closed by the writer thread after its
+// last band, see BandPipeline::drain. Throws std::length_error, before
+// opening the file, when a row does not fit in a band (see bandRows). If
+// fill throws, its band goes back to the ring and the exception reaches the
+// caller: the bands queued before are still written, and the file is left
+// short of its height
+template <typename Pixel, typename Fill>
+void writeImageBands(BandPipeline &pipeline, const char *filename,
+                     const std::size_t width, const std::size_t height,
+                     const ImageFormat format, Fill fill,
+                     const std::size_t rowMultiple = 1) {
+  const std::size_t rows =
+      bandRows(pipeline, width, sizeof(Pixel), rowMultiple);
+  // Opened here, closed by the write of the last band
+  const auto file =
+      std::make_shared<ImageWriter>(filename, width, height, format);
+
+  for (std::size_t row = 0; row < height; row += rows) {
+    const std::size_t n = std::min(rows, height - row);
+    auto *band = static_cast<Pixel *>(pipeline.acquire());
+    try {
+      fill(row, n, band);
+    } catch (...) {
+      pipeline.release(band);
+      throw;
+    }
+
+    const bool last = row + n == height;
+    pipeline.submit(band, [file, width, n, last](const void *data) {
+      const auto *pixels = static_cast<const Pixel *>(data);
+      for (std::size_t j = 0; j < n; ++j) {
+        file->writeRow(pixels + j * width);
+      }
+      if (last) {
+        file->close();
+      }
+      return file->good();
+    });
+  }
+}
+
+} // namespace utils
+
+#endif // !BAND_PIPELINE_H
@@ -0,0 +1,80 @@
+#ifndef CONSTEXPR_RANDOM_H
+#define CONSTEXPR_RANDOM_H
+
+#include <cstdint>
+#include <limits>
+
+namespace utils {
+
+// SplitMix64 (Steele, Lea and Flood), a 64 bit generator whose every step
+// is usable in constant expressions. Unlike the standard engines and
+// distributions, its outputs are specified here bit for bit, so whatever it
+// draws is the same with every compiler and standard library. Also a
+// UniformRandomBitGenerator, for use with the standard algorithms
+class SplitMix64 {
+public:
+  using result_type = std::uint64_t;
+
+  explicit constexpr SplitMix64(const std::uint64_t seed = 0) : state(seed) {}
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  constexpr result_type operator()() {
+    state += kGamma;
+    std::uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+    return z ^ (z >> 31);
+  }
+
+  // Skip n outputs, in constant time
+  constexpr void discard(const std::uint64_t n) { state += n * kGamma; }
+
+  // Uniform in [0, 1), from the upper bits of an output: as many as T has
+  // mantissa digits, so every value is exact
+  template <typename T> constexpr T uniform() {
+    constexpr int kDigits = std::numeric_limits<T>::digits;
+    constexpr T kScale = T(1) / static_cast<T>(std::uint64_t{1} << kDigits);
+    return static_cast<T>((*this)() >> (64 - kDigits)) * kScale;
+  }
+
+  // Uniform in [0, n), n > 0, rejecting the outputs below 2^64 mod n that
+  // would bias the modulo
+  constexpr std::uint64_t below(const std::uint64_t n) {
+    const std::uint64_t threshold = (0 - n) % n;
+    for (;;) {
+      const std::uint64_t r = (*this)();
+      if (r >= threshold) {
+        return r % n;
+      }
+    }
+  }
+
+private:
+  static constexpr std::uint64_t kGamma = 0x9e3779b97f4a7c15u;
+
+  std::uint64_t state;
+};
+
+// Square root by Newton's iterations, for constant expressions. Starting
+// above the root, the iterates decrease until they stop changing
+constexpr double constexprSqrt(const double x) {
+  if (!(x > 0)) {
+    return 0;
+  }
+  double r = x > 1 ? x : 1;
+  for (;;) {
+    const double next = (r + x / r) / 2;
+    if (!(next < r)) {
+      return r;
+    }
+    r = next;
+  }
+}
+
+} // namespace utils
+
+#endif // !CONSTEXPR_RANDOM_H
@@ -0,0 +1,111 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#include <cstdint>
+
+#include "utils/simd_target.hpp"
+
+#if NOISE_SIMD_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace utils {
+
+// Vector instruction sets the batch kernels are built for, narrowest first
+enum class SimdLevel { Scalar, SSE42, AVX2, AVX512 };
+
+inline const char *simdLevelName(const SimdLevel level) {
+  switch (level) {
+  case SimdLevel::SSE42:
+    return "sse4.2";
+  case SimdLevel::AVX2:
+    return "avx2";
+  case SimdLevel::AVX512:
+    return "avx512";
+  default:
+    return "scalar";
+  }
+}
+
+#if NOISE_SIMD_X86
+namespace detail {
+
+inline void cpuid(const uint32_t leaf, const uint32_t subleaf,
+                  uint32_t regs[4]) {
+#if defined(_MSC_VER)
+  int r[4];
+  __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+  for (int i = 0; i < 4; ++i) {
+    regs[i] = static_cast<uint32_t>(r[i]);
+  }
+#else
+  __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// Register state the OS saves on context switches (XCR0)
+inline uint64_t xgetbv0() {
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  uint32_t eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+} // namespace detail
+#endif // NOISE_SIMD_X86
+
+// Widest SimdLevel supported by both the CPU (cpuid) and the OS (xgetbv)
+inline SimdLevel detectSimdLevel() {
+#if NOISE_SIMD_X86
+  uint32_t regs[4];
+
+  detail::cpuid(0, 0, regs);
+  const uint32_t maxLeaf = regs[0];
+
+  detail::cpuid(1, 0, regs);
+  const bool sse41 = regs[2] & (1u << 19);
+  const bool sse42 = regs[2] & (1u << 20);
+  const bool osxsave = regs[2] & (1u << 27);
+  const bool avx = regs[2] & (1u << 28);
+
+  if (!sse41 || !sse42) {
+    return SimdLevel::Scalar;
+  }
+
+  // The OS has to preserve the XMM and YMM registers for AVX
+  if (!osxsave || !avx || maxLeaf < 7) {
+    return SimdLevel::SSE42;
+  }
+  const uint64_t xcr0 = detail::xgetbv0();
+  if ((xcr0 & 0x6) != 0x6) {
+    return SimdLevel::SSE42;
+  }
+
+  detail::cpuid(7, 0, regs);
+  const bool avx2 = regs[1] & (1u << 5);
+  const bool avx512f = regs[1] & (1u << 16);
+
+  if (!avx2) {
+    return SimdLevel::SSE42;
+  }
+
+  // ... and the opmask and ZMM registers for AVX-512
+  if (avx512f && (xcr0 & 0xE6) == 0xE6) {
+    return SimdLevel::AVX512;
+  }
+  return SimdLevel::AVX2;
+#else
+  return SimdLevel::Scalar;
+#endif
+}
+
+} // namespace utils
+
+#endif // !CPU_FEATURES_H
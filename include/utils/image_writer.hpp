@@ -0,0 +1,272 @@
+#ifndef IMAGE_WRITER_H
+#define IMAGE_WRITER_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace utils {
+
+// File layouts ImageWriter can produce. Samples are expected in [0, 1] and
+// are clamped to it for the integer formats, NaN giving 0 as in
+// noise::QuantizeStage
+enum class ImageFormat {
+  PPM8,      // P6, the gray level repeated in 3 channels of 8 bits
+  PGM8,      // P5, 8 bits per sample
+  PGM16,     // P5 with maxval 65535, 16 bits big endian per sample
+  RawFloat32 // No header, 32 bits little endian floats, row after row
+};
+
+// Pixel of a PPM8 image, as in the file
+struct Rgb8 {
+  std::uint8_t r, g, b;
+};
+
+// Image file written row by row, as the rows are produced. Samples are
+// converted in bulk into a block buffer which is written whenever it is
+// full, so the stream sees a few large writes instead of one insertion per
+// byte, and the whole image never has to be in memory at once
+class ImageWriter {
+public:
+  // Opens filename and writes the header. bufferSize is in bytes
+  ImageWriter(const char *filename, const std::size_t width,
+              const std::size_t height, const ImageFormat format,
+              const std::size_t bufferSize = kDefaultBufferSize);
+
+  // Flushes the buffer and closes the file
+  ~ImageWriter();
+
+  ImageWriter(const ImageWriter &other) = delete;
+  ImageWriter &operator=(const ImageWriter &other) = delete;
+
+  // Append the width samples of the next row
+  void writeRow(const float *row);
+
+  // Append the width pixels of the next row, already quantized (see
+  // noise::QuantizeStage and noise::ColorizeStage): PGM8 takes uint8_t,
+  // PGM16 uint16_t and PPM8 Rgb8 pixels
+  void writeRow(const std::uint8_t *row);
+  void writeRow(const std::uint16_t *row);
+  void writeRow(const Rgb8 *row);
+
+  // Append count rows, stride elements apart in src
+  void writeRows(const float *src, const std::size_t count,
+                 const std::size_t stride);
+
+  // Write what is buffered to the file
+  void flush();
+
+  // Flush and close before the destructor does, to check good() afterwards.
+  // Closing before the height rows of the header are written fails
+  void close();
+
+  // False once opening or writing the file failed, a row past the height
+  // was given, or the file was closed short of its height
+  bool good() const { return static_cast<bool>(ofs); }
+
+  std::size_t rowsWritten() const { return rows; }
+
+  static constexpr std::size_t kDefaultBufferSize = 1 << 20;
+
+  static std::size_t bytesPerSample(const ImageFormat format);
+
+private:
+  // v clamped to [0, 1], NaN giving 0
+  static float clampUnit(float v) {
+    v = v > 0.0f ? v : 0.0f;
+    return v < 1.0f ? v : 1.0f;
+  }
+
+  void convert(const float *src, const std::size_t count, unsigned char *dst);
+
+  // Append a row, convert(first, n, dst) writing the bytes of its samples
+  // first to first + n at dst
+  template <typename Convert> void appendRow(Convert convert);
+
+  std::ofstream ofs;
+  std::size_t width, height;
+  ImageFormat format;
+  std::size_t rows = 0;
+
+  std::vector<unsigned char> buffer;
+  std::size_t used = 0;
+};
+
+// Write the width x height image at samples (rows width elements apart) in
+// one go
+inline bool writeImage(const char *filename, const std::size_t width,
+                       const std::size_t height, const float *samples,
+                       const ImageFormat format = ImageFormat::PGM8) {
+  ImageWriter writer(filename, width, height, format);
+  writer.writeRows(samples, height, width);
+  writer.close();
+  return writer.good();
+}
+
+inline std::size_t ImageWriter::bytesPerSample(const ImageFormat format) {
+  switch (format) {
+  case ImageFormat::PPM8:
+    return 3;
+  case ImageFormat::PGM8:
+    return 1;
+  case ImageFormat::PGM16:
+    return 2;
+  case ImageFormat::RawFloat32:
+    return 4;
+  }
+  return 1;
+}
+
+inline ImageWriter::ImageWriter(const char *filename, const std::size_t width,
+                                const std::size_t height,
+                                const ImageFormat format,
+                                const std::size_t bufferSize)
+    : ofs(filename, std::ios::out | std::ios::binary), width(width),
+      height(height), format(format) {
+  // A buffer holds at least one sample, so any row can be split in it
+  buffer.resize(std::max(bufferSize, bytesPerSample(format)));
+
+  std::string header;
+  switch (format) {
+  case ImageFormat::PPM8:
+    header = "P6\n";
+    break;
+  case ImageFormat::PGM8:
+  case ImageFormat::PGM16:
+    header = "P5\n";
+    break;
+  case ImageFormat::RawFloat32:
+    return;
+  }
+  header += std::to_string(width) + " " + std::to_string(height) + "\n";
+  header += format == ImageFormat::PGM16 ? "65535\n" : "255\n";
+  ofs.write(header.data(), static_cast<std::streamsize>(header.size()));
+}
+
+inline ImageWriter::~ImageWriter() { close(); }
+
+inline void ImageWriter::close() {
+  if (ofs.is_open()) {
+    flush();
+    if (rows != height) {
+      ofs.setstate(std::ios::failbit);
+    }
+    ofs.close();
+  }
+}
+
+inline void ImageWriter::flush() {
+  if (used != 0) {
+    ofs.write(reinterpret_cast<const char *>(buffer.data()),
+              static_cast<std::streamsize>(used));
+    used = 0;
+  }
+}
+
+inline void ImageWriter::convert(const float *src, const std::size_t count,
+                                 unsigned char *dst) {
+  switch (format) {
+  case ImageFormat::PPM8:
+    for (std::size_t k = 0; k < count; ++k) {
+      const float v = clampUnit(src[k]);
+      const unsigned char n = static_cast<unsigned char>(v * 255);
+      dst[3 * k] = n;
+      dst[3 * k + 1] = n;
+      dst[3 * k + 2] = n;
+    }
+    break;
+  case ImageFormat::PGM8:
+    for (std::size_t k = 0; k < count; ++k) {
+      const float v = clampUnit(src[k]);
+      dst[k] = static_cast<unsigned char>(v * 255);
+    }
+    break;
+  case ImageFormat::PGM16:
+    for (std::size_t k = 0; k < count; ++k) {
+      const float v = clampUnit(src[k]);
+      const std::uint16_t n = static_cast<std::uint16_t>(v * 65535);
+      dst[2 * k] = static_cast<unsigned char>(n >> 8);
+      dst[2 * k + 1] = static_cast<unsigned char>(n & 0xff);
+    }
+    break;
+  case ImageFormat::RawFloat32:
+    for (std::size_t k = 0; k < count; ++k) {
+      std::uint32_t bits;
+      std::memcpy(&bits, src + k, sizeof(bits));
+      dst[4 * k] = static_cast<unsigned char>(bits);
+      dst[4 * k + 1] = static_cast<unsigned char>(bits >> 8);
+      dst[4 * k + 2] = static_cast<unsigned char>(bits >> 16);
+      dst[4 * k + 3] = static_cast<unsigned char>(bits >> 24);
+    }
+    break;
+  }
+}
+
+template <typename Convert> void ImageWriter::appendRow(Convert convert) {
+  if (rows == height) {
+    // More rows than the header announced
+    ofs.setstate(std::ios::failbit);
+    return;
+  }
+  const std::size_t sampleSize = bytesPerSample(format);
+
+  // Convert the row straight into the buffer, in as many pieces as it takes
+  for (std::size_t first = 0; first < width;) {
+    if (buffer.size() - used < sampleSize) {
+      flush();
+    }
+    const std::size_t n =
+        std::min(width - first, (buffer.size() - used) / sampleSize);
+    convert(first, n, buffer.data() + used);
+    used += n * sampleSize;
+    first += n;
+  }
+  ++rows;
+}
+
+inline void ImageWriter::writeRow(const float *row) {
+  appendRow([&](const std::size_t first, const std::size_t n,
+                unsigned char *dst) { convert(row + first, n, dst); });
+}
+
+inline void ImageWriter::writeRow(const std::uint8_t *row) {
+  assert(format == ImageFormat::PGM8 && "uint8_t pixels are for PGM8");
+  appendRow([&](const std::size_t first, const std::size_t n,
+                unsigned char *dst) { std::memcpy(dst, row + first, n); });
+}
+
+inline void ImageWriter::writeRow(const std::uint16_t *row) {
+  assert(format == ImageFormat::PGM16 && "uint16_t pixels are for PGM16");
+  appendRow([&](const std::size_t first, const std::size_t n,
+                unsigned char *dst) {
+    for (std::size_t k = 0; k < n; ++k) {
+      dst[2 * k] = static_cast<unsigned char>(row[first + k] >> 8);
+      dst[2 * k + 1] = static_cast<unsigned char>(row[first + k] & 0xff);
+    }
+  });
+}
+
+inline void ImageWriter::writeRow(const Rgb8 *row) {
+  static_assert(sizeof(Rgb8) == 3, "Rgb8 must be the 3 bytes of a pixel");
+  assert(format == ImageFormat::PPM8 && "Rgb8 pixels are for PPM8");
+  appendRow([&](const std::size_t first, const std::size_t n,
+                unsigned char *dst) {
+    std::memcpy(dst, row + first, n * sizeof(Rgb8));
+  });
+}
+
+inline void ImageWriter::writeRows(const float *src, const std::size_t count,
+                                   const std::size_t stride) {
+  for (std::size_t j = 0; j < count; ++j) {
+    writeRow(src + j * stride);
+  }
+}
+
+} // namespace utils
+
+#endif // !IMAGE_WRITER_H
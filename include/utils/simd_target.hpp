@@ -0,0 +1,38 @@
+#ifndef SIMD_TARGET_H
+#define SIMD_TARGET_H
+
+// x86 vector kernels are only compiled on x86 targets
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||            \
+    defined(_M_IX86)
+#define NOISE_SIMD_X86 1
+#else
+#define NOISE_SIMD_X86 0
+#endif
+
+#define NOISE_SIMD_PRAGMA(x) _Pragma(#x)
+
+// Functions defined between NOISE_SIMD_TARGET_BEGIN(isa) and
+// NOISE_SIMD_TARGET_END are compiled for isa even if the rest of the
+// translation unit is not, so they must only be called after checking that
+// the CPU supports it. Multiply-add contraction is turned off in the region
+// so kernels round exactly like the scalar code they mirror (AVX-512 would
+// otherwise fuse them). MSVC accepts the intrinsics without target flags
+#if defined(__clang__)
+#define NOISE_SIMD_TARGET_BEGIN(isa)                                           \
+  NOISE_SIMD_PRAGMA(clang attribute push(__attribute__((target(isa))),        \
+                                         apply_to = function))                 \
+  NOISE_SIMD_PRAGMA(float_control(push))                                       \
+  NOISE_SIMD_PRAGMA(clang fp contract(off))
+#define NOISE_SIMD_TARGET_END                                                  \
+  NOISE_SIMD_PRAGMA(float_control(pop)) NOISE_SIMD_PRAGMA(clang attribute pop)
+#elif defined(__GNUC__)
+#define NOISE_SIMD_TARGET_BEGIN(isa)                                           \
+  NOISE_SIMD_PRAGMA(GCC push_options) NOISE_SIMD_PRAGMA(GCC target(isa))      \
+  NOISE_SIMD_PRAGMA(GCC optimize("fp-contract=off"))
+#define NOISE_SIMD_TARGET_END NOISE_SIMD_PRAGMA(GCC pop_options)
+#else
+#define NOISE_SIMD_TARGET_BEGIN(isa)
+#define NOISE_SIMD_TARGET_END
+#endif
+
+#endif // !SIMD_TARGET_H
@@ -0,0 +1,88 @@
+#ifndef STREAMING_STATS_H
+#define STREAMING_STATS_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+
+namespace utils {
+
+// Running min, max, mean and histogram of a stream of samples. The
+// histogram has Bins equal bins over [low, high], samples outside of it
+// land in the first or last bin. Partial statistics gathered on separate
+// parts of a raster are combined with merge.
+//
+// A NaN sample is counted in the first bin, where QuantizeStage puts it too,
+// and is left out of min and max, so those do not depend on the order of
+// the samples. It does make the mean NaN, which is how it shows up
+template <typename T = float, std::size_t Bins = 256> class StreamingStats {
+public:
+  static_assert(Bins >= 1, "The histogram needs at least one bin");
+
+  explicit StreamingStats(const T low = 0, const T high = 1)
+      : low(low), high(high), binScale(Bins / (high - low)) {}
+
+  void add(const T v) {
+    // Comparisons with NaN are false, so these keep the current bounds
+    least = v < least ? v : least;
+    greatest = v > greatest ? v : greatest;
+    sum += v;
+    ++samples;
+
+    // Clamped before the conversion, which NaN or a bin past the range of
+    // std::size_t would make undefined
+    const T bin = (v - low) * binScale;
+    std::size_t b = 0;
+    if (bin >= static_cast<T>(Bins)) {
+      b = Bins - 1;
+    } else if (bin > 0) {
+      b = static_cast<std::size_t>(bin);
+    }
+    ++bins[b];
+  }
+
+  void add(const T *values, const std::size_t count) {
+    for (std::size_t k = 0; k < count; ++k) {
+      add(values[k]);
+    }
+  }
+
+  // Statistics of both streams. Both must share their histogram range
+  void merge(const StreamingStats &other) {
+    least = std::min(least, other.least);
+    greatest = std::max(greatest, other.greatest);
+    sum += other.sum;
+    samples += other.samples;
+    for (std::size_t b = 0; b < Bins; ++b) {
+      bins[b] += other.bins[b];
+    }
+  }
+
+  // Forget the samples, keep the histogram range
+  void reset() { *this = StreamingStats(low, high); }
+
+  std::size_t count() const { return samples; }
+  T min() const { return least; }
+  T max() const { return greatest; }
+  double mean() const { return samples ? sum / samples : 0.0; }
+
+  const std::array<std::size_t, Bins> &histogram() const { return bins; }
+  T histogramLow() const { return low; }
+  T histogramHigh() const { return high; }
+
+private:
+  T low, high;
+  T binScale;
+
+  T least = std::numeric_limits<T>::max();
+  T greatest = std::numeric_limits<T>::lowest();
+  // Kept in double so the mean of a large raster does not drift
+  double sum = 0;
+  std::size_t samples = 0;
+  std::array<std::size_t, Bins> bins{};
+};
+
+} // namespace utils
+
+#endif // !STREAMING_STATS_H
@@ -0,0 +1,214 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils {
+
+// Fixed set of worker threads with one task deque each. A worker pops from
+// the back of its own deque and, when it runs dry, steals from the front of
+// the others, so uneven tasks still keep every thread busy
+class ThreadPool {
+public:
+  // workers extra threads are started, the thread waiting in parallelFor
+  // works too. ThreadPool(0) runs everything on the calling thread
+  explicit ThreadPool(const std::size_t workers = defaultWorkerCount());
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &other) = delete;
+  ThreadPool &operator=(const ThreadPool &other) = delete;
+
+  // Number of threads running tasks, counting the caller of parallelFor
+  std::size_t concurrency() const { return queues.size(); }
+
+  // Run task(i) for every i in [0, count) and wait for all of them. The
+  // indices are dealt to the deques in contiguous runs, so neighbouring
+  // tasks start on the same thread. If a task throws, the tasks not started
+  // yet are skipped and the first exception is rethrown once the running
+  // ones have finished
+  template <typename Task> void parallelFor(const std::size_t count, Task task);
+
+  static std::size_t defaultWorkerCount() {
+    const std::size_t hw = std::thread::hardware_concurrency();
+    return hw > 1 ? hw - 1 : 0;
+  }
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  bool popOwn(const std::size_t q, std::function<void()> &task);
+  bool steal(const std::size_t q, std::function<void()> &task);
+  bool runOne(const std::size_t q);
+  void workerLoop(const std::size_t q);
+
+  // Queue 0 belongs to the thread calling parallelFor
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> threads;
+
+  std::mutex sleepMutex;
+  std::condition_variable wake;
+  std::atomic<std::size_t> queued{0};
+  bool stopping = false;
+};
+
+inline ThreadPool::ThreadPool(const std::size_t workers) {
+  for (std::size_t q = 0; q < workers + 1; ++q) {
+    queues.push_back(std::make_unique<Queue>());
+  }
+  for (std::size_t q = 1; q < workers + 1; ++q) {
+    threads.emplace_back([this, q] { workerLoop(q); });
+  }
+}
+
+inline ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+inline bool ThreadPool::popOwn(const std::size_t q,
+                               std::function<void()> &task) {
+  Queue &queue = *queues[q];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tasks.empty()) {
+    return false;
+  }
+  task = std::move(queue.tasks.back());
+  queue.tasks.pop_back();
+  return true;
+}
+
+inline bool ThreadPool::steal(const std::size_t q,
+                              std::function<void()> &task) {
+  for (std::size_t k = 1; k < queues.size(); ++k) {
+    Queue &victim = *queues[(q + k) % queues.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+inline bool ThreadPool::runOne(const std::size_t q) {
+  std::function<void()> task;
+  if (!popOwn(q, task) && !steal(q, task)) {
+    return false;
+  }
+  queued.fetch_sub(1, std::memory_order_acq_rel);
+  task();
+  return true;
+}
+
+inline void ThreadPool::workerLoop(const std::size_t q) {
+  for (;;) {
+    if (runOne(q)) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    wake.wait(lock, [this] {
+      return stopping || queued.load(std::memory_order_acquire) > 0;
+    });
+    if (stopping) {
+      return;
+    }
+  }
+}
+
+template <typename Task>
+void ThreadPool::parallelFor(const std::size_t count, Task task) {
+  if (count == 0) {
+    return;
+  }
+  if (queues.size() == 1) {
+    for (std::size_t i = 0; i < count; ++i) {
+      task(i);
+    }
+    return;
+  }
+
+  std::atomic<std::size_t> remaining{count};
+  std::mutex doneMutex;
+  std::condition_variable done;
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+
+  // Deal contiguous runs of indices to the deques. Each run is pushed in
+  // reverse so its owner pops it in order while thieves take the far end
+  const std::size_t run = (count + queues.size() - 1) / queues.size();
+  for (std::size_t q = 0; q < queues.size(); ++q) {
+    const std::size_t first = std::min(count, q * run);
+    const std::size_t last = std::min(count, first + run);
+    if (first == last) {
+      continue;
+    }
+
+    Queue &queue = *queues[q];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    for (std::size_t i = last; i-- > first;) {
+      queue.tasks.emplace_back([&, i] {
+        // Nothing escapes to the worker: the exception goes to the caller,
+        // and remaining counts down either way so the wait below ends
+        std::exception_ptr thrown;
+        if (!failed.load(std::memory_order_acquire)) {
+          try {
+            task(i);
+          } catch (...) {
+            thrown = std::current_exception();
+          }
+        }
+        // Under the lock so the waiter can not return, and destroy the
+        // locals captured here, before the notification is out
+        std::lock_guard<std::mutex> doneLock(doneMutex);
+        if (thrown && !error) {
+          error = thrown;
+          failed.store(true, std::memory_order_release);
+        }
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          done.notify_all();
+        }
+      });
+    }
+    queued.fetch_add(last - first, std::memory_order_acq_rel);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+  }
+  wake.notify_all();
+
+  // Help until nothing is left to take, then wait for the tasks in flight
+  while (remaining.load(std::memory_order_acquire) > 0 && runOne(0)) {
+  }
+
+  std::unique_lock<std::mutex> lock(doneMutex);
+  done.wait(lock,
+            [&] { return remaining.load(std::memory_order_acquire) == 0; });
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+} // namespace utils
+
+#endif // !THREAD_POOL_H
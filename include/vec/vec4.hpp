@@ -0,0 +1,24 @@
+
+#ifndef VEC_4_H
+#define VEC_4_H
+
+namespace vector {
+template <typename T = float> class Vec4 {
+public:
+  constexpr Vec4() : x(T(0)), y(T(0)), z(T(0)), w(T(0)) {}
+  constexpr Vec4(T xx, T yy, T zz, T ww) : x(xx), y(yy), z(zz), w(ww) {}
+  constexpr Vec4 operator*(const T &r) const;
+  constexpr Vec4 &operator*=(const T &r);
+  T x, y, z, w;
+};
+
+template <typename T = float>
+constexpr T dot(const Vec4<T> &a, const Vec4<T> &b);
+
+using Vec4f = Vec4<float>;
+
+} // namespace vector
+
+#include "vec/vec4_impl.hpp"
+
+#endif // !VEC_4_H
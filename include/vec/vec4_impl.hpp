@@ -0,0 +1,28 @@
+
+#ifndef VEC_4_IMPL_H
+#define VEC_4_IMPL_H
+
+#include "vec/vec4.hpp"
+
+namespace vector {
+
+template <typename T> constexpr Vec4<T> Vec4<T>::operator*(const T &r) const {
+  return Vec4<T>(x * r, y * r, z * r, w * r);
+}
+
+template <typename T> constexpr Vec4<T> &Vec4<T>::operator*=(const T &r) {
+  x *= r;
+  y *= r;
+  z *= r;
+  w *= r;
+  return *this;
+}
+
+template <typename T>
+constexpr T dot(const Vec4<T> &a, const Vec4<T> &b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+} // namespace vector
+
+#endif // !VEC_4_IMPL_H
@@ -0,0 +1,25 @@
+
+#ifndef VEC_5_H
+#define VEC_5_H
+
+namespace vector {
+template <typename T = float> class Vec5 {
+public:
+  constexpr Vec5() : x(T(0)), y(T(0)), z(T(0)), w(T(0)), v(T(0)) {}
+  constexpr Vec5(T xx, T yy, T zz, T ww, T vv)
+      : x(xx), y(yy), z(zz), w(ww), v(vv) {}
+  constexpr Vec5 operator*(const T &r) const;
+  constexpr Vec5 &operator*=(const T &r);
+  T x, y, z, w, v;
+};
+
+template <typename T = float>
+constexpr T dot(const Vec5<T> &a, const Vec5<T> &b);
+
+using Vec5f = Vec5<float>;
+
+} // namespace vector
+
+#include "vec/vec5_impl.hpp"
+
+#endif // !VEC_5_H
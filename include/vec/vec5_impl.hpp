@@ -0,0 +1,29 @@
+
+#ifndef VEC_5_IMPL_H
+#define VEC_5_IMPL_H
+
+#include "vec/vec5.hpp"
+
+namespace vector {
+
+template <typename T> constexpr Vec5<T> Vec5<T>::operator*(const T &r) const {
+  return Vec5<T>(x * r, y * r, z * r, w * r, v * r);
+}
+
+template <typename T> constexpr Vec5<T> &Vec5<T>::operator*=(const T &r) {
+  x *= r;
+  y *= r;
+  z *= r;
+  w *= r;
+  v *= r;
+  return *this;
+}
+
+template <typename T>
+constexpr T dot(const Vec5<T> &a, const Vec5<T> &b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w + a.v * b.v;
+}
+
+} // namespace vector
+
+#endif // !VEC_5_IMPL_H
@@ -1,28 +1,39 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <fstream>
 #include <functional>
 #include <iostream>
 #include <random>
 #include <string>
+#include <vector>
 
+#include "noise/baked_texture.hpp"
+#include "noise/chunk_cache.hpp"
+#include "noise/fixed_noise.hpp"
+#include "noise/fractal_noise.hpp"
+#include "noise/large_world.hpp"
+#include "noise/mip_pyramid.hpp"
+#include "noise/normal_map.hpp"
+#include "noise/normalized_noise.hpp"
 #include "noise/perlin_noise.hpp"
+#include "noise/pixel_stages.hpp"
+#include "noise/shared_noise.hpp"
+#include "noise/simd/noise_kernels.hpp"
+#include "noise/simplex_noise.hpp"
+#include "noise/tiled_generator.hpp"
 #include "noise/value_noise.hpp"
+#include "noise/value_noise_channels.hpp"
+#include "noise/worley_noise.hpp"
+#include "utils/band_pipeline.hpp"
+#include "utils/constants.hpp"
+#include "utils/image_writer.hpp"
+#include "utils/streaming_stats.hpp"
+#include "utils/thread_pool.hpp"
 #include "vec/vec2.hpp"
 #include "vec/vec3.hpp"
 
-void save2PPM(const char *filename, unsigned imageWidth, unsigned imageHeight,
-              float *noiseMap) {
-  // output noise map to PPM
-  std::ofstream ofs;
-  ofs.open(filename, std::ios::out | std::ios::binary);
-  ofs << "P6\n" << imageWidth << " " << imageHeight << "\n255\n";
-  for (unsigned k = 0; k < imageWidth * imageHeight; ++k) {
-    unsigned char n = static_cast<unsigned char>(noiseMap[k] * 255);
-    ofs << n << n << n;
-  }
-  ofs.close();
-}
-
 int main() {
   noise::PerlinNoise noiseTest;
 #if 0
@@ -39,7 +50,16 @@ int main() {
 
   unsigned imageWidth = 512;
   unsigned imageHeight = 512;
-  float *noiseMap = new float[imageWidth * imageHeight];
+
+  // The noise tables are shared read-only by every thread of the pool
+  utils::ThreadPool pool;
+
+  // The images are generated band by band into a ring of buffers, while a
+  // writer thread streams the previous bands to disk: the writes of an
+  // image overlap the generation of the next one. The bands are whole
+  // rows of tiles
+  utils::BandPipeline pipeline;
+  const std::size_t tileRows = noise::kDefaultTileSize;
 
   // generate white noise
   unsigned seed = 2016;
@@ -47,121 +67,193 @@ int main() {
   std::uniform_real_distribution distr;
   auto dice = std::bind(distr, gen); // std::function<float()>
 
-  for (unsigned j = 0; j < imageHeight; ++j) {
-    for (unsigned i = 0; i < imageWidth; ++i) {
-      // generate a float in the range [0:1]
-      noiseMap[j * imageWidth + i] = dice();
-    }
-  }
-
-  // output white noise map to PPM
-  save2PPM("./white_noise.ppm", imageWidth, imageHeight, noiseMap);
-  delete[] noiseMap;
-  noiseMap = new float[imageWidth * imageHeight];
+  utils::writeImageBands<float>(
+      pipeline, "./white_noise.pgm", imageWidth, imageHeight,
+      utils::ImageFormat::PGM8,
+      [&](std::size_t, std::size_t rows, float *band) {
+        for (std::size_t k = 0; k < rows * imageWidth; ++k) {
+          // generate a float in the range [0:1]
+          band[k] = dice();
+        }
+      });
 
   noise::ValueNoise2D noise;
   {
-    // generate value noise
+    // generate value noise, quantized to 8 bits row by row as it is
+    // generated: the image is never held as floats
     float frequency = 0.05f;
-    for (unsigned j = 0; j < imageHeight; ++j) {
-      for (unsigned i = 0; i < imageWidth; ++i) {
-        // generate a float in the range [0:1]
-        noiseMap[j * imageWidth + i] =
-            noise.eval(vector::Vec2<float>(i, j) * frequency);
-      }
-    }
+    utils::writeImageBands<std::uint8_t>(
+        pipeline, "./value_noise.pgm", imageWidth, imageHeight,
+        utils::ImageFormat::PGM8,
+        [&](std::size_t row, std::size_t rows, std::uint8_t *band) {
+          noise::generateGridPixels(pool, noise, vector::Vec2f(0, 0),
+                                    frequency, imageWidth, rows,
+                                    noise::QuantizeStage<std::uint8_t>(),
+                                    band, imageWidth,
+                                    noise::kDefaultTileSize, row);
+        },
+        tileRows);
   }
 
-  // output value noise map to PPM
-  save2PPM("./value_noise.ppm", imageWidth, imageHeight, noiseMap);
-  delete[] noiseMap;
-  noiseMap = new float[imageWidth * imageHeight];
-
   // Brown Noise
+  utils::StreamingStats<float> brownStats;
   {
-    unsigned numLayers = 5;
-    float maxNoiseVal = 0;
     float frequency = 0.01f;
-    for (unsigned j = 0; j < imageHeight; ++j) {
-      for (unsigned i = 0; i < imageWidth; ++i) {
-        vector::Vec2f pNoise = vector::Vec2f(i, j) * frequency;
-        float amplitude = 1.0f / frequency;
-        noiseMap[j * imageWidth + i] = 0;
-        for (unsigned l = 0; l < numLayers; ++l) {
-          noiseMap[j * imageWidth + i] += noise.eval(pNoise) * amplitude;
-          pNoise *= 2.0;
-          amplitude *= 0.5;
-        }
-        if (noiseMap[j * imageWidth + i] > maxNoiseVal)
-          maxNoiseVal = noiseMap[j * imageWidth + i];
-      }
-    }
-
-    for (size_t i = 0; i < imageWidth * imageHeight; i++) {
-      noiseMap[i] /= maxNoiseVal;
-    }
+    // Normalized through the analytic bounds of the sum as it is generated
+    noise::NormalizedNoise<noise::FractalNoise<noise::ValueNoise2D, 5>>
+        brownNoise({noise, 2.0f, 0.5f});
+    // Bands of whole tile rows gather the tiles in the order of the whole
+    // image, the statistics are the same
+    utils::writeImageBands<float>(
+        pipeline, "./brown_noise.pgm", imageWidth, imageHeight,
+        utils::ImageFormat::PGM8,
+        [&](std::size_t row, std::size_t rows, float *band) {
+          noise::generateGridStats(pool, brownNoise, vector::Vec2f(0, 0),
+                                   frequency, imageWidth, rows, band,
+                                   imageWidth, brownStats,
+                                   noise::kDefaultTileSize, row);
+        },
+        tileRows);
   }
 
-  // output brown noise map to PPM
-  save2PPM("./brown_noise.ppm", imageWidth, imageHeight, noiseMap);
-  delete[] noiseMap;
-  noiseMap = new float[imageWidth * imageHeight];
-
   float frequency = 0.02f;
   float frequencyMult = 1.8; // lacunarity
   float amplitudeMult = 0.35;
-  unsigned numLayers = 5;
-  float maxNoiseVal = 0;
-  for (unsigned j = 0; j < imageHeight; ++j) {
-    for (unsigned i = 0; i < imageWidth; ++i) {
-      vector::Vec2f pNoise = vector::Vec2f(i, j) * frequency;
-      float amplitude = 1;
-      noiseMap[j * imageWidth + i] = 0;
-      for (unsigned l = 0; l < numLayers; ++l) {
 //#define TURBULENCE
 #ifdef TURBULENCE
-#include <cmath>
-        noiseMap[j * imageWidth + i] +=
-            std::fabs(2 * noise.eval(pNoise) - 1) * amplitude;
+  constexpr auto fractalMode = noise::FractalMode::Turbulence;
 #else
-        noiseMap[j * imageWidth + i] += noise.eval(pNoise) * amplitude;
+  constexpr auto fractalMode = noise::FractalMode::FBm;
 #endif // !TURBULENCE
-
-        pNoise *= frequencyMult;
-        amplitude *= amplitudeMult;
-      }
+  using FractalNoise2D =
+      noise::FractalNoise<noise::ValueNoise2D, 5, fractalMode>;
+  noise::NormalizedNoise<FractalNoise2D> fractalNoise(
+      {noise, frequencyMult, amplitudeMult});
 
 //#define MARBEL_TEXTURE
 #define WOOD_TEXTURE
+  // output noise map to PGM
+  utils::writeImageBands<float>(
+      pipeline, "./noise.pgm", imageWidth, imageHeight,
+      utils::ImageFormat::PGM8,
+      [&](std::size_t row, std::size_t rows, float *band) {
 #ifdef MARBEL_TEXTURE
-#include "utils/constants.hpp"
-#include <cmath>
-
-      noiseMap[j * imageWidth + i] =
-          (std::sin((i + noiseMap[j * imageWidth + i] * 100) * 2 *
-                    utils::pi<float> / 200.f) +
-           1) /
-          2.f;
-      maxNoiseVal = 1.0f;
+        noise::generateSamples(
+            pool, imageWidth, rows, band, imageWidth,
+            [&](unsigned i, unsigned j) {
+              float value = fractalNoise.base().eval(
+                  vector::Vec2f(i, row + j) * frequency);
+              return (std::sin((i + value * 100) * 2 * utils::pi<float> /
+                               200.f) +
+                      1) /
+                     2.f;
+            });
 #elif defined(WOOD_TEXTURE)
-#include "utils/fast_convertion.hpp"
-      constexpr int grain = 4; // Wood Grain
-      float g = noise.eval(vector::Vec2f(i, j) * frequency) * grain;
-      noiseMap[j * imageWidth + i] = g - static_cast<int>(g);
-      maxNoiseVal = 1.0f;
+        noise::generateSamples(
+            pool, imageWidth, rows, band, imageWidth,
+            [&](unsigned i, unsigned j) {
+              constexpr int grain = 4; // Wood Grain
+              float g =
+                  noise.eval(vector::Vec2f(i, row + j) * frequency) * grain;
+              return g - static_cast<int>(g);
+            });
 #else
-      if (noiseMap[j * imageWidth + i] > maxNoiseVal) {
-        maxNoiseVal = noiseMap[j * imageWidth + i];
-      }
+        noise::generateGrid(pool, fractalNoise, vector::Vec2f(0, 0),
+                            frequency, imageWidth, rows, band, imageWidth,
+                            noise::kDefaultTileSize, row);
 #endif // MARBEL_TEXTURE
-    }
+      },
+      tileRows);
+
+  // Simplex noise, mapped from [-1, 1] to [0, 1], for the next 2 images
+  noise::NormalizedNoise<noise::SimplexNoise<>> simplexNoise;
+  utils::writeImageBands<float>(
+      pipeline, "./simplex_noise.pgm", imageWidth, imageHeight,
+      utils::ImageFormat::PGM8,
+      [&](std::size_t row, std::size_t rows, float *band) {
+        noise::generateGrid(pool, simplexNoise, vector::Vec2f(0, 0), 0.02f,
+                            imageWidth, rows, band, imageWidth,
+                            noise::kDefaultTileSize, row);
+      },
+      tileRows);
+
+  // The same simplex noise colored as a terrain, through a gradient table
+  {
+    const noise::ColorizeStage<utils::Rgb8> terrain({{0.0f, 10, 30, 120},
+                                                     {0.45f, 40, 110, 200},
+                                                     {0.5f, 210, 200, 140},
+                                                     {0.6f, 60, 150, 50},
+                                                     {0.8f, 100, 80, 60},
+                                                     {1.0f, 250, 250, 250}});
+    utils::writeImageBands<utils::Rgb8>(
+        pipeline, "./simplex_terrain.ppm", imageWidth, imageHeight,
+        utils::ImageFormat::PPM8,
+        [&](std::size_t row, std::size_t rows, utils::Rgb8 *band) {
+          noise::generateGridPixels(pool, simplexNoise, vector::Vec2f(0, 0),
+                                    0.02f, imageWidth, rows, terrain, band,
+                                    imageWidth, noise::kDefaultTileSize,
+                                    row);
+        },
+        tileRows);
+  }
+
+  // Cellular noise, the distance to the cell borders (F2 - F1): dark lines
+  // between the cells, lighter towards their feature points
+  {
+    noise::WorleyNoise2D<noise::EuclideanMetric, noise::CellularOutput::Edge>
+        worleyNoise;
+    utils::writeImageBands<std::uint8_t>(
+        pipeline, "./worley_noise.pgm", imageWidth, imageHeight,
+        utils::ImageFormat::PGM8,
+        [&](std::size_t row, std::size_t rows, std::uint8_t *band) {
+          noise::generateGridPixels(
+              pool, worleyNoise, vector::Vec2f(0, 0), 0.05f, imageWidth,
+              rows, noise::QuantizeStage<std::uint8_t>(0.0f, 0.5f), band,
+              imageWidth, noise::kDefaultTileSize, row);
+        },
+        tileRows);
   }
-  for (unsigned i = 0; i < imageWidth * imageHeight; ++i)
-    noiseMap[i] /= maxNoiseVal;
 
-  // output noise map to PPM
-  save2PPM("./noise.ppm", imageWidth, imageHeight, noiseMap);
-  delete[] noiseMap;
+  // Domain warped value noise: 2 channels displace the sample, a third one
+  // is read at the displaced point, all from one set of interleaved tables
+  {
+    noise::ValueNoiseChannels<3> warpNoise;
+    utils::writeImageBands<float>(
+        pipeline, "./warped_noise.pgm", imageWidth, imageHeight,
+        utils::ImageFormat::PGM8,
+        [&](std::size_t row, std::size_t rows, float *band) {
+          noise::generateSamples(pool, imageWidth, rows, band, imageWidth,
+                                 [&](unsigned i, unsigned j) {
+                                   return warpNoise.evalWarped(
+                                       vector::Vec2f(i, row + j) * 0.02f,
+                                       4.0f)[2];
+                                 });
+        },
+        tileRows);
+  }
+
+  // The last bands are still being written while the normal map below is
+  // generated
+  // Normal map of a Perlin fBm height field, one derivative evaluation per
+  // pixel. The packed normals are RGBA8 on little endian machines, written
+  // as a PAM file
+  {
+    std::vector<std::uint32_t> normals(imageWidth * imageHeight);
+    noise::FractalNoise<noise::PerlinNoise, 5> heightNoise;
+    noise::generateNormalMap(pool, heightNoise, vector::Vec2f(0, 0), 0.01f,
+                             40.0f, imageWidth, imageHeight, normals.data(),
+                             imageWidth);
+
+    std::ofstream ofs("./normal_map.pam", std::ios::binary);
+    ofs << "P7\nWIDTH " << imageWidth << "\nHEIGHT " << imageHeight
+        << "\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n";
+    ofs.write(reinterpret_cast<const char *>(normals.data()),
+              normals.size() * sizeof(std::uint32_t));
+  }
+
+  if (!pipeline.drain()) {
+    std::cerr << "Writing the noise images failed" << std::endl;
+  }
 
   noise::ValueNoise1D valueNoise1D;
   noise::ValueNoise2D valueNoise2D;
@@ -182,5 +274,167 @@ int main() {
   std::cout << "PerlinNoise size "
             << ": " << sizeof(perlinNoise3D) << std::endl;
 
+  // Same noises with the compact lattice tables
+  using CompactValueNoise3D =
+      noise::ValueNoiseND<3, 256, std::default_random_engine, float,
+                          noise::smoothstepRemap<float>,
+                          noise::TableLayout::Compact>;
+  using CompactPerlinNoise =
+      noise::PerlinNoise3D<256, std::default_random_engine, float,
+                           noise::TableLayout::Compact>;
+
+  std::cout << "Compact ValueNoise3D size "
+            << ": " << sizeof(CompactValueNoise3D) << std::endl;
+
+  std::cout << "Compact PerlinNoise size "
+            << ": " << sizeof(CompactPerlinNoise) << std::endl;
+
+  using ImprovedPerlinNoise =
+      noise::PerlinNoise3D<256, std::default_random_engine, float,
+                           noise::TableLayout::Wide,
+                           noise::PerlinGradients::Improved>;
+
+  std::cout << "Improved PerlinNoise size "
+            << ": " << sizeof(ImprovedPerlinNoise) << std::endl;
+
+  // Without tables, hashing the lattice coordinates
+  using HashedValueNoise3D =
+      noise::ValueNoiseND<3, 256, std::default_random_engine, float,
+                          noise::smoothstepRemap<float>,
+                          noise::TableLayout::Hashed>;
+  using HashedPerlinNoise =
+      noise::PerlinNoise3D<256, std::default_random_engine, float,
+                           noise::TableLayout::Hashed,
+                           noise::PerlinGradients::Improved>;
+
+  std::cout << "Hashed ValueNoise3D size "
+            << ": " << sizeof(HashedValueNoise3D) << std::endl;
+
+  std::cout << "Hashed Improved PerlinNoise size "
+            << ": " << sizeof(HashedPerlinNoise) << std::endl;
+
+  std::cout << "SimplexNoise size "
+            << ": " << sizeof(noise::SimplexNoise<>) << std::endl;
+
+  // Tables drawn at compile time, there is nothing to construct. The sample
+  // is the same with every compiler and standard library
+  static constexpr noise::PerlinNoise staticPerlin{noise::StaticSeed{2011}};
+
+  std::cout << "Static PerlinNoise at (0.5, 0.5, 0.5) "
+            << ": " << staticPerlin.eval(vector::Vec3f(0.5f, 0.5f, 0.5f))
+            << std::endl;
+
+  // Many noise nodes on a handful of seeds share the tables of each seed
+  std::vector<noise::SharedNoise<noise::PerlinNoise>> nodes;
+  for (unsigned i = 0; i < 1000; ++i) {
+    nodes.emplace_back(static_cast<float>(2011 + i % 4));
+  }
+
+  std::cout << "SharedNoise size "
+            << ": " << sizeof(nodes[0]) << ", "
+            << noise::NoiseRegistry<noise::PerlinNoise>::size()
+            << " tables for " << nodes.size() << " nodes" << std::endl;
+
+  // A camera panning over fBm terrain, 3 x 3 chunks around it: only the
+  // column of chunks entering the view is generated at each step
+  {
+    using Terrain = noise::FractalNoise<noise::ValueNoise2D, 5>;
+    Terrain terrain;
+    noise::ChunkCache<float> cache(64 * 64 * sizeof(float) * 16);
+    noise::NoiseChunks<Terrain, vector::Vec2f> chunks(
+        terrain, noise::chunkSource<Terrain>(2011.0f), vector::Vec2f(0, 0),
+        0.01f, 64, cache);
+    for (int camera = 0; camera < 8; ++camera) {
+      pool.parallelFor(9, [&](const std::size_t c) {
+        chunks.chunk(camera + static_cast<int>(c % 3) - 1,
+                     static_cast<int>(c / 3) - 1);
+      });
+    }
+
+    const noise::ChunkCacheStats stats = cache.stats();
+    std::cout << "Chunk cache "
+              << ": " << stats.hits + stats.joins << " hits, " << stats.misses
+              << " misses, " << stats.evictions << " evictions" << std::endl;
+  }
+
+  // A zoomable map of a deep fBm sum: the finer levels only evaluate the
+  // octaves the coarser ones cannot stand for
+  {
+    using Map = noise::FractalNoise<noise::ValueNoise2D, 12>;
+    Map map;
+    const std::vector<noise::MipLevel<float>> pyramid =
+        noise::generateMipPyramid(pool, map, vector::Vec2f(0, 0), 0.001f, 512,
+                                  512);
+    std::cout << "Mip pyramid octaves evaluated per level "
+              << ":";
+    for (const noise::MipLevel<float> &level : pyramid) {
+      std::cout << " " << level.evaluatedOctaves;
+    }
+    std::cout << ", error bound " << pyramid[0].errorBound << std::endl;
+  }
+
+  // The whole period of the 3D noise baked as a tileable 2D texture, 4
+  // samples per lattice cell
+  {
+    const auto texture = noise::bakeTexture(pool, perlinNoise3D,
+                                            vector::Vec2f(0, 0), 0.25f, 1024);
+    const noise::BakeError<float> error =
+        noise::measureBakeError(texture, perlinNoise3D);
+    std::cout << "Baked texture "
+              << ": " << (texture.bytes() >> 20) << " MB, error max "
+              << error.max << ", rms " << error.rms << std::endl;
+  }
+
+  // The same Perlin noise in integer arithmetic, over a row of the images
+  {
+    const noise::FixedPerlinNoise3D<> fixedPerlin;
+    std::vector<noise::Fixed_Type> x(1024), y(1024), z(1024);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+      x[i] = noise::toFixed(i * 0.05);
+      y[i] = noise::toFixed(1.5);
+      z[i] = noise::toFixed(0.5);
+    }
+    std::vector<noise::Q15_Type> samples(x.size());
+    fixedPerlin.evalBatch(x.data(), y.data(), z.data(), x.size(),
+                          samples.data());
+    float maxError = 0;
+    for (std::size_t i = 0; i < x.size(); ++i) {
+      const float expected =
+          perlinNoise3D.eval(vector::Vec3f(i * 0.05f, 1.5f, 0.5f));
+      maxError = std::max(
+          maxError, std::fabs(noise::fromQ15(samples[i]) - expected));
+    }
+    std::cout << "Fixed point Perlin noise "
+              << ": error max " << maxError << std::endl;
+  }
+
+  // Two neighbouring chunks 2^40 cells away from the origin, each seen
+  // from its own integer origin: the samples of their common edge agree to
+  // float precision
+  {
+    const noise::FractalNoise<noise::ValueNoise2D, 5> terrain(noise, 1.8f,
+                                                              0.5f);
+    const std::int64_t far = std::int64_t{1} << 40;
+    const noise::WorldCell2 west(far, -far);
+    const noise::WorldCell2 east(west.x + 64, west.y);
+    const auto westChunk = noise::rebase(terrain, west);
+    const auto eastChunk = noise::rebase(terrain, east);
+    float seam = 0;
+    for (unsigned j = 0; j < 64; ++j) {
+      const float y = j * 0.5f;
+      seam = std::max(seam, std::fabs(westChunk.eval(vector::Vec2f(64, y)) -
+                                      eastChunk.eval(vector::Vec2f(0, y))));
+    }
+    std::cout << "Large world seam at 2^40 cells "
+              << ": " << seam << std::endl;
+  }
+
+  std::cout << "Brown noise range "
+            << ": [" << brownStats.min() << ", " << brownStats.max()
+            << "], mean " << brownStats.mean() << std::endl;
+
+  std::cout << "Batch kernels "
+            << ": " << noise::simd::activeKernelName() << std::endl;
+
   return 0;
 }
\ No newline at end of file
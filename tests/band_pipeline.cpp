@@ -0,0 +1,118 @@
+// CH_NOISE_BAND_PIPELINE: writeImageBands writes every row of an image
+// through a small ring of bands, refuses rows larger than a band instead of
+// looping on empty bands, and gives the band back when fill throws, so the
+// ring does not run dry. Returns 1 and prints the checks that fail
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "utils/band_pipeline.hpp"
+#include "utils/image_writer.hpp"
+
+namespace {
+
+int failures = 0;
+
+void expect(const bool ok, const std::string &what) {
+  if (!ok) {
+    std::cerr << "FAIL " << what << std::endl;
+    ++failures;
+  }
+}
+
+// Rows of the value of their index, as raw floats
+void fillRows(const std::size_t row, const std::size_t rows, float *band,
+              const std::size_t width) {
+  for (std::size_t j = 0; j < rows; ++j) {
+    for (std::size_t i = 0; i < width; ++i) {
+      band[j * width + i] = static_cast<float>(row + j);
+    }
+  }
+}
+
+// The floats of filename, row after row, hold their row index
+bool checkFile(const char *filename, const std::size_t width,
+               const std::size_t height) {
+  std::ifstream ifs(filename, std::ios::binary);
+  for (std::size_t j = 0; j < height; ++j) {
+    for (std::size_t i = 0; i < width; ++i) {
+      float v;
+      if (!ifs.read(reinterpret_cast<char *>(&v), sizeof(v)) ||
+          v != static_cast<float>(j)) {
+        return false;
+      }
+    }
+  }
+  return ifs.peek() == std::ifstream::traits_type::eof();
+}
+
+} // namespace
+
+int main() {
+  const char *filename = "band_pipeline_test.raw";
+  const std::size_t width = 16, height = 37;
+  // 2 bands of 3 rows of 16 floats
+  utils::BandPipeline pipeline(2, 3 * width * sizeof(float));
+
+  expect(utils::bandRows(pipeline, width, sizeof(float)) == 3,
+         "bandRows fits 3 rows");
+  expect(utils::bandRows(pipeline, width, sizeof(float), 2) == 2,
+         "bandRows rounds down to the row multiple");
+
+  bool refused = false;
+  try {
+    utils::bandRows(pipeline, 4 * width, sizeof(float));
+  } catch (const std::length_error &) {
+    refused = true;
+  }
+  expect(refused, "bandRows refuses a row larger than a band");
+
+  utils::writeImageBands<float>(
+      pipeline, filename, width, height, utils::ImageFormat::RawFloat32,
+      [&](const std::size_t row, const std::size_t rows, float *band) {
+        fillRows(row, rows, band, width);
+      });
+  expect(pipeline.drain(), "writeImageBands writes the image");
+  expect(checkFile(filename, width, height),
+         "writeImageBands writes every row in order");
+
+  // More throws than bands: a lost band would block acquire for good
+  for (int round = 0; round < 5; ++round) {
+    bool caught = false;
+    try {
+      utils::writeImageBands<float>(
+          pipeline, filename, width, height, utils::ImageFormat::RawFloat32,
+          [&](const std::size_t row, const std::size_t rows, float *band) {
+            if (row >= 12) {
+              throw std::runtime_error("fill");
+            }
+            fillRows(row, rows, band, width);
+          });
+    } catch (const std::runtime_error &) {
+      caught = true;
+    }
+    expect(caught, "writeImageBands rethrows the exception of fill");
+    // The bands filled before the throw are still written
+    pipeline.drain();
+  }
+
+  utils::writeImageBands<float>(
+      pipeline, filename, width, height, utils::ImageFormat::RawFloat32,
+      [&](const std::size_t row, const std::size_t rows, float *band) {
+        fillRows(row, rows, band, width);
+      });
+  expect(pipeline.drain(), "writeImageBands writes after failed fills");
+  expect(checkFile(filename, width, height),
+         "writeImageBands writes every row after failed fills");
+  std::remove(filename);
+
+  if (failures != 0) {
+    std::cerr << failures << " check(s) failed" << std::endl;
+    return 1;
+  }
+  std::cout << "BandPipeline writes the bands" << std::endl;
+  return 0;
+}
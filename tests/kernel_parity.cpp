@@ -0,0 +1,356 @@
+// CH_NOISE_KERNEL_PARITY: the evalBatch of every noise with vector kernels
+// against its eval, under each kernel set the CPU supports.
+//
+// The kernels promise the results of the scalar code bit for bit, so the
+// samples are compared as bytes. The points are spread over negative and
+// positive coordinates, lattice planes included, and their count is not a
+// multiple of any vector width, so the tails are covered too. Returns 1 and
+// prints the first difference of each failing case
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "noise/baked_texture.hpp"
+#include "noise/fixed_noise.hpp"
+#include "noise/large_world.hpp"
+#include "noise/perlin_noise.hpp"
+#include "noise/pixel_stages.hpp"
+#include "noise/simd/noise_kernels.hpp"
+#include "noise/simplex_noise.hpp"
+#include "noise/value_noise.hpp"
+#include "noise/worley_noise.hpp"
+#include "utils/cpu_features.hpp"
+#include "utils/thread_pool.hpp"
+#include "vec/vec2.hpp"
+#include "vec/vec3.hpp"
+#include "vec/vec4.hpp"
+
+namespace {
+
+// Odd on purpose: every kernel ends on a partial block
+constexpr std::size_t kCount = 1021;
+
+// Structure of arrays, the layout evalBatch takes
+struct Points {
+  std::vector<float> x, y, z, w;
+};
+
+// Random points in [-range, range), then lattice planes and their
+// neighbours: integers, -0, and the floats just below and above them
+Points makePoints(const float range) {
+  Points points;
+  std::vector<float> *axes[] = {&points.x, &points.y, &points.z, &points.w};
+  std::mt19937 gen(2016);
+  std::uniform_real_distribution<float> distr(-range, range);
+  for (std::vector<float> *axis : axes) {
+    axis->resize(kCount);
+    for (float &v : *axis) {
+      v = distr(gen);
+    }
+  }
+
+  const float special[] = {0.0f, -0.0f, 1.0f, -1.0f, 3.0f, -7.0f};
+  const float inf = std::numeric_limits<float>::infinity();
+  std::size_t k = 0;
+  for (const float s : special) {
+    for (const float v : {s, std::nextafter(s, -inf), std::nextafter(s, inf)}) {
+      // On a lattice point, then on a plane of the lattice along x only
+      for (std::vector<float> *axis : axes) {
+        (*axis)[k] = v;
+      }
+      points.x[k + 1] = v;
+      k += 2;
+    }
+  }
+  return points;
+}
+
+struct Checker {
+  std::vector<utils::SimdLevel> levels;
+  int failures = 0;
+
+  Checker() {
+    for (const utils::SimdLevel l :
+         {utils::SimdLevel::Scalar, utils::SimdLevel::SSE42,
+          utils::SimdLevel::AVX2, utils::SimdLevel::AVX512}) {
+      if (l <= noise::simd::detectedLevel()) {
+        levels.push_back(l);
+      }
+    }
+  }
+
+  // expected against batch(out) under every level, byte for byte
+  template <typename T, typename Batch>
+  void check(const std::string &name, const std::vector<T> &expected,
+             Batch batch) {
+    for (const utils::SimdLevel level : levels) {
+      noise::simd::setActiveLevel(level);
+      std::vector<T> out(expected.size());
+      batch(out.data());
+      for (std::size_t k = 0; k < out.size(); ++k) {
+        if (std::memcmp(&out[k], &expected[k], sizeof(T)) != 0) {
+          std::cerr << "FAIL " << name << " ["
+                    << utils::simdLevelName(level) << "] sample " << k
+                    << std::endl;
+          ++failures;
+          break;
+        }
+      }
+    }
+    noise::simd::setActiveLevel(noise::simd::detectedLevel());
+  }
+
+  // evalBatch of noise against eval at each point, in 1 to 4 dimensions
+  template <std::size_t Dimension, typename Noise>
+  void checkNoise(const std::string &name, const Noise &noise,
+                  const Points &p) {
+    using T = typename Noise::Value_Type;
+    std::vector<T> expected(kCount);
+    for (std::size_t k = 0; k < kCount; ++k) {
+      if constexpr (Dimension == 1) {
+        expected[k] = noise.eval(p.x[k]);
+      } else if constexpr (Dimension == 2) {
+        expected[k] = noise.eval(vector::Vec2f(p.x[k], p.y[k]));
+      } else if constexpr (Dimension == 3) {
+        expected[k] = noise.eval(vector::Vec3f(p.x[k], p.y[k], p.z[k]));
+      } else {
+        expected[k] =
+            noise.eval(vector::Vec4f(p.x[k], p.y[k], p.z[k], p.w[k]));
+      }
+    }
+    check(name, expected, [&](T *out) {
+      if constexpr (Dimension == 1) {
+        noise.evalBatch(p.x.data(), kCount, out);
+      } else if constexpr (Dimension == 2) {
+        noise.evalBatch(p.x.data(), p.y.data(), kCount, out);
+      } else if constexpr (Dimension == 3) {
+        noise.evalBatch(p.x.data(), p.y.data(), p.z.data(), kCount, out);
+      } else {
+        noise.evalBatch(p.x.data(), p.y.data(), p.z.data(), p.w.data(),
+                        kCount, out);
+      }
+    });
+  }
+
+  // The hashed noise rebased to the world cell origin against noise at
+  // origin + p. The points are on a 2^-10 grid, so the sums are exact
+  template <typename Noise>
+  void checkRebased(const std::string &name, const Noise &noise,
+                    const noise::WorldCell3 &origin, const Points &p) {
+    const auto rebased = noise::rebase(noise, origin);
+    std::vector<float> x(kCount), y(kCount), z(kCount);
+    std::vector<float> expected(kCount);
+    for (std::size_t k = 0; k < kCount; ++k) {
+      x[k] = std::round(p.x[k] * 1024) / 1024;
+      y[k] = std::round(p.y[k] * 1024) / 1024;
+      z[k] = std::round(p.z[k] * 1024) / 1024;
+      expected[k] = noise.eval(vector::Vec3f(
+          x[k] + static_cast<float>(origin.x),
+          y[k] + static_cast<float>(origin.y),
+          z[k] + static_cast<float>(origin.z)));
+    }
+    check(name, expected, [&](float *out) {
+      rebased.evalBatch(x.data(), y.data(), z.data(), kCount, out);
+    });
+  }
+
+  // Same for the Q16.16 coordinates of the fixed point noises
+  template <std::size_t Dimension, typename Noise>
+  void checkFixed(const std::string &name, const Noise &noise,
+                  const Points &p) {
+    std::vector<noise::Fixed_Type> x(kCount), y(kCount), z(kCount);
+    for (std::size_t k = 0; k < kCount; ++k) {
+      x[k] = noise::toFixed(p.x[k]);
+      y[k] = noise::toFixed(p.y[k]);
+      z[k] = noise::toFixed(p.z[k]);
+    }
+    std::vector<noise::Q15_Type> expected(kCount);
+    for (std::size_t k = 0; k < kCount; ++k) {
+      if constexpr (Dimension == 2) {
+        expected[k] = noise.eval(vector::Vec2<noise::Fixed_Type>(x[k], y[k]));
+      } else {
+        expected[k] =
+            noise.eval(vector::Vec3<noise::Fixed_Type>(x[k], y[k], z[k]));
+      }
+    }
+    check(name, expected, [&](noise::Q15_Type *out) {
+      if constexpr (Dimension == 2) {
+        noise.evalBatch(x.data(), y.data(), kCount, out);
+      } else {
+        noise.evalBatch(x.data(), y.data(), z.data(), kCount, out);
+      }
+    });
+  }
+
+  // A pixel stage under each level against its scalar path
+  template <typename Pixel, typename Stage>
+  void checkStage(const std::string &name, const Stage &stage,
+                  const std::vector<float> &samples) {
+    std::vector<Pixel> expected(samples.size());
+    noise::simd::setActiveLevel(utils::SimdLevel::Scalar);
+    stage(samples.data(), samples.size(), expected.data());
+    check(name, expected, [&](Pixel *out) {
+      stage(samples.data(), samples.size(), out);
+    });
+  }
+};
+
+template <typename Metric, noise::CellularOutput Output>
+void checkWorley(Checker &checker, const std::string &name,
+                 const Points &p) {
+  checker.checkNoise<2>("WorleyNoise2D/" + name,
+                        noise::WorleyNoise2D<Metric, Output>(), p);
+  checker.checkNoise<3>("WorleyNoise3D/" + name,
+                        noise::WorleyNoise3D<Metric, Output>(), p);
+}
+
+} // namespace
+
+int main() {
+  Checker checker;
+  const Points p = makePoints(40);
+  using noise::TableLayout;
+
+  checker.checkNoise<1>("ValueNoise1D", noise::ValueNoise1D(), p);
+  checker.checkNoise<1>(
+      "ValueNoise1D/hashed",
+      noise::ValueNoise1D<256, std::default_random_engine, float,
+                          noise::smoothstepRemap<float>,
+                          TableLayout::Hashed>(),
+      p);
+  checker.checkNoise<2>("ValueNoise2D", noise::ValueNoise2D(), p);
+  checker.checkNoise<3>("ValueNoise3D", noise::ValueNoise3D(), p);
+  checker.checkNoise<3>(
+      "ValueNoise3D/period16/perlin-remap",
+      noise::ValueNoiseND<3, 16, std::default_random_engine, float,
+                          noise::perlinRemap<float>>(),
+      p);
+  checker.checkNoise<2>(
+      "ValueNoise2D/hashed",
+      noise::ValueNoiseND<2, 256, std::default_random_engine, float,
+                          noise::smoothstepRemap<float>,
+                          TableLayout::Hashed>(),
+      p);
+  checker.checkNoise<3>(
+      "ValueNoise3D/hashed",
+      noise::ValueNoiseND<3, 256, std::default_random_engine, float,
+                          noise::smoothstepRemap<float>,
+                          TableLayout::Hashed>(),
+      p);
+
+  checker.checkNoise<3>("PerlinNoise", noise::PerlinNoise(), p);
+  checker.checkNoise<3>(
+      "PerlinNoise/improved",
+      noise::PerlinNoise3D<256, std::default_random_engine, float,
+                           TableLayout::Wide,
+                           noise::PerlinGradients::Improved>(),
+      p);
+  checker.checkNoise<3>(
+      "PerlinNoise/hashed",
+      noise::PerlinNoise3D<256, std::default_random_engine, float,
+                           TableLayout::Hashed>(),
+      p);
+  checker.checkNoise<3>(
+      "PerlinNoise/improved/hashed",
+      noise::PerlinNoise3D<256, std::default_random_engine, float,
+                           TableLayout::Hashed,
+                           noise::PerlinGradients::Improved>(),
+      p);
+
+  {
+    // Hashed lattices moved to a world cell, near the origin against the
+    // noise itself, far from it against eval
+    const noise::ValueNoiseND<3, 256, std::default_random_engine, float,
+                              noise::smoothstepRemap<float>,
+                              TableLayout::Hashed>
+        value;
+    const noise::PerlinNoise3D<256, std::default_random_engine, float,
+                               TableLayout::Hashed>
+        perlin;
+    const noise::WorldCell3 near(-3, 5, 7);
+    const std::int64_t far = std::int64_t{1} << 40;
+    const noise::WorldCell3 away(far, -far, far + 3);
+    checker.checkRebased("ValueNoise3D/hashed/rebased", value, near, p);
+    checker.checkRebased("PerlinNoise/hashed/rebased", perlin, near, p);
+    checker.checkNoise<3>("ValueNoise3D/hashed/far",
+                          noise::rebase(value, away), p);
+    checker.checkNoise<3>("PerlinNoise/hashed/far",
+                          noise::rebase(perlin, away), p);
+  }
+
+  const noise::SimplexNoise<> simplex;
+  checker.checkNoise<2>("SimplexNoise2D", simplex, p);
+  checker.checkNoise<3>("SimplexNoise3D", simplex, p);
+  checker.checkNoise<4>("SimplexNoise4D", simplex, p);
+
+  {
+    // Textures of a few lattice periods, sampled past their borders
+    utils::ThreadPool pool;
+    const noise::PerlinNoise perlin;
+    const auto texture2D =
+        noise::bakeTexture(pool, perlin, vector::Vec2f(0, 0), 0.25f, 64);
+    checker.checkNoise<2>("BakedTexture2D", texture2D, p);
+    const auto texture3D =
+        noise::bakeTexture(pool, perlin, vector::Vec3f(0, 0, 0), 0.5f, 16);
+    checker.checkNoise<3>("BakedTexture3D", texture3D, p);
+  }
+
+  checker.checkFixed<2>("FixedValueNoise2D", noise::FixedValueNoise<2>(), p);
+  checker.checkFixed<3>("FixedValueNoise3D", noise::FixedValueNoise<3>(), p);
+  checker.checkFixed<3>("FixedPerlinNoise3D", noise::FixedPerlinNoise3D<>(),
+                        p);
+  {
+    // The tables of the StaticSeed constructors, drawn at compile time
+    static constexpr noise::FixedValueNoise<3> staticValue{
+        noise::StaticSeed{2011}};
+    static constexpr noise::FixedPerlinNoise3D<> staticPerlin{
+        noise::StaticSeed{2011}};
+    checker.checkFixed<3>("FixedValueNoise3D/static", staticValue, p);
+    checker.checkFixed<3>("FixedPerlinNoise3D/static", staticPerlin, p);
+  }
+
+  using noise::CellularOutput;
+  checkWorley<noise::EuclideanMetric, CellularOutput::F1>(checker,
+                                                          "euclidean/f1", p);
+  checkWorley<noise::EuclideanSquaredMetric, CellularOutput::F2>(
+      checker, "euclidean-squared/f2", p);
+  checkWorley<noise::ManhattanMetric, CellularOutput::Edge>(
+      checker, "manhattan/edge", p);
+  checkWorley<noise::ChebyshevMetric, CellularOutput::F1>(checker,
+                                                          "chebyshev/f1", p);
+
+  // Samples past both ends of the ranges, and NaN
+  std::vector<float> samples(p.x);
+  for (float &v : samples) {
+    v *= 0.05f;
+  }
+  samples[0] = std::numeric_limits<float>::quiet_NaN();
+  checker.checkStage<std::uint8_t>(
+      "QuantizeStage/uint8", noise::QuantizeStage<std::uint8_t>(), samples);
+  checker.checkStage<std::uint16_t>(
+      "QuantizeStage/uint16", noise::QuantizeStage<std::uint16_t>(-1, 1),
+      samples);
+  checker.checkStage<std::uint32_t>(
+      "ColorizeStage/rgba8",
+      noise::ColorizeStage<std::uint32_t>(
+          {{0.0f, 0, 0, 0}, {0.5f, 200, 100, 50}, {1.0f, 255, 255, 255}}),
+      samples);
+
+  if (checker.failures != 0) {
+    std::cerr << checker.failures << " case(s) differ from eval"
+              << std::endl;
+    return 1;
+  }
+  std::cout << "evalBatch matches eval on";
+  for (const utils::SimdLevel level : checker.levels) {
+    std::cout << " " << utils::simdLevelName(level);
+  }
+  std::cout << std::endl;
+  return 0;
+}
@@ -0,0 +1,178 @@
+// CH_NOISE_RANGE: the analytic bounds of noise_range.hpp against the worst
+// case of each gradient set, and against samples of the noises.
+//
+// The worst case lets every corner of a cell pick the gradient with the
+// largest dot product with its offset, as some cell of some table may.
+// The search covers a grid over the cell, then refines around its best
+// point. Returns 1 and prints the bounds that do not hold
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "noise/fractal_noise.hpp"
+#include "noise/noise_range.hpp"
+#include "noise/noise_remap.hpp"
+#include "noise/normalized_noise.hpp"
+#include "noise/perlin_noise.hpp"
+#include "vec/vec3.hpp"
+
+namespace {
+
+int failures = 0;
+
+void expect(const bool ok, const std::string &what) {
+  if (!ok) {
+    std::cerr << "FAIL " << what << std::endl;
+    ++failures;
+  }
+}
+
+// Largest dot product of a gradient of the set with d
+double bestDot(const double (&d)[3], const bool improved) {
+  if (!improved) {
+    // Unit vectors, one along d
+    return std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+  }
+  // The cube edges (+-1, +-1, 0)...: the two largest |d[a]|
+  const double a = std::fabs(d[0]), b = std::fabs(d[1]), c = std::fabs(d[2]);
+  return a + b + c - std::fmin(a, std::fmin(b, c));
+}
+
+// Sum of the corners of the cell at p (in [0, 1]^3), each one weighted by
+// the quintic remap of PerlinNoise3D and at its best gradient
+double worstCase(const double (&p)[3], const bool improved) {
+  double sum = 0;
+  for (int c = 0; c < 8; ++c) {
+    double d[3], weight = 1;
+    for (int a = 0; a < 3; ++a) {
+      const int corner = (c >> a) & 1;
+      const double f = noise::perlinRemap<double>(p[a]);
+      weight *= corner ? f : 1 - f;
+      d[a] = p[a] - corner;
+    }
+    sum += weight * bestDot(d, improved);
+  }
+  return sum;
+}
+
+// Largest worstCase over the cell, over the z = 0 face for dimension 2
+double worstCaseMax(const unsigned dimension, const bool improved) {
+  constexpr int kSteps = 64;
+  double best = 0, at[3] = {0, 0, 0};
+  for (int i = 0; i <= kSteps; ++i) {
+    for (int j = 0; j <= kSteps; ++j) {
+      for (int k = 0; k <= (dimension == 3 ? kSteps : 0); ++k) {
+        const double p[3] = {double(i) / kSteps, double(j) / kSteps,
+                             double(k) / kSteps};
+        const double v = worstCase(p, improved);
+        if (v > best) {
+          best = v;
+          at[0] = p[0], at[1] = p[1], at[2] = p[2];
+        }
+      }
+    }
+  }
+
+  // Hill climbing, halving the step when no neighbour is better
+  for (double h = 1.0 / kSteps; h > 1e-9;) {
+    bool moved = false;
+    for (int n = 0; n < 27; ++n) {
+      const double p[3] = {at[0] + (n % 3 - 1) * h, at[1] + (n / 3 % 3 - 1) * h,
+                           dimension == 3 ? at[2] + (n / 9 - 1) * h : 0};
+      if (p[0] < 0 || p[0] > 1 || p[1] < 0 || p[1] > 1 || p[2] < 0 ||
+          p[2] > 1) {
+        continue;
+      }
+      const double v = worstCase(p, improved);
+      if (v > best) {
+        best = v;
+        at[0] = p[0], at[1] = p[1], at[2] = p[2];
+        moved = true;
+      }
+    }
+    h = moved ? h : h / 2;
+  }
+  return best;
+}
+
+template <typename Noise>
+void checkSamples(const std::string &name, const Noise &noise) {
+  const noise::Range<float> range = Noise::outputRange(3);
+  const noise::NormalizedNoise<Noise> normalized(noise);
+  std::mt19937 gen(2016);
+  std::uniform_real_distribution<float> distr(-512, 512);
+  float low = 0, high = 0;
+  bool normalizedOk = true;
+  for (int k = 0; k < (1 << 20); ++k) {
+    const vector::Vec3f p(distr(gen), distr(gen), distr(gen));
+    const float v = noise.eval(p);
+    low = std::fmin(low, v);
+    high = std::fmax(high, v);
+    const float n = normalized.eval(p);
+    normalizedOk = normalizedOk && n >= 0 && n <= 1;
+  }
+  expect(low >= range.min && high <= range.max,
+         name + " samples within outputRange(3)");
+  expect(normalizedOk, name + " normalized samples within [0, 1]");
+}
+
+} // namespace
+
+int main() {
+  using noise::PerlinGradients;
+  using noise::TableLayout;
+
+  for (const unsigned dimension : {2u, 3u}) {
+    const std::string suffix = " bound in " + std::to_string(dimension) + "D";
+    const double random = worstCaseMax(dimension, false);
+    const double improved = worstCaseMax(dimension, true);
+    // The bounds are the maxima, up to their rounding
+    expect(random <= noise::perlinRange<double>(dimension).max + 1e-9 &&
+               random > noise::perlinRange<double>(dimension).max - 1e-6,
+           "perlinRange" + suffix);
+    expect(improved <= noise::improvedPerlinRange<double>(dimension).max &&
+               improved > noise::improvedPerlinRange<double>(dimension).max -
+                              1e-4,
+           "improvedPerlinRange" + suffix);
+  }
+
+  // The worst case found in 3D, which the tables get close to
+  const double corner[3] = {0.355, 0.482, 0.5};
+  expect(worstCase(corner, true) > 1.036 &&
+             worstCase(corner, true) <=
+                 noise::improvedPerlinRange<double>(3).max,
+         "improvedPerlinRange covers the corner configuration at (0.355, "
+         "0.482, 0.5)");
+
+  using ImprovedPerlin =
+      noise::PerlinNoise3D<256, std::default_random_engine, float,
+                           TableLayout::Wide, PerlinGradients::Improved>;
+  using HashedImprovedPerlin =
+      noise::PerlinNoise3D<256, std::default_random_engine, float,
+                           TableLayout::Hashed, PerlinGradients::Improved>;
+  checkSamples("PerlinNoise", noise::PerlinNoise());
+  checkSamples("PerlinNoise/improved", ImprovedPerlin());
+  checkSamples("PerlinNoise/improved/hashed", HashedImprovedPerlin());
+
+  // A sample of the default tables past 1
+  const ImprovedPerlin improvedPerlin;
+  const vector::Vec3f past(241.481f, 3.42f, 12.535f);
+  expect(noise::NormalizedNoise<ImprovedPerlin>(improvedPerlin).eval(past) >=
+             0,
+         "PerlinNoise/improved normalized at (241.481, 3.42, 12.535)");
+
+  // The sums inherit the bound of their layers
+  const noise::FractalNoise<ImprovedPerlin, 1> single(improvedPerlin);
+  expect(single.outputRange(3).max >=
+             noise::improvedPerlinRange<float>(3).max,
+         "FractalNoise outputRange of an improved Perlin layer");
+
+  if (failures != 0) {
+    std::cerr << failures << " bound(s) do not hold" << std::endl;
+    return 1;
+  }
+  std::cout << "Noise ranges hold" << std::endl;
+  return 0;
+}
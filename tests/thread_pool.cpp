@@ -0,0 +1,76 @@
+// CH_NOISE_THREAD_POOL: parallelFor runs every index once, and a task that
+// throws, on a worker or on the calling thread, reaches the caller of
+// parallelFor and leaves the pool usable. Returns 1 and prints the checks
+// that fail
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "utils/thread_pool.hpp"
+
+namespace {
+
+int failures = 0;
+
+void expect(const bool ok, const std::string &what) {
+  if (!ok) {
+    std::cerr << "FAIL " << what << std::endl;
+    ++failures;
+  }
+}
+
+// Each index of [0, count) is run exactly once
+void checkCoverage(utils::ThreadPool &pool, const std::size_t count,
+                   const std::string &name) {
+  std::vector<std::atomic<int>> runs(count);
+  pool.parallelFor(count, [&](const std::size_t i) { ++runs[i]; });
+  bool once = true;
+  for (const std::atomic<int> &r : runs) {
+    once = once && r.load() == 1;
+  }
+  expect(once, name + " runs each of " + std::to_string(count) +
+                   " indices once");
+}
+
+// Every seventh index throws, so both the workers and the caller do
+void checkThrow(utils::ThreadPool &pool, const std::string &name) {
+  for (int round = 0; round < 100; ++round) {
+    bool caught = false;
+    try {
+      pool.parallelFor(1000, [](const std::size_t i) {
+        if (i % 7 == 3) {
+          throw std::runtime_error("task " + std::to_string(i));
+        }
+      });
+    } catch (const std::runtime_error &e) {
+      caught = std::string(e.what()).rfind("task ", 0) == 0;
+    }
+    if (!caught) {
+      expect(false, name + " rethrows the exception of a task");
+      return;
+    }
+  }
+}
+
+} // namespace
+
+int main() {
+  for (const std::size_t workers : {0u, 1u, 3u}) {
+    utils::ThreadPool pool(workers);
+    const std::string name = "ThreadPool(" + std::to_string(workers) + ")";
+    checkCoverage(pool, 1, name);
+    checkCoverage(pool, 1021, name);
+    checkThrow(pool, name);
+    checkCoverage(pool, 1021, name + " after exceptions");
+  }
+
+  if (failures != 0) {
+    std::cerr << failures << " check(s) failed" << std::endl;
+    return 1;
+  }
+  std::cout << "ThreadPool runs and rethrows" << std::endl;
+  return 0;
+}